@@ -0,0 +1,276 @@
+#include "stdafx.h"
+
+#include "../source/Applewin.h"
+#include "../source/CPU.h"
+
+#include "../source/Debugger/Debugger_Types.h"
+#include "../source/Debugger/Debugger_Assembler.h"
+#include "../source/Debugger/Debugger_Trace.h"
+
+// NB. DebugDefs.h must come after Debugger_Types.h which declares these as extern
+#include "../source/Debugger/DebugDefs.h"
+
+// Disassembles a binary trace file (from the debugger's "TF filename.bin" command):
+//   TraceDisasm <trace file> [symbol file...]
+// . output (to stdout) is one line per opcode: cycle, registers, flags, address, opcode bytes & disassembly
+// . symbol files are AppleWin ("0000 NAME") or ACME ("NAME =$0000") format, eg. APPLE2E.SYM
+
+// From CPU.cpp
+regsrec regs;
+
+// From Frame.cpp
+HWND   g_hFrameWindow   = (HWND)0;
+
+// From Memory.cpp
+LPBYTE         mem          = NULL;
+LPBYTE         memdirty     = NULL;
+
+//-------------------------------------
+
+// From Debugger_Console.cpp
+		char      g_aConsolePrompt[] = ">!"; // input, assembler // NUM_PROMPTS
+		char      g_sConsolePrompt[] = ">";
+
+Update_t ConsoleUpdate ()
+{
+	return 0;
+}
+
+bool ConsoleBufferPush ( const char * pText )
+{
+	return false;
+}
+
+bool ConsoleBufferPushVa ( char* buf, size_t bufsz, const char * pFormat, va_list va )
+{
+	return false;
+}
+
+// From Debugger_DisassemblerData.cpp
+DisasmData_t* Disassembly_IsDataAddress ( WORD nAddress )
+{
+	return NULL;
+}
+
+// From Debugger_Parser.cpp
+	int   g_nArgRaw;
+	Arg_t g_aArgRaw[ MAX_ARGS ]; // pre-processing
+	Arg_t g_aArgs  [ MAX_ARGS ]; // post-processing (cooked)
+
+bool ArgsGetValue ( Arg_t *pArg, WORD * pAddressValue_, const int nBase )
+{
+	return false;
+}
+
+// From Debugger_Symbols.cpp
+bool FindAddressFromSymbol ( const char* pSymbol, WORD * pAddress_, int * iTable_ )
+{
+	return false;
+}
+
+//-------------------------------------
+
+typedef std::map<WORD, std::string> SymbolMap_t;
+static SymbolMap_t g_mapSymbols;
+
+// Same formats as ParseSymbolTable(): the 1st symbol for an address wins
+static int LoadSymbols(const char* pszFileName)
+{
+	FILE* hFile = fopen(pszFileName, "rt");
+	if (!hFile)
+		return -1;
+
+	int nSymbols = 0;
+	char sLine[ 256 ];
+	while (fgets(sLine, sizeof(sLine), hFile))
+	{
+		char sName[ 64 ];
+		UINT nAddress = 0;
+
+		if (strchr(sLine, '='))
+		{
+			// ACME: NAME =$0000 ; comment
+			if (sscanf(sLine, "%63[^ \t=] =$%x", sName, &nAddress) != 2)
+				continue;
+		}
+		else
+		{
+			// AppleWin: 0000 NAME
+			if (sscanf(sLine, "%x %63s", &nAddress, sName) != 2)
+				continue;
+		}
+
+		if (sName[0] == ';' || nAddress > _6502_MEM_END)
+			continue;
+
+		if (g_mapSymbols.find((WORD)nAddress) == g_mapSymbols.end())
+		{
+			g_mapSymbols[(WORD)nAddress] = sName;
+			nSymbols++;
+		}
+	}
+
+	fclose(hFile);
+	return nSymbols;
+}
+
+static const char* FindSymbol(const WORD nAddress)
+{
+	SymbolMap_t::const_iterator it = g_mapSymbols.find(nAddress);
+	return (it == g_mapSymbols.end()) ? NULL : it->second.c_str();
+}
+
+//-------------------------------------
+
+// The operand, formatted using g_aOpmodes[].m_sFormat: its %02X/%04X/%s is replaced by a symbol or $value
+static void FormatOperand(char* pszOperand, const size_t nSize, const TraceRecord_t& rec, const int iOpmode)
+{
+	pszOperand[0] = 0;
+
+	const int nOpbytes = g_aOpmodes[iOpmode].m_nBytes;
+	if (iOpmode < AM_M || iOpmode >= NUM_ADDRESSING_MODES || nOpbytes < 2)
+		return;
+
+	WORD nValue = (nOpbytes == 3) ? (rec.aOpcode[1] | (rec.aOpcode[2] << 8)) : rec.aOpcode[1];
+	bool bWord = (nOpbytes == 3);
+
+	if (iOpmode == AM_R)
+	{
+		nValue = rec.nPC + 2 + (signed char)rec.aOpcode[1];
+		bWord = true;
+	}
+
+	char sValue[ 64 ];
+	const char* pszSymbol = (iOpmode == AM_M) ? NULL : FindSymbol(nValue);
+	if (pszSymbol)
+		_snprintf(sValue, sizeof(sValue), "%s", pszSymbol);
+	else
+		_snprintf(sValue, sizeof(sValue), bWord ? "$%04X" : "$%02X", nValue);
+	sValue[ sizeof(sValue)-1 ] = 0;
+
+	// Split the format into prefix, eg. "(", & suffix, eg. ",X)"
+	const char* pszFormat = g_aOpmodes[iOpmode].m_sFormat;
+	const char* pszSpec = strchr(pszFormat, '%');
+	if (!pszSpec)
+		return;
+
+	const char* pszSuffix = pszSpec + 1;
+	while (*pszSuffix && !isalpha((unsigned char)*pszSuffix))
+		pszSuffix++;
+	if (*pszSuffix)
+		pszSuffix++;
+
+	_snprintf(pszOperand, nSize, "%s%.*s%s%s",
+		(iOpmode == AM_M) ? "#" : "",
+		(int)(pszSpec - pszFormat), pszFormat,
+		sValue,
+		pszSuffix);
+	pszOperand[ nSize-1 ] = 0;
+}
+
+static void FormatFlags(char* pszFlags, const BYTE nP)
+{
+	const char* pszNames = "NV-BDIZC";
+	for (int i=0; i<8; i++)
+		pszFlags[i] = (nP & (0x80 >> i)) ? pszNames[i] : '.';
+	pszFlags[8] = 0;
+}
+
+//-------------------------------------
+
+static int Disassemble(FILE* hFile)
+{
+	TraceFileHeader_t header;
+	if (fread(&header, sizeof(header), 1, hFile) != 1
+		|| memcmp(header.sMagic, TRACE_FILE_MAGIC, sizeof(TRACE_FILE_MAGIC)) != 0)
+	{
+		fprintf(stderr, "Not a trace file\n");
+		return 1;
+	}
+
+	if (header.nVersion != TRACE_FILE_VERSION || header.nRecordSize != sizeof(TraceRecord_t))
+	{
+		fprintf(stderr, "Unsupported trace file version: %d\n", header.nVersion);
+		return 1;
+	}
+
+	const Opcodes_t* pOpcodes = (header.nCpuType == CPU_6502) ? g_aOpcodes6502 : g_aOpcodes65C02;
+
+	unsigned __int64 uCycle = header.nStartCycle;
+	unsigned __int64 uNumRecords = 0;
+
+	const UINT kRecordsPerRead = 4096;
+	std::vector<TraceRecord_t> vRecords(kRecordsPerRead);
+
+	size_t nRead;
+	while ((nRead = fread(&vRecords[0], sizeof(TraceRecord_t), kRecordsPerRead, hFile)) > 0)
+	{
+		for (size_t i=0; i<nRead; i++)
+		{
+			const TraceRecord_t& rec = vRecords[i];
+			uCycle += rec.nCycles;
+
+			const Opcodes_t& opcode = pOpcodes[ rec.aOpcode[0] ];
+			const int iOpmode = opcode.nAddressMode;
+			const int nOpbytes = g_aOpmodes[iOpmode].m_nBytes;
+
+			const char* pszLabel = FindSymbol(rec.nPC);
+			if (pszLabel)
+				printf("%s:\n", pszLabel);
+
+			char sBytes[ 16 ];
+			switch (nOpbytes)
+			{
+			case 2:  sprintf(sBytes, "%02X %02X   ", rec.aOpcode[0], rec.aOpcode[1]); break;
+			case 3:  sprintf(sBytes, "%02X %02X %02X", rec.aOpcode[0], rec.aOpcode[1], rec.aOpcode[2]); break;
+			default: sprintf(sBytes, "%02X      ", rec.aOpcode[0]); break;
+			}
+
+			char sFlags[ 9 ];
+			FormatFlags(sFlags, rec.nP);
+
+			char sOperand[ 128 ];
+			FormatOperand(sOperand, sizeof(sOperand), rec, iOpmode);
+
+			printf("%12I64u  A=%02X X=%02X Y=%02X S=%02X P=%s  %04X: %s  %s %s\n",
+				uCycle,
+				rec.nA, rec.nX, rec.nY, rec.nS, sFlags,
+				rec.nPC, sBytes,
+				opcode.sMnemonic, sOperand);
+		}
+
+		uNumRecords += nRead;
+	}
+
+	fprintf(stderr, "%I64u instructions, %I64u cycles\n", uNumRecords, uCycle - header.nStartCycle);
+	return 0;
+}
+
+//-------------------------------------
+
+int _tmain(int argc, _TCHAR* argv[])
+{
+	if (argc < 2)
+	{
+		fprintf(stderr, "Usage: TraceDisasm <trace file> [symbol file...]\n");
+		return 1;
+	}
+
+	for (int i=2; i<argc; i++)
+	{
+		if (LoadSymbols(argv[i]) < 0)
+			fprintf(stderr, "Couldn't open symbol file: %s\n", argv[i]);
+	}
+
+	FILE* hFile = fopen(argv[1], "rb");
+	if (!hFile)
+	{
+		fprintf(stderr, "Couldn't open trace file: %s\n", argv[1]);
+		return 1;
+	}
+
+	const int res = Disassemble(hFile);
+
+	fclose(hFile);
+	return res;
+}
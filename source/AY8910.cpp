@@ -90,6 +90,8 @@ static int sound_channels;
 
 static unsigned int ay_tone_levels[16];
 
+static bool g_bAYSpanGenerator = true;	// [AppleWin] else use the original sample-by-sample generator
+
 //static libspectrum_signed_word *sound_buf, *tape_buf;
 //static float *convert_input_buffer, *convert_output_buffer;
 
@@ -472,18 +474,53 @@ sound_write_buf_pstereo( libspectrum_signed_word * out, int c )
 
 #define HZ_COMMON_DENOMINATOR 50
 
+/* fix things as needed for some register changes */
+void CAY8910::sound_ay_change( int reg )
+{
+  int r;
+
+  switch ( reg ) {
+  case 0:
+  case 1:
+  case 2:
+  case 3:
+  case 4:
+  case 5:
+	r = reg >> 1;
+	/* a zero-len period is the same as 1 */
+	ay_tone_period[r] = ( sound_ay_registers[ reg & ~1 ] |
+			      ( sound_ay_registers[ reg | 1 ] & 15 ) << 8 );
+	if( !ay_tone_period[r] )
+	  ay_tone_period[r]++;
+
+	/* important to get this right, otherwise e.g. Ghouls 'n' Ghosts
+	 * has really scratchy, horrible-sounding vibrato.
+	 */
+	if( ay_tone_tick[r] >= ay_tone_period[r] * 2 )
+	  ay_tone_tick[r] %= ay_tone_period[r] * 2;
+	break;
+  case 6:
+	ay_noise_tick = 0;
+	ay_noise_period = ( sound_ay_registers[ reg ] & 31 );
+	break;
+  case 11:
+  case 12:
+	/* this one *isn't* fixed-point */
+	ay_env_period =
+	  sound_ay_registers[11] | ( sound_ay_registers[12] << 8 );
+	break;
+  case 13:
+	ay_env_internal_tick = ay_env_tick = ay_env_subcycles = 0;
+	env_first = 1;
+	env_rev = 0;
+	env_counter = ( sound_ay_registers[13] & AY_ENV_ATTACK ) ? 0 : 15;
+	break;
+  }
+}
+
 void CAY8910::sound_ay_overlay( void )
 {
-  int tone_level[3];
-  int mixer, envshape;
-  int f, g, level, count;
-//  libspectrum_signed_word *ptr;
-  struct ay_change_tag *change_ptr = ay_change;
-  int changes_left = ay_change_count;
-  int reg, r;
-  int is_low;
-  int chan1, chan2, chan3;
-  unsigned int tone_count, noise_count;
+  int f;
   libspectrum_dword sfreq, cpufreq;
 
 ///* If no AY chip, don't produce any AY sound (!) */
@@ -498,6 +535,27 @@ void CAY8910::sound_ay_overlay( void )
   for( f = 0; f < ay_change_count; f++ )
     ay_change[f].ofs = (USHORT) (( ay_change[f].tstates * sfreq ) / cpufreq);	// [TC] Added cast
 
+  if( g_bAYSpanGenerator )
+    sound_ay_overlay_spans();
+  else
+    sound_ay_overlay_samples();
+}
+
+// [AppleWin] The original FUSE generator: one sample at a time, for all 3 channels.
+// Kept as the reference for sound_ay_overlay_spans() (see AY8910_SetSpanGenerator() & TestAY8910)
+void CAY8910::sound_ay_overlay_samples( void )
+{
+  int tone_level[3];
+  int mixer, envshape;
+  int f, g, level, count;
+//  libspectrum_signed_word *ptr;
+  struct ay_change_tag *change_ptr = ay_change;
+  int changes_left = ay_change_count;
+  int reg;
+  int is_low;
+  int chan1, chan2, chan3;
+  unsigned int tone_count, noise_count;
+
   libspectrum_signed_word* pBuf1 = g_ppSoundBuffers[0];
   libspectrum_signed_word* pBuf2 = g_ppSoundBuffers[1];
   libspectrum_signed_word* pBuf3 = g_ppSoundBuffers[2];
@@ -515,43 +573,7 @@ void CAY8910::sound_ay_overlay( void )
       changes_left--;
 
       /* fix things as needed for some register changes */
-      switch ( reg ) {
-      case 0:
-      case 1:
-      case 2:
-      case 3:
-      case 4:
-      case 5:
-	r = reg >> 1;
-	/* a zero-len period is the same as 1 */
-	ay_tone_period[r] = ( sound_ay_registers[ reg & ~1 ] |
-			      ( sound_ay_registers[ reg | 1 ] & 15 ) << 8 );
-	if( !ay_tone_period[r] )
-	  ay_tone_period[r]++;
-
-	/* important to get this right, otherwise e.g. Ghouls 'n' Ghosts
-	 * has really scratchy, horrible-sounding vibrato.
-	 */
-	if( ay_tone_tick[r] >= ay_tone_period[r] * 2 )
-	  ay_tone_tick[r] %= ay_tone_period[r] * 2;
-	break;
-      case 6:
-	ay_noise_tick = 0;
-	ay_noise_period = ( sound_ay_registers[ reg ] & 31 );
-	break;
-      case 11:
-      case 12:
-	/* this one *isn't* fixed-point */
-	ay_env_period =
-	  sound_ay_registers[11] | ( sound_ay_registers[12] << 8 );
-	break;
-      case 13:
-	ay_env_internal_tick = ay_env_tick = ay_env_subcycles = 0;
-	env_first = 1;
-	env_rev = 0;
-	env_counter = ( sound_ay_registers[13] & AY_ENV_ATTACK ) ? 0 : 15;
-	break;
-      }
+      sound_ay_change( reg );
     }
 
     /* the tone level if no enveloping is being used */
@@ -712,6 +734,246 @@ void CAY8910::sound_ay_overlay( void )
   }
 }
 
+// [AppleWin] Span generator: same waveform as sound_ay_overlay_samples(), but restructured for host speed.
+// . the frame is split into spans at the ay_change offsets, so the registers are constant within a span
+// . per span, a shared control pass steps the envelope and the noise LFSR once (not once per channel),
+//   producing per-sample arrays of envelope level, noise state and tone counts
+// . then each channel is filled by its own tight kernel (and a silent or tone-disabled channel needs no per-sample tone work)
+
+#define AY_SPAN_MAX 128
+
+// Parity of a byte (for advancing the noise LFSR 8 steps at a time)
+static BYTE g_aParity8[256];
+static bool g_bParity8Init = false;
+
+static void InitParity8(void)
+{
+	for (UINT i=0; i<256; i++)
+	{
+		UINT p = 0;
+		for (UINT b=i; b; b>>=1)
+			p ^= b & 1;
+		g_aParity8[i] = (BYTE) p;
+	}
+	g_bParity8Init = true;
+}
+
+// Advance the 17-bit noise LFSR by 'steps' in batches of up to 8:
+// . step k toggles the noise output if bit0^bit1, and shifts in bit0^bit2 at bit16
+// . so for k<=8 steps: the toggles are (rng ^ rng>>1) bits 0..k-1, and the new bits are (rng ^ rng>>2) bits 0..k-1
+void CAY8910::sound_ay_noise_advance( unsigned int steps )
+{
+	while (steps)
+	{
+		const unsigned int k = steps < 8 ? steps : 8;
+		const unsigned int mask = (1 << k) - 1;
+
+		if (g_aParity8[ (rng ^ (rng >> 1)) & mask ])
+			noise_toggle = !noise_toggle;
+
+		rng = (rng >> k) | (((rng ^ (rng >> 2)) & mask) << (17 - k));
+		steps -= k;
+	}
+}
+
+void CAY8910::sound_ay_overlay_spans( void )
+{
+	if (!g_bParity8Init)
+		InitParity8();
+
+	struct ay_change_tag *change_ptr = ay_change;
+	int changes_left = ay_change_count;
+
+	libspectrum_signed_word* pBuf[3] = { g_ppSoundBuffers[0], g_ppSoundBuffers[1], g_ppSoundBuffers[2] };
+
+	int f = 0;
+	while (f < sound_generator_framesiz)
+	{
+		while (changes_left && f >= change_ptr->ofs)
+		{
+			sound_ay_registers[ change_ptr->reg ] = change_ptr->val;
+			sound_ay_change( change_ptr->reg );
+			change_ptr++;
+			changes_left--;
+		}
+
+		int end = sound_generator_framesiz;
+		if (changes_left && change_ptr->ofs < end)
+			end = change_ptr->ofs;
+		if (end - f > AY_SPAN_MAX)
+			end = f + AY_SPAN_MAX;
+
+		sound_ay_span(pBuf, f, end - f);
+		f = end;
+	}
+}
+
+void CAY8910::sound_ay_span( libspectrum_signed_word* pBuf[3], const int nOffset, const int nNumSamples )
+{
+	int envLevel[AY_SPAN_MAX];
+	int noiseMask[AY_SPAN_MAX];				// -1 if noise output is high (ie. mutes the channel), else 0
+	unsigned int toneCount[AY_SPAN_MAX];
+
+	const int envshape = sound_ay_registers[13];
+
+	// Control pass: envelope, noise & tone clocks (shared by all 3 channels)
+
+	for (int i=0; i<nNumSamples; i++)
+	{
+		envLevel[i] = ay_tone_levels[ env_counter ];
+		noiseMask[i] = noise_toggle ? -1 : 0;
+
+		/* envelope output counter gets incr'd every 16 AY cycles */
+		ay_env_subcycles += ay_tick_incr;
+		unsigned int noise_count = 0;
+		while (ay_env_subcycles >= (16 << 16))
+		{
+			ay_env_subcycles -= (16 << 16);
+			noise_count++;
+			ay_env_tick++;
+			while (ay_env_tick >= ay_env_period)
+			{
+				ay_env_tick -= ay_env_period;
+
+				if (env_first || ((envshape & AY_ENV_CONT) && !(envshape & AY_ENV_HOLD)))
+				{
+					if (env_rev)
+						env_counter -= (envshape & AY_ENV_ATTACK) ? 1 : -1;
+					else
+						env_counter += (envshape & AY_ENV_ATTACK) ? 1 : -1;
+					if (env_counter < 0)
+						env_counter = 0;
+					if (env_counter > 15)
+						env_counter = 15;
+				}
+
+				ay_env_internal_tick++;
+				while (ay_env_internal_tick >= 16)
+				{
+					ay_env_internal_tick -= 16;
+
+					/* end of cycle */
+					if (!(envshape & AY_ENV_CONT))
+						env_counter = 0;
+					else if (envshape & AY_ENV_HOLD)
+					{
+						if (env_first && (envshape & AY_ENV_ALT))
+							env_counter = (env_counter ? 0 : 15);
+					}
+					else if (envshape & AY_ENV_ALT)
+						env_rev = !env_rev;
+					else
+						env_counter = (envshape & AY_ENV_ATTACK) ? 0 : 15;
+
+					env_first = 0;
+				}
+
+				/* don't keep trying if period is zero */
+				if (!ay_env_period)
+					break;
+			}
+		}
+
+		ay_tone_subcycles += ay_tick_incr;
+		toneCount[i] = ay_tone_subcycles >> (3 + 16);
+		ay_tone_subcycles &= (8 << 16) - 1;
+
+		/* update noise RNG: a zero period still steps once per sample */
+		ay_noise_tick += noise_count;
+		unsigned int steps = 1;
+		if (ay_noise_period)
+		{
+			steps = ay_noise_tick / ay_noise_period;
+			ay_noise_tick -= steps * ay_noise_period;
+		}
+		sound_ay_noise_advance(steps);
+	}
+
+	// Channel pass
+
+	const int mixer = sound_ay_registers[7];
+
+	for (int chan=0; chan<3; chan++)
+	{
+		libspectrum_signed_word* pOut = pBuf[chan] + nOffset;
+		const bool bEnvelope = (sound_ay_registers[8 + chan] & 16) != 0;
+		const int constLevel = ay_tone_levels[ sound_ay_registers[8 + chan] & 15 ];
+		const bool bTone = (mixer & (1 << chan)) == 0;
+		const int noiseEnable = (mixer & (8 << chan)) == 0 ? -1 : 0;
+
+		if (!bTone)
+		{
+			// (if no tone/noise is selected, the chip just shoves the level out unmodified)
+			if (bEnvelope)
+			{
+				for (int i=0; i<nNumSamples; i++)
+					pOut[i] = (libspectrum_signed_word) (envLevel[i] & ~(noiseMask[i] & noiseEnable));
+			}
+			else
+			{
+				for (int i=0; i<nNumSamples; i++)
+					pOut[i] = (libspectrum_signed_word) (constLevel & ~(noiseMask[i] & noiseEnable));
+			}
+			continue;
+		}
+
+		unsigned int tick = ay_tone_tick[chan];
+		unsigned int high = ay_tone_high[chan];
+		const unsigned int period = ay_tone_period[chan];
+
+		if (!bEnvelope && constLevel == 0)
+		{
+			// Silent: just advance the tone counter (each period elapsed is a flip of the output)
+			for (int i=0; i<nNumSamples; i++)
+			{
+				tick += toneCount[i];
+				pOut[i] = 0;
+			}
+			const unsigned int flips = tick / period;
+			tick -= flips * period;
+			high ^= flips & 1;
+		}
+		else
+		{
+			for (int i=0; i<nNumSamples; i++)
+			{
+				const int level = bEnvelope ? envLevel[i] : constLevel;
+				const unsigned int tone_count = toneCount[i];
+				int var = high ? level : -level;
+
+				tick += tone_count;
+				if (tick >= period)
+				{
+					tick -= period;
+					if (tick < period)
+					{
+						// Flipped once: anti-alias with the fraction of the sample before the flip
+						if (level && tick < tone_count)
+						{
+							const int subval = level * 2 * tick / tone_count;
+							var += high ? -subval : subval;
+						}
+						high = !high;
+					}
+					else
+					{
+						// Flipped more than once during the sample: can't represent it faithfully
+						const unsigned int flips = 1 + tick / period;
+						tick -= (flips - 1) * period;
+						high ^= flips & 1;
+						var = -level;
+					}
+				}
+
+				pOut[i] = (libspectrum_signed_word) (var & ~(noiseMask[i] & noiseEnable));
+			}
+		}
+
+		ay_tone_tick[chan] = tick;
+		ay_tone_high[chan] = high;
+	}
+}
+
 // AppleWin:TC  Holding down ScrollLock will result in lots of AY changes /ay_change_count/
 //              - since sound_ay_overlay() is called to consume them.
 
@@ -1193,6 +1455,14 @@ void AY8910_InitClock(int nClock)
 	}
 }
 
+// Returns the previous setting
+bool AY8910_SetSpanGenerator(bool bEnable)
+{
+	const bool bPrev = g_bAYSpanGenerator;
+	g_bAYSpanGenerator = bEnable;
+	return bPrev;
+}
+
 BYTE* AY8910_GetRegsPtr(UINT uChip)
 {
 	if (uChip >= MAX_8910)
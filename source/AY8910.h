@@ -14,6 +14,7 @@ void AY8910Update(int chip, INT16** buffer, int nNumSamples);
 void AY8910_InitAll(int nClock, int nSampleRate);
 void AY8910_InitClock(int nClock);
 BYTE* AY8910_GetRegsPtr(UINT uChip);
+bool AY8910_SetSpanGenerator(bool bEnable);
 
 void AY8910UpdateSetCycles();
 
@@ -53,6 +54,11 @@ private:
 	void init( void );
 	void sound_end( void );
 	void sound_ay_overlay( void );
+	void sound_ay_overlay_samples( void );
+	void sound_ay_overlay_spans( void );
+	void sound_ay_span( libspectrum_signed_word* pBuf[3], const int nOffset, const int nNumSamples );
+	void sound_ay_change( int reg );
+	void sound_ay_noise_advance( unsigned int steps );
 
 private:
 	/* foo_subcycles are fixed-point with low 16 bits as fractional part.
@@ -33,8 +33,10 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 #include "Debug.h"
 #include "Disk.h"
 #include "DiskImage.h"
+#include "DiskImageIndex.h"
 #include "Frame.h"
 #include "Harddisk.h"
+#include "HostServices.h"
 #include "Joystick.h"
 #include "Log.h"
 #include "Memory.h"
@@ -135,7 +137,7 @@ void LogFileTimeUntilFirstKeyRead(void)
 	if (!g_fh || bLogKeyReadDone)
 		return;
 
-	if (mem[regs.pc-3] != 0x2C)	// bit $c000
+	if (ReadByteFromMemory(regs.pc-3) != 0x2C)	// bit $c000
 		return;
 
 	DWORD dwTime = GetTickCount() - dwLogKeyReadTickStart;
@@ -244,14 +246,15 @@ static void ContinueExecution(void)
 	{
 		if (g_nAppMode == MODE_RUNNING)
 		{
-			bScrollLock_FullSpeed = GetKeyState(VK_SCROLL) < 0;
+			bScrollLock_FullSpeed = g_pHostKeyInput->IsFullSpeedKeyDown();
 		}
 		else if (!IsDebugSteppingAtFullSpeed()) // Implicitly: MODE_STEPPING
 		{
 			// NB. For MODE_STEPPING: GetKeyState() is slow, so only call periodically
 			// . 0x3FFF is roughly the number of cycles in a video frame, which seems a reasonable rate to call GetKeyState()
-			if ((g_uModeStepping_Cycles & 0x3FFF) == 0)
-				g_uModeStepping_LastGetKey_ScrollLock = GetKeyState(VK_SCROLL) < 0;
+			// . but when running to a breakpoint, each call executes a whole execution period
+			if (IsDebugRunningToBreakpoint() || (g_uModeStepping_Cycles & 0x3FFF) == 0)
+				g_uModeStepping_LastGetKey_ScrollLock = g_pHostKeyInput->IsFullSpeedKeyDown();
 
 			bScrollLock_FullSpeed = g_uModeStepping_LastGetKey_ScrollLock;
 		}
@@ -266,11 +269,11 @@ static void ContinueExecution(void)
 	if (g_bFullSpeed)
 	{
 		if (!bWasFullSpeed)
-			VideoRedrawScreenDuringFullSpeed(0, true);	// Init for full-speed mode
+			g_pHostFrameSink->BeginFullSpeed();
 
 		// Don't call Spkr_Mute() - will get speaker clicks
 		MB_Mute();
-		SysClk_StopTimer();
+		g_pHostTimer->Stop();
 #ifdef USE_SPEECH_API
 		g_Speech.Reset();			// TODO: Put this on a timer (in emulated cycles)... otherwise CATALOG cuts out
 #endif
@@ -284,11 +287,11 @@ static void ContinueExecution(void)
 	else
 	{
 		if (bWasFullSpeed)
-			VideoRedrawScreenAfterFullSpeed(g_dwCyclesThisFrame);
+			g_pHostFrameSink->EndFullSpeed(g_dwCyclesThisFrame);
 
 		// Don't call Spkr_Demute()
 		MB_Demute();
-		SysClk_StartTimerUsec(nExecutionPeriodUsec);
+		g_pHostTimer->Start(nExecutionPeriodUsec);
 
 		// Switch to higher priority, eg. for audio (BUG #015394)
 		SetPriorityAboveNormal();
@@ -300,7 +303,7 @@ static void ContinueExecution(void)
 	const UINT uCyclesToExecuteWithFeedback = (nCyclesWithFeedback >= 0) ? nCyclesWithFeedback
 																		 : 0;
 
-	const DWORD uCyclesToExecute = (g_nAppMode == MODE_RUNNING)		? uCyclesToExecuteWithFeedback
+	const DWORD uCyclesToExecute = (g_nAppMode == MODE_RUNNING || IsDebugRunningToBreakpoint())	? uCyclesToExecuteWithFeedback
 												/* MODE_STEPPING */ : 0;
 
 	const bool bVideoUpdate = !g_bFullSpeed;
@@ -339,17 +342,14 @@ static void ContinueExecution(void)
 	{
 		g_dwCyclesThisFrame -= dwClksPerFrame;
 
-		if (g_bFullSpeed)
-			VideoRedrawScreenDuringFullSpeed(g_dwCyclesThisFrame);
-		else
-			VideoRefreshScreen(); // Just copy the output of our Apple framebuffer to the system Back Buffer
+		g_pHostFrameSink->EndOfFrame(g_dwCyclesThisFrame, g_bFullSpeed);
 
 		MB_EndOfVideoFrame();
 	}
 
 	if ((g_nAppMode == MODE_RUNNING && !g_bFullSpeed) || bModeStepping_WaitTimer)
 	{
-		SysClk_WaitTimer();
+		g_pHostTimer->Wait();
 	}
 }
 
@@ -1147,10 +1147,12 @@ int APIENTRY WinMain(HINSTANCE passinstance, HINSTANCE, LPSTR lpCmdLine, int)
 	bool bBoot = false;
 	bool bChangedDisplayResolution = false;
 	bool bSlot7Empty = false;
+	bool bNullSinks = false;
 	UINT bestWidth = 0, bestHeight = 0;
 	LPSTR szImageName_drive[NUM_DRIVES] = {NULL,NULL};
 	LPSTR szImageName_harddisk[NUM_HARDDISKS] = {NULL,NULL};
 	LPSTR szSnapshotName = NULL;
+	LPSTR szIndexDirectory = NULL;
 	const std::string strCmdLine(lpCmdLine);		// Keep a copy for log ouput
 
 	while (*lpCmdLine)
@@ -1202,6 +1204,12 @@ int APIENTRY WinMain(HINSTANCE passinstance, HINSTANCE, LPSTR lpCmdLine, int)
 			lpNextArg = GetNextArg(lpNextArg);
 			szSnapshotName = lpCmdLine;
 		}
+		else if (strcmp(lpCmdLine, "-index") == 0)	// Detect all disk images under a directory & add them to the image index
+		{
+			lpCmdLine = GetCurrArg(lpNextArg);
+			lpNextArg = GetNextArg(lpNextArg);
+			szIndexDirectory = lpCmdLine;
+		}
 		else if (strcmp(lpCmdLine, "-f") == 0)
 		{
 			bSetFullScreen = true;
@@ -1357,6 +1365,10 @@ int APIENTRY WinMain(HINSTANCE passinstance, HINSTANCE, LPSTR lpCmdLine, int)
 		{
 			SetAltEnterToggleFullScreen(false);
 		}
+		else if (strcmp(lpCmdLine, "-null-sinks") == 0)	// Run unthrottled, discarding the audio & video output (eg. for benchmarks & automated runs)
+		{
+			bNullSinks = true;
+		}
 		else	// unsupported
 		{
 			LogFileOutput("Unsupported arg: %s\n", lpCmdLine);
@@ -1422,6 +1434,11 @@ int APIENTRY WinMain(HINSTANCE passinstance, HINSTANCE, LPSTR lpCmdLine, int)
 
 	const bool bSysClkOK = SysClk_InitTimer();
 	LogFileOutput("Init: SysClk_InitTimer(), res=%d\n", bSysClkOK ? 1:0);
+
+	// The emulation loop's host services default to the null ones (see HostServices.h)
+	if (!bNullSinks)
+		HostServices_SetWin32();
+	LogFileOutput("Init: HostServices: %s\n", bNullSinks ? "null" : "Win32");
 #ifdef USE_SPEECH_API
 	if (g_bEnableSpeech)
 	{
@@ -1450,6 +1467,12 @@ int APIENTRY WinMain(HINSTANCE passinstance, HINSTANCE, LPSTR lpCmdLine, int)
 	ImageInitialize();
 	LogFileOutput("Init: ImageInitialize()\n");
 
+	if (szIndexDirectory)
+	{
+		bool bRes = ImageIndexStartScan(szIndexDirectory);	// Background scan: doesn't delay startup
+		LogFileOutput("Init: ImageIndexStartScan(), res=%d\n", bRes ? 1 : 0);
+	}
+
 	DiskInitialize();
 	LogFileOutput("Init: DiskInitialize()\n");
 
@@ -0,0 +1,101 @@
+/*
+AppleWin : An Apple //e emulator for Windows
+
+Copyright (C) 1994-1996, Michael O'Brien
+Copyright (C) 1999-2001, Oliver Schmidt
+Copyright (C) 2002-2005, Tom Charlesworth
+Copyright (C) 2006-2019, Tom Charlesworth, Michael Pohoreski, Nick Westgate
+
+AppleWin is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+AppleWin is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with AppleWin; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+*/
+
+/* Description: Lock-free single-producer/single-consumer ring of audio samples
+ */
+
+#include "StdAfx.h"
+
+#include "AudioRing.h"
+
+void AudioRing::Create(const UINT uMinCapacity)
+{
+	Destroy();
+
+	UINT uCapacity = 1;
+	while (uCapacity < uMinCapacity)
+		uCapacity <<= 1;
+
+	m_pBuffer = new short [uCapacity];
+	m_uMask = uCapacity - 1;
+	m_nWrite = m_nRead = 0;
+}
+
+void AudioRing::Destroy(void)
+{
+	delete [] m_pBuffer;
+	m_pBuffer = NULL;
+	m_uMask = 0;
+	m_nWrite = m_nRead = 0;
+}
+
+// Returns the number of samples pushed (fewer than uNumSamples if the ring is full)
+UINT AudioRing::Push(const short* pSamples, const UINT uNumSamples)
+{
+	if (!m_pBuffer)
+		return 0;
+
+	const LONG nWrite = m_nWrite;
+	const UINT uFree = (m_uMask + 1) - (UINT)(nWrite - m_nRead);
+	const UINT uNum = uNumSamples < uFree ? uNumSamples : uFree;
+
+	const UINT uIdx = (UINT)nWrite & m_uMask;
+	const UINT uNum0 = (uNum < (m_uMask + 1) - uIdx) ? uNum : (m_uMask + 1) - uIdx;
+	memcpy(&m_pBuffer[uIdx], pSamples, uNum0 * sizeof(short));
+	memcpy(&m_pBuffer[0], &pSamples[uNum0], (uNum - uNum0) * sizeof(short));
+
+	MemoryBarrier();	// Samples must be visible before the new write index
+	m_nWrite = nWrite + (LONG)uNum;
+
+	return uNum;
+}
+
+// Returns the number of samples popped (fewer than uNumSamples if the ring runs dry)
+UINT AudioRing::Pop(short* pSamples, const UINT uNumSamples)
+{
+	if (!m_pBuffer)
+		return 0;
+
+	const LONG nRead = m_nRead;
+	const UINT uAvail = (UINT)(m_nWrite - nRead);
+	const UINT uNum = uNumSamples < uAvail ? uNumSamples : uAvail;
+
+	MemoryBarrier();	// Don't read samples ahead of the write index that covers them
+
+	const UINT uIdx = (UINT)nRead & m_uMask;
+	const UINT uNum0 = (uNum < (m_uMask + 1) - uIdx) ? uNum : (m_uMask + 1) - uIdx;
+	memcpy(pSamples, &m_pBuffer[uIdx], uNum0 * sizeof(short));
+	memcpy(&pSamples[uNum0], &m_pBuffer[0], (uNum - uNum0) * sizeof(short));
+
+	MemoryBarrier();	// Finish reading before the producer can overwrite these samples
+	m_nRead = nRead + (LONG)uNum;
+
+	return uNum;
+}
+
+// Drop samples up to a write index the producer published earlier (see GetWriteIndex())
+void AudioRing::DiscardTo(const LONG nWriteIndex)
+{
+	if ((LONG)(nWriteIndex - m_nRead) > 0)
+		m_nRead = nWriteIndex;
+}
@@ -0,0 +1,38 @@
+#pragma once
+
+// Single-producer/single-consumer ring of audio samples
+// . the producer (emulation thread) only writes m_nWrite, the consumer (audio thread) only writes m_nRead
+// . both indices are free-running, so (m_nWrite - m_nRead) is the fill level, and the capacity is a power of 2
+
+class AudioRing
+{
+public:
+	AudioRing(void)
+		: m_pBuffer(NULL)
+		, m_uMask(0)
+		, m_nWrite(0)
+		, m_nRead(0)
+	{}
+	~AudioRing(void) { Destroy(); }
+
+	void Create(const UINT uMinCapacity);	// NB. Neither thread may be using the ring
+	void Destroy(void);
+
+	// Producer only
+	UINT Push(const short* pSamples, const UINT uNumSamples);
+	LONG GetWriteIndex(void) const { return m_nWrite; }
+
+	// Consumer only
+	UINT Pop(short* pSamples, const UINT uNumSamples);
+	void DiscardTo(const LONG nWriteIndex);
+
+	// Either thread
+	UINT GetNumSamples(void) const { return (UINT)(m_nWrite - m_nRead); }
+	UINT GetCapacity(void) const { return m_pBuffer ? m_uMask + 1 : 0; }
+
+private:
+	short* m_pBuffer;
+	UINT m_uMask;
+	volatile LONG m_nWrite;
+	volatile LONG m_nRead;
+};
@@ -0,0 +1,410 @@
+/*
+AppleWin : An Apple //e emulator for Windows
+
+Copyright (C) 1994-1996, Michael O'Brien
+Copyright (C) 1999-2001, Oliver Schmidt
+Copyright (C) 2002-2005, Tom Charlesworth
+Copyright (C) 2006-2019, Tom Charlesworth, Michael Pohoreski, Nick Westgate
+
+AppleWin is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+AppleWin is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with AppleWin; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+*/
+
+/* Description: Audio thread - writes the queued speaker & Mockingboard samples to DirectSound
+ *
+ * Previously SpkrUpdate() & MB_Update() locked the DirectSound buffers themselves, so a slow sound driver stalled the emulation.
+ * Now each sink has a lock-free ring (AudioRing): the emulation thread pushes into it, and this thread drains it every few ms.
+ *
+ * Rate control (keep the DirectSound buffer between 1/4 and 1/2 full) is still applied by the emulation thread, since only it
+ * can generate more or fewer samples; but it's based on the fill level this thread publishes, so it doesn't touch the device.
+ */
+
+#include "StdAfx.h"
+
+#include "AudioRing.h"
+#include "AudioThread.h"
+#include "Riff.h"
+#include "SoundCore.h"
+
+static const DWORD kServicePeriodMs = 5;
+
+struct AudioSink
+{
+	AudioRing ring;
+	bool bRegistered;
+	VOICE* pVoice;				// NULL for a null sink
+	char* pszName;
+	DWORD dwBufferSize;			// bytes (a null sink has a notional buffer of this size)
+	UINT uSampleRate;
+	UINT uNumChannels;
+
+	// Audio thread only
+	DWORD dwByteOffset;			// DirectSound write offset, or (DWORD)-1 to re-sync to the play cursor
+	short nLastFrame[2];		// Replayed to pad an underrun
+	DWORD dwLastTick;			// Null sink: time of last service
+	double fFrameCarry;			// Null sink: fractional frames not yet consumed
+
+	// Written by the audio thread
+	volatile LONG nDeviceBytes;	// Bytes queued in the device, ahead of the play cursor
+
+	// Written by the emulation thread
+	volatile LONG bFlush;
+	volatile LONG nFlushTo;		// Discard samples up to this ring write index
+	int nNumSamplesError;		// Rate feedback
+};
+
+static AudioSink g_aSink[NUM_AUDIO_SINKS];
+static char* g_szSinkName[NUM_AUDIO_SINKS] = {"Spkr", "MB"};
+
+static CRITICAL_SECTION g_AudioCS;		// Guards sink (un)registration against the audio thread
+static bool g_bAudioCSValid = false;
+static HANDLE g_hAudioThread = NULL;
+static HANDLE g_hAudioStopEvent = NULL;
+
+//=============================================================================
+
+#if defined(RIFF_SPKR) || defined(RIFF_MB)
+static void RecordSamples(AudioSink& sink, short* pSamples, const UINT uNumFrames)
+{
+#ifdef RIFF_SPKR
+	const AudioSink_e eRecordSink = AUDIO_SINK_SPEAKER;
+#else
+	const AudioSink_e eRecordSink = AUDIO_SINK_MOCKINGBOARD;
+#endif
+	if (&sink == &g_aSink[eRecordSink])
+		RiffPutSamples(pSamples, uNumFrames);
+}
+#else
+static inline void RecordSamples(AudioSink& sink, short* pSamples, const UINT uNumFrames) {}
+#endif
+
+// Fill part of a locked DirectSound buffer: queued frames first, then (if the ring runs dry) pad by repeating the last frame
+static void FillFrames(AudioSink& sink, short* pDst, const UINT uNumFrames, UINT& uFramesToPop)
+{
+	const UINT uNumChannels = sink.uNumChannels;
+	UINT uNumPopped = uFramesToPop < uNumFrames ? uFramesToPop : uNumFrames;
+	uNumPopped = sink.ring.Pop(pDst, uNumPopped * uNumChannels) / uNumChannels;
+	uFramesToPop -= uNumPopped;
+
+	if (uNumPopped)
+	{
+		for (UINT c=0; c<uNumChannels; c++)
+			sink.nLastFrame[c] = pDst[(uNumPopped-1)*uNumChannels + c];
+	}
+
+	for (UINT i=uNumPopped; i<uNumFrames; i++)
+		for (UINT c=0; c<uNumChannels; c++)
+			pDst[i*uNumChannels + c] = sink.nLastFrame[c];
+
+	RecordSamples(sink, pDst, uNumFrames);
+}
+
+static void ServiceDevice(AudioSink& sink)
+{
+	VOICE* pVoice = sink.pVoice;
+	const DWORD dwBufferSize = sink.dwBufferSize;
+	const UINT uBytesPerFrame = sizeof(short) * sink.uNumChannels;
+
+	if (!pVoice->bActive)
+	{
+		sink.ring.DiscardTo(sink.ring.GetWriteIndex());
+		return;
+	}
+
+	DWORD dwCurrentPlayCursor, dwCurrentWriteCursor;
+	HRESULT hr = pVoice->lpDSBvoice->GetCurrentPosition(&dwCurrentPlayCursor, &dwCurrentWriteCursor);
+	if (FAILED(hr))
+		return;
+
+	if (sink.dwByteOffset == (DWORD)-1)
+	{
+		// First time, or after a flush
+		sink.dwByteOffset = dwCurrentPlayCursor + (dwBufferSize/8)*3;	// Ideal: 0.375 is between 0.25 & 0.50 full
+		sink.dwByteOffset -= sink.dwByteOffset % uBytesPerFrame;
+		sink.dwByteOffset %= dwBufferSize;
+	}
+	else
+	{
+		// Check that our offset isn't between Play & Write positions (ie. the device has caught us up)
+
+		if (dwCurrentWriteCursor > dwCurrentPlayCursor)
+		{
+			// |-----PxxxxxW-----|
+			if ((sink.dwByteOffset > dwCurrentPlayCursor) && (sink.dwByteOffset < dwCurrentWriteCursor))
+				sink.dwByteOffset = dwCurrentWriteCursor;
+		}
+		else
+		{
+			// |xxW----------Pxxx|
+			if ((sink.dwByteOffset > dwCurrentPlayCursor) || (sink.dwByteOffset < dwCurrentWriteCursor))
+				sink.dwByteOffset = dwCurrentWriteCursor;
+		}
+	}
+
+	// Calc bytes remaining to be played
+	int nBytesRemaining = sink.dwByteOffset - dwCurrentPlayCursor;
+	if (nBytesRemaining < 0)
+		nBytesRemaining += dwBufferSize;
+	if ((nBytesRemaining == 0) && (dwCurrentPlayCursor != dwCurrentWriteCursor))
+		nBytesRemaining = dwBufferSize;		// Case when complete buffer is to be played
+
+	const UINT uFramesFree = (dwBufferSize - nBytesRemaining) / uBytesPerFrame;
+	const UINT uFramesQueued = sink.ring.GetNumSamples() / sink.uNumChannels;
+	UINT uFramesToPop = uFramesQueued < uFramesFree ? uFramesQueued : uFramesFree;
+	UINT uNumFrames = uFramesToPop;
+
+	// Nothing queued (eg. full-speed, or the emulation has stalled) & < 1/4 of play-buffer remaining: pad up to 1/4
+	if (uFramesQueued == 0 && nBytesRemaining < (int)dwBufferSize / 4)
+		uNumFrames = ((dwBufferSize / 4) - nBytesRemaining) / uBytesPerFrame;
+
+	if (uNumFrames)
+	{
+		DWORD dwDSLockedBufferSize0, dwDSLockedBufferSize1;
+		SHORT *pDSLockedBuffer0, *pDSLockedBuffer1;
+
+		if (!DSGetLock(pVoice->lpDSBvoice,
+							sink.dwByteOffset, (DWORD)uNumFrames*uBytesPerFrame,
+							&pDSLockedBuffer0, &dwDSLockedBufferSize0,
+							&pDSLockedBuffer1, &dwDSLockedBufferSize1))
+			return;
+
+		FillFrames(sink, pDSLockedBuffer0, dwDSLockedBufferSize0 / uBytesPerFrame, uFramesToPop);
+		if (pDSLockedBuffer1)
+			FillFrames(sink, pDSLockedBuffer1, dwDSLockedBufferSize1 / uBytesPerFrame, uFramesToPop);
+
+		// Commit sound buffer
+		hr = pVoice->lpDSBvoice->Unlock((void*)pDSLockedBuffer0, dwDSLockedBufferSize0,
+										(void*)pDSLockedBuffer1, dwDSLockedBufferSize1);
+		if (FAILED(hr))
+			return;
+
+		sink.dwByteOffset = (sink.dwByteOffset + dwDSLockedBufferSize0 + dwDSLockedBufferSize1) % dwBufferSize;
+		nBytesRemaining += dwDSLockedBufferSize0 + dwDSLockedBufferSize1;
+	}
+
+	InterlockedExchange(&sink.nDeviceBytes, nBytesRemaining);
+}
+
+// Consume the queued frames at the sample rate, as a device would
+static void ServiceNull(AudioSink& sink)
+{
+	const DWORD dwTick = GetTickCount();
+	sink.fFrameCarry += (double)(dwTick - sink.dwLastTick) * sink.uSampleRate / 1000.0;
+	sink.dwLastTick = dwTick;
+
+	UINT uNumFrames = (UINT) sink.fFrameCarry;
+	const UINT uFramesQueued = sink.ring.GetNumSamples() / sink.uNumChannels;
+	if (uNumFrames > uFramesQueued)
+	{
+		// Underrun: a device would pad with the last frame, so this time is used up (not banked)
+		sink.fFrameCarry -= (double)(uNumFrames - uFramesQueued);
+		uNumFrames = uFramesQueued;
+	}
+	sink.fFrameCarry -= (double)uNumFrames;	// Keep the fractional frame for next time
+
+	short aBuffer[1024];
+	const UINT uMaxFrames = (sizeof(aBuffer) / sizeof(aBuffer[0])) / sink.uNumChannels;
+	while (uNumFrames)
+	{
+		const UINT uNum = uNumFrames < uMaxFrames ? uNumFrames : uMaxFrames;
+		sink.ring.Pop(aBuffer, uNum * sink.uNumChannels);
+		RecordSamples(sink, aBuffer, uNum);
+		uNumFrames -= uNum;
+	}
+
+	// Pretend the device is always ideally full, so the rate control only sees the ring
+	InterlockedExchange(&sink.nDeviceBytes, (sink.dwBufferSize/8)*3);
+}
+
+static void ServiceSink(AudioSink& sink)
+{
+	if (InterlockedExchange(&sink.bFlush, FALSE))
+	{
+		sink.ring.DiscardTo(sink.nFlushTo);
+		sink.dwByteOffset = (DWORD)-1;
+		sink.nLastFrame[0] = sink.nLastFrame[1] = 0;
+
+		// Don't call DSZeroVoiceBuffer() - get noise with "VIA AC'97 Enhanced Audio Controller"
+		// . I guess SpeakerVoice.Stop() isn't really working and the new zero buffer causes noise corruption when submitted.
+		if (sink.pVoice && sink.pVoice->bActive)
+			DSZeroVoiceWritableBuffer(sink.pVoice, sink.pszName, sink.dwBufferSize);
+	}
+
+	if (sink.pVoice)
+		ServiceDevice(sink);
+	else
+		ServiceNull(sink);
+}
+
+static DWORD WINAPI AudioThread(LPVOID lpParameter)
+{
+	while (WaitForSingleObject(g_hAudioStopEvent, kServicePeriodMs) == WAIT_TIMEOUT)
+	{
+		EnterCriticalSection(&g_AudioCS);
+
+		for (UINT i=0; i<NUM_AUDIO_SINKS; i++)
+		{
+			if (g_aSink[i].bRegistered)
+				ServiceSink(g_aSink[i]);
+		}
+
+		LeaveCriticalSection(&g_AudioCS);
+	}
+
+	return 0;
+}
+
+static void StartThread(void)
+{
+	if (g_hAudioThread)
+		return;
+
+	g_hAudioStopEvent = CreateEvent(NULL, FALSE, FALSE, NULL);
+
+	DWORD dwThreadId;
+	g_hAudioThread = CreateThread(NULL, 0, AudioThread, NULL, 0, &dwThreadId);
+	SetThreadPriority(g_hAudioThread, THREAD_PRIORITY_TIME_CRITICAL);
+}
+
+static void StopThread(void)
+{
+	if (!g_hAudioThread)
+		return;
+
+	SetEvent(g_hAudioStopEvent);
+	WaitForSingleObject(g_hAudioThread, INFINITE);
+
+	CloseHandle(g_hAudioThread);
+	g_hAudioThread = NULL;
+	CloseHandle(g_hAudioStopEvent);
+	g_hAudioStopEvent = NULL;
+}
+
+//=============================================================================
+
+// Register a sink's DirectSound voice (or NULL for a null sink), and start the audio thread
+// . the voice must stay valid until AudioThread_RemoveVoice()
+void AudioThread_SetVoice(const AudioSink_e eSink, VOICE* pVoice, const DWORD dwBufferSize, const UINT uSampleRate, const UINT uNumChannels)
+{
+	_ASSERT(uNumChannels == 1 || uNumChannels == 2);
+
+	if (!g_bAudioCSValid)
+	{
+		InitializeCriticalSection(&g_AudioCS);
+		g_bAudioCSValid = true;
+	}
+
+	EnterCriticalSection(&g_AudioCS);
+
+	AudioSink& sink = g_aSink[eSink];
+	sink.ring.Create(dwBufferSize / sizeof(short));		// ie. as much again as the device buffer
+	sink.pVoice = pVoice;
+	sink.pszName = g_szSinkName[eSink];
+	sink.dwBufferSize = dwBufferSize;
+	sink.uSampleRate = uSampleRate;
+	sink.uNumChannels = uNumChannels;
+	sink.dwByteOffset = (DWORD)-1;
+	sink.nLastFrame[0] = sink.nLastFrame[1] = 0;
+	sink.dwLastTick = GetTickCount();
+	sink.fFrameCarry = 0.0;
+	sink.nDeviceBytes = (dwBufferSize/8)*3;
+	sink.bFlush = FALSE;
+	sink.nFlushTo = 0;
+	sink.nNumSamplesError = 0;
+	sink.bRegistered = true;
+
+	LeaveCriticalSection(&g_AudioCS);
+
+	StartThread();
+}
+
+// Unregister a sink (before its voice is released); the audio thread exits when there are none left
+void AudioThread_RemoveVoice(const AudioSink_e eSink)
+{
+	if (!g_bAudioCSValid)
+		return;
+
+	EnterCriticalSection(&g_AudioCS);
+
+	AudioSink& sink = g_aSink[eSink];
+	sink.bRegistered = false;
+	sink.pVoice = NULL;
+	sink.ring.Destroy();
+
+	bool bAnyRegistered = false;
+	for (UINT i=0; i<NUM_AUDIO_SINKS; i++)
+		bAnyRegistered |= g_aSink[i].bRegistered;
+
+	LeaveCriticalSection(&g_AudioCS);
+
+	if (!bAnyRegistered)
+		StopThread();
+}
+
+//=============================================================================
+
+// Called by the emulation thread: queue frames for the audio thread (never blocks)
+// . returns the number of frames queued: all of them if there's no sink (so they're dropped), fewer if the ring is full
+UINT AudioThread_Push(const AudioSink_e eSink, const short* pSamples, const UINT uNumFrames)
+{
+	AudioSink& sink = g_aSink[eSink];
+	if (!sink.bRegistered)
+		return uNumFrames;
+
+	const UINT uNumChannels = sink.uNumChannels;
+	UINT uFramesFree = (sink.ring.GetCapacity() - sink.ring.GetNumSamples()) / uNumChannels;
+	const UINT uNum = uNumFrames < uFramesFree ? uNumFrames : uFramesFree;
+
+	return sink.ring.Push(pSamples, uNum * uNumChannels) / uNumChannels;
+}
+
+// Called by the emulation thread once per batch of samples: the number of extra frames (+ve or -ve) to generate
+// . keeps the queued audio (ring + device) between 1/4 and 1/2 of the device buffer
+int AudioThread_GetSamplesError(const AudioSink_e eSink)
+{
+	AudioSink& sink = g_aSink[eSink];
+	if (!sink.bRegistered)
+		return 0;
+
+	const int nBytesQueued = sink.nDeviceBytes + (int)(sink.ring.GetNumSamples() * sizeof(short));
+	const int nBufferSize = (int)sink.dwBufferSize;
+
+	// Calc correction factor so that play-buffer doesn't under/overflow
+	const int nErrorInc = SoundCore_GetErrorInc();
+	if (nBytesQueued < nBufferSize / 4)
+		sink.nNumSamplesError += nErrorInc;		// < 1/4 of play-buffer remaining (need *more* data)
+	else if (nBytesQueued > nBufferSize / 2)
+		sink.nNumSamplesError -= nErrorInc;		// > 1/2 of play-buffer remaining (need *less* data)
+	else
+		sink.nNumSamplesError = 0;				// Acceptable amount of data in buffer
+
+	const int nErrorMax = SoundCore_GetErrorMax();	// Cap feedback to +/-nMaxError units
+	if (sink.nNumSamplesError < -nErrorMax) sink.nNumSamplesError = -nErrorMax;
+	if (sink.nNumSamplesError >  nErrorMax) sink.nNumSamplesError =  nErrorMax;
+
+	return sink.nNumSamplesError;
+}
+
+// Called by the emulation thread (eg. on reset): drop everything queued so far, and re-sync to the device's play cursor
+void AudioThread_Flush(const AudioSink_e eSink)
+{
+	AudioSink& sink = g_aSink[eSink];
+	if (!sink.bRegistered)
+		return;
+
+	sink.nNumSamplesError = 0;
+	InterlockedExchange(&sink.nDeviceBytes, (sink.dwBufferSize/8)*3);
+	InterlockedExchange(&sink.nFlushTo, sink.ring.GetWriteIndex());
+	InterlockedExchange(&sink.bFlush, TRUE);
+}
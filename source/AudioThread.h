@@ -0,0 +1,17 @@
+#pragma once
+
+#include "SoundCore.h"	// VOICE
+
+// The audio thread owns the DirectSound buffers for the speaker & Mockingboard
+// . the emulation thread only pushes samples (AudioThread_Push()) and reads back the rate feedback (AudioThread_GetSamplesError())
+// . a sink without a VOICE is a null sink: samples are consumed at the sample rate but not played (eg. no sound device)
+// . define RIFF_SPKR or RIFF_MB (SoundCore.h) to also record what the sink consumes to a .wav file
+
+enum AudioSink_e {AUDIO_SINK_SPEAKER=0, AUDIO_SINK_MOCKINGBOARD, NUM_AUDIO_SINKS};
+
+void	AudioThread_SetVoice(const AudioSink_e sink, VOICE* pVoice, const DWORD dwBufferSize, const UINT uSampleRate, const UINT uNumChannels);
+void	AudioThread_RemoveVoice(const AudioSink_e sink);
+
+UINT	AudioThread_Push(const AudioSink_e sink, const short* pSamples, const UINT uNumFrames);
+int		AudioThread_GetSamplesError(const AudioSink_e sink);
+void	AudioThread_Flush(const AudioSink_e sink);
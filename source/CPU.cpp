@@ -88,6 +88,7 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 
 #include "Applewin.h"
 #include "CPU.h"
+#include "Disk.h"
 #include "Frame.h"
 #include "Memory.h"
 #include "Mockingboard.h"
@@ -103,6 +104,7 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 #include "Z80VICE/z80mem.h"
 
 #include "YamlHelper.h"
+#include "Debugger/Debugger_Trace.h"
 
 // 6502 Accumulator Bit Flags
 	#define	 AF_SIGN       0x80
@@ -132,21 +134,27 @@ unsigned __int64 g_nCumulativeCycles = 0;
 static ULONG g_nCyclesExecuted;	// # of cycles executed up to last IO access
 
 //static signed long g_uInternalExecutedCycles;
-// TODO: Use IRQ_CHECK_TIMEOUT=128 when running at full-speed else with IRQ_CHECK_TIMEOUT=1
-// - What about when running benchmark?
-static const int IRQ_CHECK_TIMEOUT = 128;
-static signed int g_nIrqCheckTimeout = IRQ_CHECK_TIMEOUT;
 
-//
+// Synchronous events (eg. 6522 timer underflow, mouse VBL):
+// . Each event has an absolute g_nCumulativeCycles deadline, and CYC() counts g_nIrqCheckTimeout down to the earliest one
+// . So CheckInterruptSources() only does work when an event is due, and then on the exact opcode boundary
+// . Same idea as VICE's alarm context (see CommonVICE/alarm.h): a small array of pending events & a cached earliest deadline
+static const int IRQ_CHECK_TIMEOUT_MAX = 0x10000;	// Max cycles between checks when no event is due sooner
+static signed int g_nIrqCheckTimeout = 0;
+static unsigned __int64 g_nIrqCheckCycle = 0;		// The cycle that g_nIrqCheckTimeout is counting down to
+
+struct SyncEvent_t
+{
+	bool bPending;
+	unsigned __int64 uCycle;
+	SyncEventCallback_t pfnCallback;
+};
+
+static SyncEvent_t g_aSyncEvents[NUM_SYNCEVENTS] = {0};
 
-// Assume all interrupt sources assert until the device is told to stop:
-// - eg by r/w to device's register or a machine reset
+//
 
-static bool g_bCritSectionValid = false;	// Deleting CritialSection when not valid causes crash on Win98
-static CRITICAL_SECTION g_CriticalSection;	// To guard /g_bmIRQ/ & /g_bmNMI/
-static volatile UINT32 g_bmIRQ = 0;
-static volatile UINT32 g_bmNMI = 0;
-static volatile BOOL g_bNmiFlank = FALSE; // Positive going flank on NMI line
+#include "CPU/cpu_irq.inl"
 
 //
 
@@ -196,6 +204,7 @@ void SetActiveCpu(eCpuType cpu)
 //
 
 #include "CPU/cpu_general.inl"
+static void CpuWriteTrap(WORD addr, BYTE a, ULONG uExecutedCycles);	// See cpu_breakpoints.inl
 
 #include "CPU/cpu_instructions.inl"
 
@@ -365,7 +374,7 @@ static __forceinline void Fetch(BYTE& iOpcode, ULONG uExecutedCycles)
 
 	iOpcode = ((PC & 0xF000) == 0xC000)
 	    ? IORead[(PC>>4) & 0xFF](PC,PC,0,0,uExecutedCycles)	// Fetch opcode from I/O memory, but params are still from mem[]
-		: *(mem+PC);
+		: MEMREAD(PC);
 
 #ifdef USE_SPEECH_API
 	if (PC == COUT && g_Speech.IsEnabled() && !g_bFullSpeed)
@@ -379,10 +388,10 @@ static __forceinline void Fetch(BYTE& iOpcode, ULONG uExecutedCycles)
 static __forceinline void NMI(ULONG& uExecutedCycles, BOOL& flagc, BOOL& flagn, BOOL& flagv, BOOL& flagz)
 {
 #ifdef ENABLE_NMI_SUPPORT
-	if(g_bNmiFlank)
+	// NMI signals are only serviced once: atomically consume the flank, so a flank raised by another thread isn't lost
+	// . plain read first, so there's no locked op per opcode while the flank is clear
+	if(g_bNmiFlank && InterlockedExchange(&g_bNmiFlank, FALSE))
 	{
-		// NMI signals are only serviced once
-		g_bNmiFlank = FALSE;
 #ifdef _DEBUG
 		g_nCycleIrqStart = g_nCumulativeCycles + uExecutedCycles;
 #endif
@@ -391,7 +400,7 @@ static __forceinline void NMI(ULONG& uExecutedCycles, BOOL& flagc, BOOL& flagn,
 		EF_TO_AF
 		PUSH(regs.ps & ~AF_BREAK)
 		regs.ps = regs.ps | AF_INTERRUPT & ~AF_DECIMAL;
-		regs.pc = * (WORD*) (mem+0xFFFA);
+		regs.pc = MEMREAD16(0xFFFA);
 		UINT uExtraCycles = 0;	// Needed for CYC(a) macro
 		CYC(7)
 	}
@@ -411,32 +420,100 @@ static __forceinline void IRQ(ULONG& uExecutedCycles, BOOL& flagc, BOOL& flagn,
 		EF_TO_AF
 		PUSH(regs.ps & ~AF_BREAK)
 		regs.ps = regs.ps | AF_INTERRUPT & ~AF_DECIMAL;
-		regs.pc = * (WORD*) (mem+0xFFFE);
+		regs.pc = MEMREAD16(0xFFFE);
 		UINT uExtraCycles = 0;	// Needed for CYC(a) macro
 		CYC(7)
 	}
 }
 
-static __forceinline void CheckInterruptSources(ULONG uExecutedCycles)
+// Re-arm g_nIrqCheckTimeout for the earliest pending event
+static void SyncEventsUpdateTimeout(const unsigned __int64 uCycleNow)
+{
+	unsigned __int64 uCycleNext = uCycleNow + IRQ_CHECK_TIMEOUT_MAX;
+
+	for (UINT i=0; i<NUM_SYNCEVENTS; i++)
+	{
+		const SyncEvent_t& event = g_aSyncEvents[i];
+		if (event.bPending && event.uCycle < uCycleNext)
+			uCycleNext = (event.uCycle > uCycleNow) ? event.uCycle : uCycleNow;	// Already due: fire at next check
+	}
+
+	g_nIrqCheckCycle = uCycleNext;
+	g_nIrqCheckTimeout = (signed int) (uCycleNext - uCycleNow);
+}
+
+// Shift all pending events when g_nCumulativeCycles is set directly (eg. loading a save-state)
+static void SyncEventsTimeWarp(const unsigned __int64 uNewCumulativeCycles)
+{
+	const unsigned __int64 uWarp = uNewCumulativeCycles - g_nCumulativeCycles;	// NB. unsigned wrap is OK for -ve warps
+
+	for (UINT i=0; i<NUM_SYNCEVENTS; i++)
+		g_aSyncEvents[i].uCycle += uWarp;
+
+	g_nIrqCheckCycle += uWarp;
+}
+
+static void SyncEventsDispatch(ULONG uExecutedCycles)
 {
-	if (g_nIrqCheckTimeout < 0)
+	CpuCalcCycles(uExecutedCycles);
+
+	for (UINT i=0; i<NUM_SYNCEVENTS; i++)
 	{
-		MB_UpdateCycles(uExecutedCycles);
-		sg_Mouse.SetVBlank( !VideoGetVblBar(uExecutedCycles) );
-		g_nIrqCheckTimeout = IRQ_CHECK_TIMEOUT;
+		SyncEvent_t& event = g_aSyncEvents[i];
+		if (event.bPending && event.uCycle <= g_nCumulativeCycles)
+		{
+			event.bPending = false;
+			event.pfnCallback(uExecutedCycles);	// NB. Callback may set this event again
+		}
 	}
+
+	SyncEventsUpdateTimeout(g_nCumulativeCycles);
+}
+
+static __forceinline void CheckInterruptSources(ULONG uExecutedCycles)
+{
+	if (g_nIrqCheckTimeout <= 0)
+		SyncEventsDispatch(uExecutedCycles);
+}
+
+// Mouse card's VBL interrupt: re-arms itself for the next change of VBL'
+static void MouseVBlankSyncEvent(ULONG uExecutedCycles)
+{
+	sg_Mouse.SetVBlank( !VideoGetVblBar(uExecutedCycles) );
+	CpuSyncEventSet(SYNCEVENT_MOUSE_VBL, g_nCumulativeCycles + VideoGetCyclesUntilVblChange(uExecutedCycles), MouseVBlankSyncEvent);
 }
 
 //===========================================================================
 
 #include "CPU/cpu6502.h"  // MOS 6502
 #include "CPU/cpu65C02.h" // WDC 65C02
+#include "CPU/cpu_profile.inl" // Both of the above, for the runtime profiler
+#include "CPU/cpu_breakpoints.inl" // Both of the above, checking the debugger's breakpoints
 #include "CPU/cpu65d02.h" // Debug CPU Memory Visualizer
 
 //===========================================================================
 
 static DWORD InternalCpuExecute(const DWORD uTotalCycles, const bool bVideoUpdate)
 {
+	if (g_bCpuProfile)
+		ProfileBeginPeriod();
+
+	if (g_pCpuBreakpoints)
+	{
+		if (GetMainCpu() == CPU_6502)
+			return Cpu6502_Breakpoints(uTotalCycles, bVideoUpdate);
+		else
+			return Cpu65C02_Breakpoints(uTotalCycles, bVideoUpdate);
+	}
+
+	if (g_bCpuProfile)
+	{
+		if (GetMainCpu() == CPU_6502)
+			return Cpu6502_Profile(uTotalCycles, bVideoUpdate);
+		else
+			return Cpu65C02_Profile(uTotalCycles, bVideoUpdate);
+	}
+
 	if (GetMainCpu() == CPU_6502)
 		return Cpu6502(uTotalCycles, bVideoUpdate);		// Apple ][, ][+, //e, Clones
 	else
@@ -451,11 +528,15 @@ static DWORD InternalCpuExecute(const DWORD uTotalCycles, const bool bVideoUpdat
 
 void CpuDestroy ()
 {
-	if (g_bCritSectionValid)
-	{
-  		DeleteCriticalSection(&g_CriticalSection);
-		g_bCritSectionValid = false;
-	}
+	// NB. The IRQ & NMI lines are lock-free (see cpu_irq.inl)
+
+	g_bCpuProfile = false;
+	delete [] g_pProfileHistogram;
+	g_pProfileHistogram = NULL;
+	delete [] g_pProfileNodes;
+	g_pProfileNodes = NULL;
+	delete [] g_pProfileNodeHash;
+	g_pProfileNodeHash = NULL;
 }
 
 //===========================================================================
@@ -481,6 +562,31 @@ void CpuCalcCycles(const ULONG nExecutedCycles)
 
 //===========================================================================
 
+// Description:
+//  Run pfnCallback once g_nCumulativeCycles reaches uCycle (checked after every opcode, so an IRQ it asserts is taken on time)
+//  . Replaces any pending deadline for this event
+//  . Can be called from an IO handler or from an event's callback
+void CpuSyncEventSet(const eSyncEvent Event, const unsigned __int64 uCycle, const SyncEventCallback_t pfnCallback)
+{
+	SyncEvent_t& event = g_aSyncEvents[Event];
+	event.bPending = true;
+	event.uCycle = uCycle;
+	event.pfnCallback = pfnCallback;
+
+	if (uCycle < g_nIrqCheckCycle)
+	{
+		// The cycle 'now' (as counted down by CYC()) is g_nIrqCheckCycle - g_nIrqCheckTimeout
+		SyncEventsUpdateTimeout(g_nIrqCheckCycle - g_nIrqCheckTimeout);
+	}
+}
+
+void CpuSyncEventCancel(const eSyncEvent Event)
+{
+	g_aSyncEvents[Event].bPending = false;	// NB. Leave g_nIrqCheckTimeout: at worst there's one spare check
+}
+
+//===========================================================================
+
 // Old method with g_uInternalExecutedCycles runs faster!
 //        Old     vs    New
 // - 68.0,69.0MHz vs  66.7, 67.2MHz  (with check for VBL IRQ every opcode)
@@ -508,8 +614,12 @@ DWORD CpuExecute(const DWORD uCycles, const bool bVideoUpdate)
 {
 	g_nCyclesExecuted =	0;
 
+	MemFlushLinearImage();	// Only needed for MEM_NOCOPY_PAGING
+
 	MB_StartOfCpuExecute();
 
+	SyncEventsUpdateTimeout(g_nCumulativeCycles);
+
 	// uCycles:
 	//  =0  : Do single step
 	//  >0  : Do multi-opcode emulation
@@ -523,6 +633,8 @@ DWORD CpuExecute(const DWORD uCycles, const bool bVideoUpdate)
 	const UINT nRemainingCycles = uExecutedCycles - g_nCyclesExecuted;
 	g_nCumulativeCycles	+= nRemainingCycles;
 
+	MemUpdateLinearImage();	// Only needed for MEM_NOCOPY_PAGING
+
 	return uExecutedCycles;
 }
 
@@ -535,11 +647,11 @@ void CpuInitialize ()
 	regs.sp = 0x01FF;
 	CpuReset();	// Init's ps & pc. Updates sp
 
-	InitializeCriticalSection(&g_CriticalSection);
-	g_bCritSectionValid = true;
 	CpuIrqReset();
 	CpuNmiReset();
 
+	CpuSyncEventSet(SYNCEVENT_MOUSE_VBL, g_nCumulativeCycles, MouseVBlankSyncEvent);
+
 	z80mem_initialize();
 	z80_reset();
 }
@@ -576,61 +688,97 @@ void CpuSetupBenchmark ()
 			}
 		} while (opcode < BENCHOPCODES);
 	}
+
+	memdirty[0x03] |= 1;	// Code was written to mem[] directly
 }
 
 //===========================================================================
 
-void CpuIrqReset()
+// Run the CPU loops that check these breakpoints (NULL to run the normal loops)
+// . the breakpoints must stay valid until this is called again with NULL
+// . pages with a memory breakpoint get a page trap, so accesses to all other pages aren't checked
+void CpuSetBreakpoints(const CpuBreakpoints* pBreakpoints)
 {
-	_ASSERT(g_bCritSectionValid);
-	if (g_bCritSectionValid) EnterCriticalSection(&g_CriticalSection);
-	g_bmIRQ = 0;
-	if (g_bCritSectionValid) LeaveCriticalSection(&g_CriticalSection);
+	g_pCpuBreakpoints = pBreakpoints;
+	g_nCpuBreakpointHit = 0;
+
+	if (!pBreakpoints)
+	{
+		MemSetPageTraps(NULL);
+		return;
+	}
+
+	BYTE aPageTraps[0x100];
+	for (UINT uPage = 0; uPage < 0x100; uPage++)
+	{
+		BYTE nAccess = 0;
+		for (UINT i = 0; i < 0x100; i++)
+			nAccess |= pBreakpoints->aAddress[(uPage << 8) + i];
+
+		aPageTraps[uPage] = ((nAccess & CPU_BREAK_READ) ? MEMTRAP_READ : 0)
+						  | ((nAccess & CPU_BREAK_WRITE) ? MEMTRAP_WRITE : 0);
+	}
+
+	MemSetPageTraps(aPageTraps);
 }
 
-void CpuIrqAssert(eIRQSRC Device)
+// Returns the CPU_BREAK_* flags for why the CPU loop returned early (0 if it didn't), and clears them
+// . nAddress is the memory address, for CPU_BREAK_READ or CPU_BREAK_WRITE
+BYTE CpuGetBreakpointHit(WORD& nAddress)
 {
-	_ASSERT(g_bCritSectionValid);
-	if (g_bCritSectionValid) EnterCriticalSection(&g_CriticalSection);
-	g_bmIRQ |= 1<<Device;
-	if (g_bCritSectionValid) LeaveCriticalSection(&g_CriticalSection);
+	const BYTE nHit = g_nCpuBreakpointHit;
+	nAddress = g_nCpuBreakpointAddress;
+	g_nCpuBreakpointHit = 0;
+	return nHit;
 }
 
-void CpuIrqDeassert(eIRQSRC Device)
+//===========================================================================
+
+// Start (or restart) the runtime profiler, with no data
+void CpuProfileStart(void)
 {
-	_ASSERT(g_bCritSectionValid);
-	if (g_bCritSectionValid) EnterCriticalSection(&g_CriticalSection);
-	g_bmIRQ &= ~(1<<Device);
-	if (g_bCritSectionValid) LeaveCriticalSection(&g_CriticalSection);
+	if (!g_pProfileHistogram)
+	{
+		g_pProfileHistogram = new unsigned __int64[64*1024];
+		g_pProfileNodes = new CpuProfileNode[PROFILE_MAX_NODES];
+		g_pProfileNodeHash = new UINT[PROFILE_NODE_HASH_SIZE];
+	}
+
+	memset(g_pProfileHistogram, 0, 64*1024 * sizeof(g_pProfileHistogram[0]));
+	memset(g_pProfileNodeHash, 0, PROFILE_NODE_HASH_SIZE * sizeof(g_pProfileNodeHash[0]));
+	memset(&g_pProfileNodes[0], 0, sizeof(g_pProfileNodes[0]));
+	g_nProfileNodes = 1;	// Just the root
+
+	g_nProfileDepth = 0;
+	g_nProfileNode = 0;
+	g_nProfilePC = regs.pc;
+	g_uProfileCycles = 0;
+
+	g_bCpuProfile = true;
 }
 
-//===========================================================================
+// Stop profiling: the data is kept until the next CpuProfileStart()
+void CpuProfileStop(void)
+{
+	g_bCpuProfile = false;
+}
 
-void CpuNmiReset()
+bool CpuProfileIsActive(void)
 {
-	_ASSERT(g_bCritSectionValid);
-	if (g_bCritSectionValid) EnterCriticalSection(&g_CriticalSection);
-	g_bmNMI = 0;
-	g_bNmiFlank = FALSE;
-	if (g_bCritSectionValid) LeaveCriticalSection(&g_CriticalSection);
+	return g_bCpuProfile;
 }
 
-void CpuNmiAssert(eIRQSRC Device)
+// Cycles per opcode address (NULL if the profiler has never been started)
+const unsigned __int64* CpuProfileGetHistogram(void)
 {
-	_ASSERT(g_bCritSectionValid);
-	if (g_bCritSectionValid) EnterCriticalSection(&g_CriticalSection);
-	if (g_bmNMI == 0) // NMI line is just becoming active
-	    g_bNmiFlank = TRUE;
-	g_bmNMI |= 1<<Device;
-	if (g_bCritSectionValid) LeaveCriticalSection(&g_CriticalSection);
+	return g_pProfileHistogram;
 }
 
-void CpuNmiDeassert(eIRQSRC Device)
+// Returns the number of nodes: a node's parent always comes before it
+UINT CpuProfileGetNodes(const CpuProfileNode*& pNodes)
 {
-	_ASSERT(g_bCritSectionValid);
-	if (g_bCritSectionValid) EnterCriticalSection(&g_CriticalSection);
-	g_bmNMI &= ~(1<<Device);
-	if (g_bCritSectionValid) LeaveCriticalSection(&g_CriticalSection);
+	pNodes = g_pProfileNodes;
+	return g_pProfileNodes ? g_nProfileNodes : 0;
 }
 
 //===========================================================================
@@ -639,7 +787,7 @@ void CpuReset()
 {
 	// 7 cycles
 	regs.ps = (regs.ps | AF_INTERRUPT) & ~AF_DECIMAL;
-	regs.pc = * (WORD*) (mem+0xFFFC);
+	regs.pc = MEMREAD16(0xFFFC);
 	regs.sp = 0x0100 | ((regs.sp - 3) & 0xFF);
 
 	regs.bJammed = 0;
@@ -661,6 +809,7 @@ void CpuSetSnapshot_v1(const BYTE A, const BYTE X, const BYTE Y, const BYTE P, c
 
 	CpuIrqReset();
 	CpuNmiReset();
+	SyncEventsTimeWarp(CumulativeCycles);
 	g_nCumulativeCycles = CumulativeCycles;
 }
 
@@ -720,7 +869,9 @@ void CpuLoadSnapshot(YamlLoadHelper& yamlLoadHelper)
 
 	CpuIrqReset();
 	CpuNmiReset();
-	g_nCumulativeCycles = yamlLoadHelper.LoadUint64(SS_YAML_KEY_CUMULATIVECYCLES);
+	const unsigned __int64 uCumulativeCycles = yamlLoadHelper.LoadUint64(SS_YAML_KEY_CUMULATIVECYCLES);
+	SyncEventsTimeWarp(uCumulativeCycles);
+	g_nCumulativeCycles = uCumulativeCycles;
 
 	yamlLoadHelper.PopMap();
 }
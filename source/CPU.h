@@ -14,12 +14,44 @@ struct regsrec
 extern regsrec    regs;
 extern unsigned __int64 g_nCumulativeCycles;
 
+// Synchronous events: a device callback run by the CPU loop once g_nCumulativeCycles reaches an absolute deadline
+enum eSyncEvent {SYNCEVENT_6522_TIMER=0, SYNCEVENT_MOUSE_VBL, NUM_SYNCEVENTS};
+typedef void (*SyncEventCallback_t)(ULONG uExecutedCycles);
+
+// Debugger breakpoints, compiled for the CPU loop (see cpu_breakpoints.inl)
+enum {CPU_BREAK_EXEC=1<<0, CPU_BREAK_READ=1<<1, CPU_BREAK_WRITE=1<<2, CPU_BREAK_REG=1<<3};
+struct CpuBreakpoints
+{
+	BYTE aAddress[64*1024];		// CPU_BREAK_EXEC/READ/WRITE, per address
+	bool aOpcode[256];			// Stop before these opcodes (so the debugger can check them itself)
+	bool (*pfnCheckRegs)(void);	// Register conditions, checked after each opcode (NULL if none)
+	bool bTrace;				// Add a record to the binary trace file before each opcode (see Debugger_Trace.h)
+};
+
+// Runtime profiler: a calling-context tree node, ie. a routine on one call path (see cpu_profile.inl)
+struct CpuProfileNode
+{
+	UINT nParent;				// Caller's node (node 0 is the root: not in any routine)
+	WORD nRoutine;				// Routine's address: a JSR target or an interrupt handler
+	UINT nCalls;
+	unsigned __int64 nCycles;	// Exclusive: cycles spent in this routine itself, on this call path
+};
+
 void    CpuDestroy ();
 void    CpuCalcCycles(ULONG nExecutedCycles);
 DWORD   CpuExecute(const DWORD uCycles, const bool bVideoUpdate);
 ULONG   CpuGetCyclesThisVideoFrame(ULONG nExecutedCycles);
 void    CpuInitialize ();
 void    CpuSetupBenchmark ();
+void    CpuSetBreakpoints(const CpuBreakpoints* pBreakpoints);
+BYTE    CpuGetBreakpointHit(WORD& nAddress);
+void    CpuProfileStart(void);
+void    CpuProfileStop(void);
+bool    CpuProfileIsActive(void);
+const unsigned __int64* CpuProfileGetHistogram(void);
+UINT    CpuProfileGetNodes(const CpuProfileNode*& pNodes);
+void    CpuSyncEventSet(eSyncEvent Event, unsigned __int64 uCycle, SyncEventCallback_t pfnCallback);
+void    CpuSyncEventCancel(eSyncEvent Event);
 void	CpuIrqReset();
 void	CpuIrqAssert(eIRQSRC Device);
 void	CpuIrqDeassert(eIRQSRC Device);
@@ -76,14 +76,14 @@ inline u8 ReadByte( u16 addr, int uExecutedCycles )
 
 	return ((addr & 0xF000) == 0xC000)
 		? IORead[(addr>>4) & 0xFF](regs.pc,addr,0,0,uExecutedCycles)
-		: *(mem+addr);
+		: MEMREAD(addr);
 }
 
 #undef WRITE
 #define WRITE(a)                                              \
 	HEATMAP_W(addr);                                          \
 	{                                                         \
-		memdirty[addr >> 8] = 0xFF;                           \
+		memdirty[addr >> 8] = MEMDIRTY_CPU;                   \
 		LPBYTE page = memwrite[addr >> 8];                    \
 		if (page)                                             \
 			*(page+(addr & 0xFF)) = (BYTE)(a);                \
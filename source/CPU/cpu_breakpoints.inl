@@ -0,0 +1,141 @@
+/*
+AppleWin : An Apple //e emulator for Windows
+
+Copyright (C) 1994-1996, Michael O'Brien
+Copyright (C) 1999-2001, Oliver Schmidt
+Copyright (C) 2002-2005, Tom Charlesworth
+Copyright (C) 2006-2019, Tom Charlesworth, Michael Pohoreski
+
+AppleWin is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+AppleWin is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with AppleWin; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+*/
+
+/* Description: 6502/65C02 loops that check the debugger's breakpoints
+ *
+ * When the debugger runs to a breakpoint ("G"), it compiles its breakpoints into a CpuBreakpoints (see CompileBreakpoints() in Debug.cpp).
+ * CpuExecute() then runs these variants of Cpu6502()/Cpu65C02() for whole execution periods, instead of the debugger single-stepping:
+ * . memory breakpoints use page traps (see MemSetPageTraps()), so only accesses to a page with a breakpoint are checked:
+ *   - WRITE finds a NULL memwrite[] entry for a trapped page, and calls CpuWriteTrap()
+ *   - READ checks memtrap[], and calls CpuReadTrap() for a trapped page
+ * . after each opcode (and any interrupt), the new PC is checked against the map, then the register conditions (if any)
+ * . and, if tracing, a record is added to the binary trace file (for the opcode about to execute)
+ * . the loop also stops before any opcode the debugger must check itself (eg. break on BRK), or a PC in I/O memory
+ * On a stop the loop returns early: CpuGetBreakpointHit() says why.
+ * These loops also update the runtime profiler, if it's on (see cpu_profile.inl).
+ */
+
+static const CpuBreakpoints* g_pCpuBreakpoints = NULL;
+static BYTE g_nCpuBreakpointHit = 0;			// CPU_BREAK_*
+static WORD g_nCpuBreakpointAddress = 0;		// Memory address of a CPU_BREAK_READ or CPU_BREAK_WRITE
+
+static __forceinline void BreakOnAccess(WORD addr, BYTE type)
+{
+	if (g_pCpuBreakpoints && (g_pCpuBreakpoints->aAddress[addr] & type))
+	{
+		g_nCpuBreakpointHit |= type;
+		g_nCpuBreakpointAddress = addr;
+	}
+}
+
+// A write to a trapped page (from any loop, as the trap is in memwrite[])
+static void CpuWriteTrap(WORD addr, BYTE a, ULONG uExecutedCycles)
+{
+	BreakOnAccess(addr, CPU_BREAK_WRITE);
+
+	LPBYTE page = memtrapwrite[addr >> 8];
+	if (page)
+		*(page+(addr & 0xFF)) = a;
+	else if ((addr & 0xF000) == 0xC000)
+		IOWrite[(addr>>4) & 0xFF](regs.pc,addr,1,a,uExecutedCycles);
+}
+
+static __forceinline BYTE CpuReadTrap(WORD addr, ULONG uExecutedCycles)
+{
+	BreakOnAccess(addr, CPU_BREAK_READ);
+
+	return ((addr & 0xF000) == 0xC000)
+		? IORead[(addr>>4) & 0xFF](regs.pc,addr,0,0,uExecutedCycles)
+		: MEMREAD(addr);
+}
+
+#undef READ
+#define READ	 (							    \
+		    memtrap[addr >> 8]					    \
+		    ? CpuReadTrap(addr,uExecutedCycles)			    \
+		    : ((addr & 0xF000) == 0xC000)			    \
+		    ? IORead[(addr>>4) & 0xFF](regs.pc,addr,0,0,uExecutedCycles) \
+			: MEMREAD(addr)					    \
+		 )
+
+// NB. regs.ps must be up-to-date
+static __forceinline void TraceOpcode(ULONG uExecutedCycles)
+{
+	TraceRecord_t record;
+	record.nPC = regs.pc;
+	record.aOpcode[0] = MEMREAD(regs.pc);
+	record.aOpcode[1] = MEMREAD((WORD)(regs.pc+1));
+	record.aOpcode[2] = MEMREAD((WORD)(regs.pc+2));
+	record.nA = regs.a;
+	record.nX = regs.x;
+	record.nY = regs.y;
+	record.nP = regs.ps;
+	record.nS = (BYTE) regs.sp;
+	record.nReserved[0] = record.nReserved[1] = 0;
+
+	TraceFile_Add(record, g_nCumulativeCycles + (uExecutedCycles - g_nCyclesExecuted));	// cf. CpuCalcCycles()
+}
+
+// Called after each opcode: true to return from the loop before executing the opcode at regs.pc
+static __forceinline bool IsBreakpointHit(ULONG uExecutedCycles, BOOL flagc, BOOL flagn, BOOL flagv, BOOL flagz)
+{
+	const CpuBreakpoints& bp = *g_pCpuBreakpoints;
+
+	if (bp.aAddress[regs.pc] & CPU_BREAK_EXEC)
+		g_nCpuBreakpointHit |= CPU_BREAK_EXEC;
+
+	if (bp.pfnCheckRegs || bp.bTrace)
+	{
+		EF_TO_AF
+
+		if (bp.bTrace && GetActiveCpu() != CPU_Z80)
+			TraceOpcode(uExecutedCycles);
+
+		if (bp.pfnCheckRegs && bp.pfnCheckRegs())
+			g_nCpuBreakpointHit |= CPU_BREAK_REG;
+	}
+
+	if (g_nCpuBreakpointHit)
+		return true;
+
+	// Stop, and let the debugger check (and single-step) this opcode
+	if ((regs.pc & 0xF000) == 0xC000 && !MemIsAddrCodeMemory(regs.pc))
+		return true;
+
+	return bp.aOpcode[MEMREAD(regs.pc)];
+}
+
+//===========================================================================
+
+#define CPU_BREAKPOINTS
+#define CPU_PROFILE
+#define Cpu6502 Cpu6502_Breakpoints
+#define Cpu65C02 Cpu65C02_Breakpoints
+
+#include "CPU/cpu6502.h"
+#include "CPU/cpu65C02.h"
+
+#undef Cpu6502
+#undef Cpu65C02
+#undef CPU_PROFILE
+#undef CPU_BREAKPOINTS
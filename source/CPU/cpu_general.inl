@@ -50,25 +50,42 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 			      | AF_RESERVED | AF_BREAK;
 // CYC(a): This can be optimised, as only certain opcodes will affect uExtraCycles
 #define CYC(a)	 uExecutedCycles += (a)+uExtraCycles; g_nIrqCheckTimeout -= (a)+uExtraCycles;
+
+// MEMREAD(a), MEMREAD16(a): Non-I/O reads (opcode operands, ZP pointers, vectors)
+// . NB. 'a' may be evaluated more than once, so must not have side-effects
+#ifdef MEM_NOCOPY_PAGING
+#define MEMREAD(a)	 (*(memread[(WORD)(a) >> 8]+((a) & 0xFF)))
+#define MEMREAD16(a) ((WORD)MEMREAD(a) | ((WORD)MEMREAD((WORD)((a)+1)) << 8))
+#define POP	 (*(memread[0x01]+(((regs.sp >= 0x1FF) ? (regs.sp = 0x100) : ++regs.sp) & 0xFF)))
+#define PUSH(a)	 *(memwrite[0x01]+(regs.sp-- & 0xFF)) = (a);	    \
+		 if (regs.sp < 0x100)					    \
+		   regs.sp = 0x1FF;
+#else
+#define MEMREAD(a)	 (*(mem+(a)))
+#define MEMREAD16(a) (*(LPWORD)(mem+(a)))
 #define POP	 (*(mem+((regs.sp >= 0x1FF) ? (regs.sp = 0x100) : ++regs.sp)))
 #define PUSH(a)	 *(mem+regs.sp--) = (a);				    \
 		 if (regs.sp < 0x100)					    \
 		   regs.sp = 0x1FF;
+#endif
 #define READ	 (							    \
 		    ((addr & 0xF000) == 0xC000)				    \
 		    ? IORead[(addr>>4) & 0xFF](regs.pc,addr,0,0,uExecutedCycles) \
-			: *(mem+addr)					    \
+			: MEMREAD(addr)					    \
 		 )
 #define SETNZ(a) {							    \
 		   flagn = ((a) & 0x80);				    \
 		   flagz = !((a) & 0xFF);					    \
 		 }
 #define SETZ(a)	 flagz = !((a) & 0xFF);
+// WRITE(a): a NULL memwrite[] entry is ROM, I/O, or a page trap (see MemSetPageTraps())
 #define WRITE(a) {							    \
-		   memdirty[addr >> 8] = 0xFF;				    \
+		   memdirty[addr >> 8] = MEMDIRTY_CPU;			    \
 		   LPBYTE page = memwrite[addr >> 8];		    \
 		   if (page)						    \
 		     *(page+(addr & 0xFF)) = (BYTE)(a);			    \
+		   else if (memtrap[addr >> 8])				    \
+		     CpuWriteTrap(addr,(BYTE)(a),uExecutedCycles);	    \
 		   else if ((addr & 0xF000) == 0xC000)			    \
 		     IOWrite[(addr>>4) & 0xFF](regs.pc,addr,1,(BYTE)(a),uExecutedCycles); \
 		 }
@@ -95,75 +112,109 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 #define CHECK_PAGE_CHANGE	if ((base ^ addr) & 0xFF00)			\
 									uExtraCycles=1;
 
+/****************************************************************************
+*
+*  OPCODE DISPATCH MACROS
+*
+***/
+
+// OPCODE_DISPATCH(op) { OP(0x00): ... break; ... OP(0xFF): ... break; }
+// . Default: a plain 'switch', so the compiler generates a (bounds-checked) jump table
+// . CPU_THREADED_DISPATCH: jump straight to the opcode's label via a table of label addresses (GCC/Clang "labels as values")
+//   NB. The labels live in the body of a 'switch (0)' with no cases, so each opcode's 'break' still exits the dispatch
+// . CPU_THREADED_DISPATCH (MSVC): no "labels as values", so keep the switch but mark 'default' as unreachable
+//   All 256 opcodes have a case, so the jump table is indexed directly (no range check & branch to 'default')
+//   NB. 'default' is hidden in an 'if (0)' ahead of the switch body, so the body is unchanged
+#if defined(CPU_THREADED_DISPATCH) && defined(__GNUC__)
+#define OP(n) op_##n
+#define OPCODE_LABEL_ROW(h) &&op_##h##0, &&op_##h##1, &&op_##h##2, &&op_##h##3, &&op_##h##4, &&op_##h##5, &&op_##h##6, &&op_##h##7, \
+                            &&op_##h##8, &&op_##h##9, &&op_##h##A, &&op_##h##B, &&op_##h##C, &&op_##h##D, &&op_##h##E, &&op_##h##F
+#define OPCODE_DISPATCH(op) \
+		static const void* const aOpcodeLabels[256] = {	\
+			OPCODE_LABEL_ROW(0x0), OPCODE_LABEL_ROW(0x1), OPCODE_LABEL_ROW(0x2), OPCODE_LABEL_ROW(0x3),	\
+			OPCODE_LABEL_ROW(0x4), OPCODE_LABEL_ROW(0x5), OPCODE_LABEL_ROW(0x6), OPCODE_LABEL_ROW(0x7),	\
+			OPCODE_LABEL_ROW(0x8), OPCODE_LABEL_ROW(0x9), OPCODE_LABEL_ROW(0xA), OPCODE_LABEL_ROW(0xB),	\
+			OPCODE_LABEL_ROW(0xC), OPCODE_LABEL_ROW(0xD), OPCODE_LABEL_ROW(0xE), OPCODE_LABEL_ROW(0xF)	\
+		};	\
+		goto *aOpcodeLabels[op];	\
+		switch (0)
+#elif defined(CPU_THREADED_DISPATCH) && defined(_MSC_VER)
+#define OP(n) case n
+#define OPCODE_DISPATCH(op) switch (op) if (0) default: __assume(0); else
+#else
+#define OP(n) case n
+#define OPCODE_DISPATCH(op) switch (op)
+#endif
+
 /****************************************************************************
 *
 *  ADDRESSING MODE MACROS
 *
 ***/
 
-#define ABS	 addr = *(LPWORD)(mem+regs.pc);	 regs.pc += 2;
-#define IABSX    addr = *(LPWORD)(mem+(*(LPWORD)(mem+regs.pc))+(WORD)regs.x); regs.pc += 2;
+#define ABS	 addr = MEMREAD16(regs.pc);	 regs.pc += 2;
+#define IABSX    addr = MEMREAD16((WORD)(MEMREAD16(regs.pc)+(WORD)regs.x)); regs.pc += 2;
 
 // Optimised for page-cross
-#define ABSX_OPT base = *(LPWORD)(mem+regs.pc); addr = base+(WORD)regs.x; regs.pc += 2; CHECK_PAGE_CHANGE;
+#define ABSX_OPT base = MEMREAD16(regs.pc); addr = base+(WORD)regs.x; regs.pc += 2; CHECK_PAGE_CHANGE;
 // Not optimised for page-cross
-#define ABSX_CONST base = *(LPWORD)(mem+regs.pc); addr = base+(WORD)regs.x; regs.pc += 2;
+#define ABSX_CONST base = MEMREAD16(regs.pc); addr = base+(WORD)regs.x; regs.pc += 2;
 
 // Optimised for page-cross
-#define ABSY_OPT base = *(LPWORD)(mem+regs.pc); addr = base+(WORD)regs.y; regs.pc += 2; CHECK_PAGE_CHANGE;
+#define ABSY_OPT base = MEMREAD16(regs.pc); addr = base+(WORD)regs.y; regs.pc += 2; CHECK_PAGE_CHANGE;
 // Not optimised for page-cross
-#define ABSY_CONST base = *(LPWORD)(mem+regs.pc); addr = base+(WORD)regs.y; regs.pc += 2;
+#define ABSY_CONST base = MEMREAD16(regs.pc); addr = base+(WORD)regs.y; regs.pc += 2;
 
 // TODO Optimization Note (just for IABSCMOS): uExtraCycles = ((base & 0xFF) + 1) >> 8;
-#define IABS_CMOS base = *(LPWORD)(mem+regs.pc);	                          \
-		 addr = *(LPWORD)(mem+base);		                  \
+#define IABS_CMOS base = MEMREAD16(regs.pc);	                          \
+		 addr = MEMREAD16(base);		                  \
 		 if ((base & 0xFF) == 0xFF) uExtraCycles=1;		  \
 		 regs.pc += 2;
-#define IABS_NMOS base = *(LPWORD)(mem+regs.pc);	                          \
+#define IABS_NMOS base = MEMREAD16(regs.pc);	                          \
 		 if ((base & 0xFF) == 0xFF)				  \
-		       addr = *(mem+base)+((WORD)*(mem+(base&0xFF00))<<8);\
+		       addr = MEMREAD(base)+((WORD)MEMREAD(base&0xFF00)<<8);\
 		 else                                                   \
-		       addr = *(LPWORD)(mem+base);                        \
+		       addr = MEMREAD16(base);                        \
 		 regs.pc += 2;
 
 #define IMM	 addr = regs.pc++;
 
-#define INDX	 base = ((*(mem+regs.pc++))+regs.x) & 0xFF;          \
+#define INDX	 base = (MEMREAD(regs.pc)+regs.x) & 0xFF; regs.pc++;  \
 		 if (base == 0xFF)                                   \
-		     addr = *(mem+0xFF)+(((WORD)*mem)<<8);           \
+		     addr = MEMREAD(0xFF)+(((WORD)MEMREAD(0))<<8);   \
 		 else                                                \
-		     addr = *(LPWORD)(mem+base);
+		     addr = MEMREAD16(base);
 
 // Optimised for page-cross
-#define INDY_OPT	 if (*(mem+regs.pc) == 0xFF)             /*incurs an extra cycle for page-crossing*/ \
-		     base = *(mem+0xFF)+(((WORD)*mem)<<8);           \
+#define INDY_OPT	 if (MEMREAD(regs.pc) == 0xFF)             /*incurs an extra cycle for page-crossing*/ \
+		     base = MEMREAD(0xFF)+(((WORD)MEMREAD(0))<<8);   \
 		 else                                                \
-		     base = *(LPWORD)(mem+*(mem+regs.pc));           \
+		     base = MEMREAD16(MEMREAD(regs.pc));             \
 		 regs.pc++;                                          \
 		 addr = base+(WORD)regs.y;                           \
 		 CHECK_PAGE_CHANGE;
 // Not optimised for page-cross
-#define INDY_CONST	 if (*(mem+regs.pc) == 0xFF)             /*no extra cycle for page-crossing*/ \
-		     base = *(mem+0xFF)+(((WORD)*mem)<<8);           \
+#define INDY_CONST	 if (MEMREAD(regs.pc) == 0xFF)             /*no extra cycle for page-crossing*/ \
+		     base = MEMREAD(0xFF)+(((WORD)MEMREAD(0))<<8);   \
 		 else                                                \
-		     base = *(LPWORD)(mem+*(mem+regs.pc));           \
+		     base = MEMREAD16(MEMREAD(regs.pc));             \
 		 regs.pc++;                                          \
 		 addr = base+(WORD)regs.y;
 
-#define IZPG	 base = *(mem+regs.pc++);                            \
+#define IZPG	 base = MEMREAD(regs.pc); regs.pc++;                 \
 		 if (base == 0xFF)                                   \
-		     addr = *(mem+0xFF)+(((WORD)*mem)<<8);           \
+		     addr = MEMREAD(0xFF)+(((WORD)MEMREAD(0))<<8);   \
 		 else                                                \
-		     addr = *(LPWORD)(mem+base);
+		     addr = MEMREAD16(base);
 
-#define REL	 addr = (signed char)*(mem+regs.pc++);
+#define REL	 addr = (signed char)MEMREAD(regs.pc); regs.pc++;
 
 // TODO Optimization Note:
 // . Opcodes that generate zero-page addresses can't be accessing $C000..$CFFF
 //   so they could be paired with special READZP/WRITEZP macros (instead of READ/WRITE)
-#define ZPG 	 addr =   *(mem+regs.pc++);
-#define ZPGX	 addr = ((*(mem+regs.pc++))+regs.x) & 0xFF;
-#define ZPGY	 addr = ((*(mem+regs.pc++))+regs.y) & 0xFF;
+#define ZPG 	 addr =   MEMREAD(regs.pc); regs.pc++;
+#define ZPGX	 addr = (MEMREAD(regs.pc)+regs.x) & 0xFF; regs.pc++;
+#define ZPGY	 addr = (MEMREAD(regs.pc)+regs.y) & 0xFF; regs.pc++;
 
 // Tidy 3 char addressing modes to keep the opcode table visually aligned, clean, and readable.
 #undef asl
@@ -0,0 +1,74 @@
+/*
+AppleWin : An Apple //e emulator for Windows
+
+Copyright (C) 1994-1996, Michael O'Brien
+Copyright (C) 1999-2001, Oliver Schmidt
+Copyright (C) 2002-2005, Tom Charlesworth
+Copyright (C) 2006-2019, Tom Charlesworth, Michael Pohoreski
+
+AppleWin is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+AppleWin is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with AppleWin; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+*/
+
+/* Description: IRQ & NMI lines (shared by CPU.cpp & test/TestCPU6502)
+ *
+ * Devices on other threads assert & deassert these, eg. the SSC's CommThread and the SSI263Thread.
+ * So each line is a bitmask (one bit per eIRQSRC) updated with an atomic OR / AND instead of a critical section:
+ * . Interlocked*() functions are full barriers, so device state written before an assert is visible
+ *   to the emulation thread once it sees the IRQ line's bit set
+ * . IRQ() & NMI() just read the volatile bitmasks, which (for VC++) are acquire loads
+ */
+
+// Assume all interrupt sources assert until the device is told to stop:
+// - eg by r/w to device's register or a machine reset
+
+static volatile LONG g_bmIRQ = 0;
+static volatile LONG g_bmNMI = 0;
+static volatile LONG g_bNmiFlank = FALSE; // Positive going flank on NMI line
+
+//===========================================================================
+
+void CpuIrqReset()
+{
+	InterlockedExchange(&g_bmIRQ, 0);
+}
+
+void CpuIrqAssert(eIRQSRC Device)
+{
+	InterlockedOr(&g_bmIRQ, 1<<Device);
+}
+
+void CpuIrqDeassert(eIRQSRC Device)
+{
+	InterlockedAnd(&g_bmIRQ, ~(1<<Device));
+}
+
+//===========================================================================
+
+void CpuNmiReset()
+{
+	InterlockedExchange(&g_bmNMI, 0);
+	InterlockedExchange(&g_bNmiFlank, FALSE);
+}
+
+void CpuNmiAssert(eIRQSRC Device)
+{
+	if (InterlockedOr(&g_bmNMI, 1<<Device) == 0) // NMI line is just becoming active
+		InterlockedExchange(&g_bNmiFlank, TRUE);
+}
+
+void CpuNmiDeassert(eIRQSRC Device)
+{
+	InterlockedAnd(&g_bmNMI, ~(1<<Device));
+}
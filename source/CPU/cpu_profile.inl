@@ -0,0 +1,171 @@
+/*
+AppleWin : An Apple //e emulator for Windows
+
+Copyright (C) 1994-1996, Michael O'Brien
+Copyright (C) 1999-2001, Oliver Schmidt
+Copyright (C) 2002-2005, Tom Charlesworth
+Copyright (C) 2006-2019, Tom Charlesworth, Michael Pohoreski
+
+AppleWin is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+AppleWin is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with AppleWin; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+*/
+
+/* Description: 6502/65C02 loops for the runtime profiler ("PROFILE ON")
+ *
+ * While profiling, CpuExecute() runs these variants of Cpu6502()/Cpu65C02(), which after each opcode (and interrupt):
+ * . add its cycles to a 64K histogram, indexed by the opcode's address
+ * . add its cycles to the current node of a calling-context tree: one node per distinct call path
+ *   - a shadow call stack follows JSR and interrupts (push) and RTS/RTI (pop)
+ *   - each frame remembers the SP to return to, so code that discards its return address (eg. PLA:PLA:JMP) unwinds correctly
+ * Routine totals (inclusive & exclusive) and folded stacks are then built from the tree by the debugger (see ProfileRuntimeSave()).
+ * The breakpoint loops (cpu_breakpoints.inl) also profile, if enabled.
+ */
+
+static const UINT PROFILE_MAX_NODES = 64*1024;
+static const UINT PROFILE_NODE_HASH_SIZE = 2*PROFILE_MAX_NODES;	// Power of 2
+static const UINT PROFILE_MAX_DEPTH = 256;
+
+struct ProfileFrame_t
+{
+	UINT nNode;
+	BYTE nReturnSP;			// SP after the matching RTS/RTI
+};
+
+static bool g_bCpuProfile = false;
+static unsigned __int64* g_pProfileHistogram = NULL;	// [64K]: cycles per opcode address
+static CpuProfileNode* g_pProfileNodes = NULL;			// [PROFILE_MAX_NODES]: node 0 is the root (not in any routine)
+static UINT* g_pProfileNodeHash = NULL;					// [PROFILE_NODE_HASH_SIZE]: (parent, routine) -> node (0 = empty)
+static UINT g_nProfileNodes = 0;
+
+static ProfileFrame_t g_aProfileStack[PROFILE_MAX_DEPTH];
+static UINT g_nProfileDepth = 0;
+static UINT g_nProfileNode = 0;		// Current node: top of the shadow stack, else the root
+
+static WORD g_nProfilePC = 0;		// Address of the opcode being executed
+static ULONG g_uProfileCycles = 0;	// uExecutedCycles at the start of that opcode
+
+static UINT ProfileChildNode(const UINT nParent, const WORD nRoutine)
+{
+	UINT iSlot = ((nParent * 0x9E3779B1) ^ nRoutine) & (PROFILE_NODE_HASH_SIZE-1);
+	while (UINT nNode = g_pProfileNodeHash[iSlot])
+	{
+		if (g_pProfileNodes[nNode].nParent == nParent && g_pProfileNodes[nNode].nRoutine == nRoutine)
+			return nNode;
+		iSlot = (iSlot + 1) & (PROFILE_NODE_HASH_SIZE-1);
+	}
+
+	if (g_nProfileNodes == PROFILE_MAX_NODES)
+		return nParent;		// Full: any new call paths are attributed to the caller
+
+	const UINT nNode = g_nProfileNodes++;
+	g_pProfileNodes[nNode].nParent = nParent;
+	g_pProfileNodes[nNode].nRoutine = nRoutine;
+	g_pProfileNodes[nNode].nCycles = 0;
+	g_pProfileNodes[nNode].nCalls = 0;
+	g_pProfileNodeHash[iSlot] = nNode;
+	return nNode;
+}
+
+// Pop any frames that return to (or below) this SP
+static __forceinline void ProfileUnwind(const BYTE nSP)
+{
+	if (!g_nProfileDepth || g_aProfileStack[g_nProfileDepth-1].nReturnSP > nSP)
+		return;
+
+	do
+		g_nProfileDepth--;
+	while (g_nProfileDepth && g_aProfileStack[g_nProfileDepth-1].nReturnSP <= nSP);
+
+	g_nProfileNode = g_nProfileDepth ? g_aProfileStack[g_nProfileDepth-1].nNode : 0;
+}
+
+// regs.pc is the routine just called
+static void ProfileCall(const BYTE nReturnSP)
+{
+	ProfileUnwind(nReturnSP);	// Frames whose stack has been discarded
+	if (g_nProfileDepth == PROFILE_MAX_DEPTH)
+		return;
+
+	g_nProfileNode = ProfileChildNode(g_nProfileNode, regs.pc);
+	g_pProfileNodes[g_nProfileNode].nCalls++;
+
+	g_aProfileStack[g_nProfileDepth].nNode = g_nProfileNode;
+	g_aProfileStack[g_nProfileDepth].nReturnSP = nReturnSP;
+	g_nProfileDepth++;
+}
+
+static __forceinline void ProfileAddCycles(const ULONG uExecutedCycles)
+{
+	const ULONG uCycles = uExecutedCycles - g_uProfileCycles;
+	g_uProfileCycles = uExecutedCycles;
+
+	g_pProfileHistogram[g_nProfilePC] += uCycles;
+	g_pProfileNodes[g_nProfileNode].nCycles += uCycles;
+}
+
+// After each opcode, before any interrupt
+static __forceinline void ProfileOpcode(const BYTE iOpcode, const ULONG uExecutedCycles)
+{
+	if (GetActiveCpu() == CPU_Z80)
+	{
+		g_uProfileCycles = uExecutedCycles;
+		return;
+	}
+
+	ProfileAddCycles(uExecutedCycles);
+
+	switch (iOpcode)
+	{
+	case 0x20:	// JSR
+		ProfileCall((BYTE)(regs.sp + 2));
+		break;
+	case 0x40:	// RTI
+	case 0x60:	// RTS
+		ProfileUnwind((BYTE)regs.sp);
+		break;
+	}
+
+	g_nProfilePC = regs.pc;
+}
+
+// After NMI() & IRQ(): if either was taken, then the PC is now the handler's
+static __forceinline void ProfileInterrupt(const ULONG uExecutedCycles)
+{
+	if (regs.pc == g_nProfilePC)
+		return;
+
+	ProfileCall((BYTE)(regs.sp + 3));
+	g_nProfilePC = regs.pc;
+	ProfileAddCycles(uExecutedCycles);	// The interrupt's cycles: attributed to the handler
+}
+
+// At the start of each CpuExecute()
+static void ProfileBeginPeriod(void)
+{
+	g_uProfileCycles = 0;
+	g_nProfilePC = regs.pc;
+}
+
+//===========================================================================
+
+#define CPU_PROFILE
+#define Cpu6502 Cpu6502_Profile
+#define Cpu65C02 Cpu65C02_Profile
+
+#include "CPU/cpu6502.h"
+#include "CPU/cpu65C02.h"
+
+#undef Cpu6502
+#undef Cpu65C02
+#undef CPU_PROFILE
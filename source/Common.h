@@ -21,6 +21,9 @@ const DWORD dwClksPerFrame			= uCyclesPerLine * uLinesPerFrame;	// 17030
 
 #define  RAMWORKS			// 8MB RamWorks III support
 //#define  SATURN				// SATURN 128K
+//#define  MEM_NOCOPY_PAGING	// Zero-copy paging: 6502 r/w via memshadow[]/memwrite[], and mem[] is just a linear view
+//#define  DISK_FAST_TRAP		// Disk II: serve DOS 3.3 RWTS & ProDOS driver sector/block calls directly from DO/PO images (needs "enhance disk" speed)
+//#define  CPU_THREADED_DISPATCH	// 6502/65C02: dispatch opcodes via a table of label addresses (computed goto) instead of a switch (GCC/Clang), or a switch without a range check (MSVC)
 
 // Use a base freq so that DirectX (or sound h/w) doesn't have to up/down-sample
 // Assume base freqs are 44.1KHz & 48KHz
@@ -239,6 +239,9 @@ int CPropertySheetHelper::SaveStateSelectImage(HWND hWindow, TCHAR* pszTitle, bo
 		strcpy(szDirectory, g_sCurrentDir);
 
 	//
+
+	const char szAWS_BIN[] = ".aws.bin";	// Binary save-state (see Snapshot_SaveState())
+	const UINT uStrLenBin  = strlen(szAWS_BIN);
 	
 	OPENFILENAME ofn;
 	ZeroMemory(&ofn,sizeof(OPENFILENAME));
@@ -248,12 +251,15 @@ int CPropertySheetHelper::SaveStateSelectImage(HWND hWindow, TCHAR* pszTitle, bo
 	ofn.hInstance       = g_hInstance;
 	if (bSave)
 	{
-		ofn.lpstrFilter = TEXT("Save State files (*.aws.yaml)\0*.aws.yaml\0");
-						  TEXT("All Files\0*.*\0");
+		ofn.lpstrFilter = TEXT("Save State files (*.aws.yaml)\0*.aws.yaml\0")
+						  TEXT("Binary Save State files (*.aws.bin)\0*.aws.bin\0");
+		const UINT uStrLen = strlen(szFilename);
+		if (uStrLen > uStrLenBin && strcmp(&szFilename[uStrLen-uStrLenBin], szAWS_BIN) == 0)
+			ofn.nFilterIndex = 2;	// Keep saving as binary
 	}
 	else
 	{
-		ofn.lpstrFilter = TEXT("Save State files (*.aws,*.aws.yaml)\0*.aws;*.aws.yaml\0");
+		ofn.lpstrFilter = TEXT("Save State files (*.aws,*.aws.yaml,*.aws.bin)\0*.aws;*.aws.yaml;*.aws.bin\0");
 						  TEXT("All Files\0*.*\0");
 	}
 	ofn.lpstrFile       = szFilename;	// Dialog strips the last .EXT from this string (eg. file.aws.yaml is displayed as: file.aws
@@ -266,13 +272,15 @@ int CPropertySheetHelper::SaveStateSelectImage(HWND hWindow, TCHAR* pszTitle, bo
 
 	if(nRes)
 	{
-		if (bSave)	// Only for saving (allow loading of any file for backwards compatibility)
+		const UINT uStrLenFile  = strlen(&szFilename[ofn.nFileOffset]);
+		const bool bBinary = (uStrLenFile > uStrLenBin && strcmp(&szFilename[ofn.nFileOffset+uStrLenFile-uStrLenBin], szAWS_BIN) == 0);
+
+		if (bSave && !bBinary)	// Only for saving (allow loading of any file for backwards compatibility)
 		{
-			// Append .aws.yaml if it's not there
+			// Append .aws.yaml (or .aws.bin) if it's not there
 			const char szAWS_EXT1[] = ".aws";
-			const char szAWS_EXT2[] = ".yaml";
-			const char szAWS_EXT3[] = ".aws.yaml";
-			const UINT uStrLenFile  = strlen(&szFilename[ofn.nFileOffset]);
+			const char* szAWS_EXT2  = (ofn.nFilterIndex == 2) ? ".bin" : ".yaml";
+			const char* szAWS_EXT3  = (ofn.nFilterIndex == 2) ? szAWS_BIN : ".aws.yaml";
 			const UINT uStrLenExt1  = strlen(szAWS_EXT1);
 			const UINT uStrLenExt2  = strlen(szAWS_EXT2);
 			const UINT uStrLenExt3  = strlen(szAWS_EXT3);
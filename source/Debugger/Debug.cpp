@@ -33,10 +33,12 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 
 #include "Debug.h"
 #include "DebugDefs.h"
+#include "Debugger_Trace.h"
 
 #include "../Applewin.h"
 #include "../CPU.h"
 #include "../Disk.h"
+#include "../DiskImageIndex.h"
 #include "../Frame.h"
 #include "../Keyboard.h"
 #include "../Memory.h"
@@ -226,6 +228,8 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 	unsigned __int64 g_nProfileBeginCycles = 0; // g_nCumulativeCycles // PROFILE RESET
 
 	TCHAR g_FileNameProfile[] = TEXT("Profile.txt"); // changed from .csv to .txt since Excel doesn't give import options.
+	TCHAR g_FileNameProfileRoutines[] = TEXT("ProfileRoutines.txt"); // PROFILE ON: routine totals & hot addresses
+	TCHAR g_FileNameProfileStacks  [] = TEXT("ProfileStacks.txt");   // PROFILE ON: folded stacks, eg. for flamegraph.pl
 	int   g_nProfileLine = 0;
 	char  g_aProfileLine[ NUM_PROFILE_LINES ][ CONSOLE_WIDTH ];
 
@@ -233,6 +237,9 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 	bool ProfileSave   ();
 	void ProfileFormat( bool bSeperateColumns, ProfileFormat_e eFormatMode );
 
+	bool ProfileRuntimeSave ();
+	void ProfileRuntimeList ();
+
 	char * ProfileLinePeek ( int iLine );
 	char * ProfileLinePush ();
 	void ProfileLineReset  ();
@@ -806,9 +813,23 @@ Update_t CmdProfile (int nArgs)
 		{
 			ProfileReset();
 			g_bProfiling = 1;
+			if (CpuProfileIsActive())
+				CpuProfileStart();
 			ConsoleBufferPush( TEXT(" Resetting profile data." ) );
 		}
 		else
+		if (iParam == PARAM_ON)
+		{
+			CpuProfileStart();
+			ConsoleBufferPush( TEXT(" Runtime profiler on." ) );
+		}
+		else
+		if (iParam == PARAM_OFF)
+		{
+			CpuProfileStop();
+			ConsoleBufferPush( TEXT(" Runtime profiler off." ) );
+		}
+		else
 		{
 			if ((iParam != PARAM_SAVE) && (iParam != PARAM_LIST))
 				goto _Help;
@@ -842,6 +863,8 @@ Update_t CmdProfile (int nArgs)
 						ConsolePrint( sText );
 					}
 				}
+
+				ProfileRuntimeList();
 			}
 		
 			if (iParam == PARAM_SAVE)
@@ -853,6 +876,17 @@ Update_t CmdProfile (int nArgs)
 				}
 				else
 					ConsoleBufferPush( TEXT(" ERROR: Couldn't save file. (In use?)" ) );
+
+				if (CpuProfileGetHistogram())
+				{
+					if (ProfileRuntimeSave())
+					{
+						TCHAR sText[ CONSOLE_WIDTH ];
+						ConsoleBufferPushFormat ( sText, " Saved: %s, %s", g_FileNameProfileRoutines, g_FileNameProfileStacks );
+					}
+					else
+						ConsoleBufferPush( TEXT(" ERROR: Couldn't save runtime profile. (In use?)" ) );
+				}
 			}
 		}
 	}
@@ -1224,6 +1258,157 @@ void ClearTempBreakpoints ()
 	}
 }
 
+// Run to breakpoint: the CPU loop checks a compiled form of the breakpoints (see cpu_breakpoints.inl)
+//===========================================================================
+
+static CpuBreakpoints g_CpuBreakpoints;
+static bool g_bDebugRunToBreakpoint = false;
+
+// Set nFlags for every address that _CheckBreakpointValue() would match
+static void _CompileBreakpointRange( const Breakpoint_t *pBP, const BYTE nFlags )
+{
+	const int nAddress = pBP->nAddress;
+	const int nEnd = min( nAddress + pBP->nLength, 0x10000 );
+
+	int aRange[2][2] = { {0,0}, {0,0} };	// [begin,end) x2
+
+	switch (pBP->eOperator)
+	{
+		case BP_OP_LESS_EQUAL   : aRange[0][1] = nAddress + 1;	break;
+		case BP_OP_LESS_THAN    : aRange[0][1] = nAddress;		break;
+		case BP_OP_EQUAL        : aRange[0][0] = nAddress; aRange[0][1] = nEnd; break;
+		case BP_OP_NOT_EQUAL    : aRange[0][1] = nAddress; aRange[1][0] = nEnd; aRange[1][1] = 0x10000; break;
+		case BP_OP_GREATER_THAN : aRange[0][0] = nAddress + 1; aRange[0][1] = 0x10000; break;
+		case BP_OP_GREATER_EQUAL: aRange[0][0] = nAddress;     aRange[0][1] = 0x10000; break;
+		default:
+			break;
+	}
+
+	for (int iRange = 0; iRange < 2; iRange++)
+	{
+		for (int nAddr = aRange[iRange][0]; nAddr < aRange[iRange][1]; nAddr++)
+			g_CpuBreakpoints.aAddress[ nAddr ] |= nFlags;
+	}
+}
+
+// Same as CheckBreakpointsReg() for A,X,Y,P,S; but no side-effects (so the CPU loop can call it after every opcode)
+static bool _CheckBreakpointsRegNoPC( void )
+{
+	for (int iBreakpoint = 0; iBreakpoint < MAX_BREAKPOINTS; iBreakpoint++)
+	{
+		Breakpoint_t *pBP = &g_aBreakpoints[iBreakpoint];
+
+		if (! _BreakpointValid( pBP ))
+			continue;
+
+		switch (pBP->eSource)
+		{
+			case BP_SRC_REG_A: if (_CheckBreakpointValue( pBP, regs.a  )) return true; break;
+			case BP_SRC_REG_X: if (_CheckBreakpointValue( pBP, regs.x  )) return true; break;
+			case BP_SRC_REG_Y: if (_CheckBreakpointValue( pBP, regs.y  )) return true; break;
+			case BP_SRC_REG_P: if (_CheckBreakpointValue( pBP, regs.ps )) return true; break;
+			case BP_SRC_REG_S: if (_CheckBreakpointValue( pBP, regs.sp )) return true; break;
+			default:
+				break;
+		}
+	}
+
+	return false;
+}
+
+// NB. Cheap enough to do for every execution period, so changes to the breakpoints can't go stale
+static void CompileBreakpoints ()
+{
+	memset( g_CpuBreakpoints.aAddress, 0, sizeof(g_CpuBreakpoints.aAddress) );
+	memset( g_CpuBreakpoints.aOpcode, 0, sizeof(g_CpuBreakpoints.aOpcode) );
+	g_CpuBreakpoints.pfnCheckRegs = NULL;
+	g_CpuBreakpoints.bTrace = TraceFile_IsOpen();
+
+	for (int iBreakpoint = 0; iBreakpoint < MAX_BREAKPOINTS; iBreakpoint++)
+	{
+		Breakpoint_t *pBP = &g_aBreakpoints[iBreakpoint];
+
+		if (! _BreakpointValid( pBP ))
+			continue;
+
+		switch (pBP->eSource)
+		{
+			case BP_SRC_REG_PC:
+				_CompileBreakpointRange( pBP, CPU_BREAK_EXEC );
+				break;
+			case BP_SRC_MEM_1:
+				_CompileBreakpointRange( pBP, CPU_BREAK_READ | CPU_BREAK_WRITE );
+				break;
+			case BP_SRC_REG_A:
+			case BP_SRC_REG_X:
+			case BP_SRC_REG_Y:
+			case BP_SRC_REG_P:
+			case BP_SRC_REG_S:
+				g_CpuBreakpoints.pfnCheckRegs = _CheckBreakpointsRegNoPC;
+				break;
+			default:
+				break;
+		}
+	}
+
+	if (g_nDebugStepUntil >= 0)
+		g_CpuBreakpoints.aAddress[ (WORD) g_nDebugStepUntil ] |= CPU_BREAK_EXEC;
+
+	// Opcodes that CheckBreakOpcode() would stop on
+	for (int iOpcode = 0; iOpcode < 256; iOpcode++)
+	{
+		if (iOpcode == 0x00 && ((g_nDebugBreakOnInvalid >> AM_IMPLIED) & 1))	// BRK
+			g_CpuBreakpoints.aOpcode[ iOpcode ] = true;
+
+		if (g_aOpcodes[iOpcode].sMnemonic[0] >= 'a' && ((g_nDebugBreakOnInvalid >> AM_1) & 1))
+			g_CpuBreakpoints.aOpcode[ iOpcode ] = true;
+
+		if (g_iDebugBreakOnOpcode && g_iDebugBreakOnOpcode == iOpcode)
+			g_CpuBreakpoints.aOpcode[ iOpcode ] = true;
+	}
+}
+
+// Only "G" (without a skip range) or "GG", and not when tracing to a text file or profiling: these need every opcode
+static bool CanRunToBreakpoint ()
+{
+	return g_nDebugSteps < 0
+		&& g_nDebugSkipLen <= 0
+		&& !g_hTraceFile
+		&& !g_bProfiling
+		&& GetActiveCpu() != CPU_Z80;
+}
+
+// Execute a whole execution period (or until a breakpoint) in one call to SingleStep()
+// . returns the BP_HIT_* flags, as per CheckBreakpointsIO() | CheckBreakpointsReg()
+static int RunToBreakpoint ()
+{
+	CompileBreakpoints();
+	CpuSetBreakpoints( &g_CpuBreakpoints );
+	g_bDebugRunToBreakpoint = true;
+
+	SingleStep(g_bGoCmd_ReinitFlag);
+	g_bGoCmd_ReinitFlag = false;
+
+	g_bDebugRunToBreakpoint = false;
+	CpuSetBreakpoints( NULL );
+
+	WORD nAddress;
+	const BYTE nHit = CpuGetBreakpointHit( nAddress );
+
+	int bBreakpointHit = BP_HIT_NONE;
+
+	if (nHit & (CPU_BREAK_READ | CPU_BREAK_WRITE))
+	{
+		g_uBreakMemoryAddress = nAddress;
+		bBreakpointHit |= BP_HIT_MEM;
+	}
+
+	if (nHit & (CPU_BREAK_EXEC | CPU_BREAK_REG))
+		bBreakpointHit |= CheckBreakpointsReg();	// NB. Also clears any temp breakpoint
+
+	return bBreakpointHit;
+}
+
 //===========================================================================
 Update_t CmdBreakpoint (int nArgs)
 {
@@ -2010,6 +2195,32 @@ Update_t CmdTrace (int nArgs)
 	return UPDATE_ALL; // TODO: Verify // 0
 }
 
+//===========================================================================
+// Add a record for the opcode at regs.pc to the binary trace file (if open)
+// . NB. The CPU adds these itself when running to a breakpoint (see CompileBreakpoints())
+static void TraceFileAddRecord ()
+{
+	if (!TraceFile_IsOpen() || GetActiveCpu() == CPU_Z80)
+		return;
+
+	// Read the opcode bytes as the disassembler does (see _6502_GetOpmodeOpbyte()), from the 'mem' view
+	// . for MEM_NOCOPY_PAGING, first make sure that view is current (keeping any edits made by the debugger)
+	MemUpdateLinearImage();
+
+	TraceRecord_t record;
+	record.nPC = regs.pc;
+	for (int iByte = 0; iByte < 3; iByte++)
+		record.aOpcode[iByte] = *(mem + (WORD)(regs.pc + iByte));
+	record.nA = regs.a;
+	record.nX = regs.x;
+	record.nY = regs.y;
+	record.nP = regs.ps;
+	record.nS = (BYTE) regs.sp;
+	record.nReserved[0] = record.nReserved[1] = 0;
+
+	TraceFile_Add( record, g_nCumulativeCycles );
+}
+
 //===========================================================================
 Update_t CmdTraceFile (int nArgs)
 {
@@ -2022,8 +2233,18 @@ Update_t CmdTraceFile (int nArgs)
 
 		ConsoleBufferPush( "Trace stopped." );
 	}
+	else if (TraceFile_IsOpen())
+	{
+		ConsoleBufferPushFormat( sText, "Trace stopped: %I64u instructions.", TraceFile_GetNumRecords() );
+		TraceFile_Close();
+	}
 	else
 	{
+		// TF [filename]         : text trace
+		// TF filename <any arg> : text trace, with video scanner info
+		// TF filename.bin       : binary trace (see TraceDisasm to disassemble it)
+		g_bTraceFileWithVideoScanner = (nArgs >= 2);
+
 		char sFileName[MAX_PATH];
 
 		if (nArgs)
@@ -2031,12 +2252,30 @@ Update_t CmdTraceFile (int nArgs)
 		else
 			strcpy( sFileName, g_sFileNameTrace );
 
-		g_bTraceFileWithVideoScanner = (nArgs >= 2);
+		const size_t nLen = strlen( sFileName );
+		const bool bBinary = !g_bTraceFileWithVideoScanner
+			&& (nLen >= 4) && (_stricmp( sFileName + nLen - 4, ".bin" ) == 0);
 
 		char sFilePath[ MAX_PATH ];
 		strcpy(sFilePath, g_sCurrentDir); // TODO: g_sDebugDir
 		strcat(sFilePath, sFileName );
 
+		if (bBinary)
+		{
+			if (TraceFile_Open( sFilePath, GetMainCpu(), g_nCumulativeCycles ))
+			{
+				ConsoleBufferPushFormat( sText, "Trace started: %s", sFilePath );
+				TraceFileAddRecord();
+			}
+			else
+			{
+				ConsoleBufferPushFormat( sText, "Trace ERROR: %s", sFilePath );
+			}
+
+			ConsoleBufferToDisplay();
+			return UPDATE_ALL;
+		}
+
 		g_hTraceFile = fopen( sFilePath, "wt" );
 
 		if (g_hTraceFile)
@@ -3738,6 +3977,33 @@ Update_t CmdDisk ( int nArgs)
 		return ConsoleUpdate();
 	}
 
+	if (iParam == PARAM_DISK_INDEX)
+	{
+		if (nArgs > 2)
+			goto _Help;
+
+		// DISK INDEX ["Directory"]: list the images found by -index (or opened since), under Directory if given
+		LPCTSTR pszDirectory = (nArgs == 2) ? g_aArgs[ 2 ].sArg : NULL;
+
+		std::vector<ImageIndexEntry> vecEntries;
+		const UINT uNumFloppy = ImageIndexGetEntries( pszDirectory, true, vecEntries );
+		const UINT uNumHardDisk = ImageIndexGetEntries( pszDirectory, false, vecEntries );
+
+		char buffer[CONSOLE_WIDTH] = "";
+		for (UINT i = 0; i < vecEntries.size(); i++)
+		{
+			const char* pszPathname = vecEntries[i].strPathname.c_str();
+			const char* pszName = strrchr(pszPathname, '\\');
+			ConsoleBufferPushFormat(buffer, "%s %5uK %s",
+				vecEntries[i].bFloppy ? "D" : "H",
+				vecEntries[i].uImageSize / 1024,
+				pszName ? pszName+1 : pszPathname);
+		}
+
+		ConsoleBufferPushFormat(buffer, "%u floppy, %u harddisk image(s)", uNumFloppy, uNumHardDisk);
+		return ConsoleUpdate();
+	}
+
 	if (nArgs < 2)
 		goto _Help;
 
@@ -6694,7 +6960,7 @@ bool ParseAssemblyListing( bool bBytesToMemory, bool bAddSymbols )
 					{
 						char *pAddressEnd;
 						nAddress = (DWORD) strtol( pAddress, &pAddressEnd, 16 );
-						g_aSymbols[ SYMBOLS_SRC_2 ][ (WORD) nAddress] = sName;
+						SymbolTableAdd( SYMBOLS_SRC_2, (WORD) nAddress, sName );
 						g_nSourceAssemblySymbols++;
 					}
 				}
@@ -8456,6 +8722,205 @@ bool ProfileSave()
 }
 
 
+// Runtime profiler _______________________________________________________________________________
+
+//===========================================================================
+static const char* ProfileRuntimeGetName( WORD nAddress, char* pName_ )
+{
+	const char* pSymbol = FindSymbolFromAddress( nAddress );
+	if (pSymbol)
+		return pSymbol;
+
+	sprintf( pName_, "$%04X", nAddress );
+	return pName_;
+}
+
+// Totals per routine (from the CPU's calling-context tree), sorted by inclusive cycles
+// Returns the total cycles profiled
+//===========================================================================
+static Profile_t ProfileRuntimeGetRoutines( std::vector<ProfileRoutine_t> & vRoutines_ )
+{
+	const CpuProfileNode* pNodes;
+	const UINT nNodes = CpuProfileGetNodes( pNodes );
+
+	std::vector<ProfileRoutine_t> vAll( 64*1024 );
+	std::vector<UINT>             vLastNode( 64*1024, 0 ); // Node whose cycles were last added to this routine's inclusive total
+	Profile_t                     nTotal = 0;
+
+	for (UINT iNode = 0; iNode < nNodes; iNode++)
+	{
+		const CpuProfileNode& node = pNodes[ iNode ];
+		nTotal += (Profile_t) node.nCycles;
+
+		if (iNode == 0) // Root: not in any routine
+			continue;
+
+		ProfileRoutine_t & routine = vAll[ node.nRoutine ];
+		routine.m_nExclusive += (Profile_t) node.nCycles;
+		routine.m_nCalls     += node.nCalls;
+
+		if (! node.nCycles)
+			continue;
+
+		// Inclusive: add once to each routine on this call path (even if it's recursive)
+		for (UINT iPath = iNode; iPath != 0; iPath = pNodes[ iPath ].nParent)
+		{
+			const WORD nRoutine = pNodes[ iPath ].nRoutine;
+			if (vLastNode[ nRoutine ] != iNode)
+			{
+				vLastNode[ nRoutine ] = iNode;
+				vAll[ nRoutine ].m_nInclusive += (Profile_t) node.nCycles;
+			}
+		}
+	}
+
+	vRoutines_.clear();
+	for (UINT nAddress = 0; nAddress < 64*1024; nAddress++)
+	{
+		if (vAll[ nAddress ].m_nCalls || vAll[ nAddress ].m_nInclusive)
+		{
+			vAll[ nAddress ].m_nAddress = (WORD) nAddress;
+			vRoutines_.push_back( vAll[ nAddress ] );
+		}
+	}
+
+	std::sort( vRoutines_.begin(), vRoutines_.end(), ProfileRoutine_t() );
+	return nTotal;
+}
+
+//===========================================================================
+static void ProfileRuntimeSaveStacks( FILE *hFile )
+{
+	const CpuProfileNode* pNodes;
+	const UINT nNodes = CpuProfileGetNodes( pNodes );
+
+	std::vector<UINT> vPath;
+	char sName[ 8 ];
+
+	for (UINT iNode = 0; iNode < nNodes; iNode++)
+	{
+		if (! pNodes[ iNode ].nCycles)
+			continue;
+
+		vPath.clear();
+		for (UINT iPath = iNode; iPath != 0; iPath = pNodes[ iPath ].nParent)
+			vPath.push_back( iPath );
+
+		// Outermost first: (top);caller;...;routine cycles
+		fputs( "(top)", hFile );
+		for (int iFrame = (int)vPath.size() - 1; iFrame >= 0; iFrame--)
+			fprintf( hFile, ";%s", ProfileRuntimeGetName( pNodes[ vPath[ iFrame ] ].nRoutine, sName ) );
+
+		fprintf( hFile, " %I64u\n", pNodes[ iNode ].nCycles );
+	}
+}
+
+//===========================================================================
+bool ProfileRuntimeSave ()
+{
+	char sFilename[MAX_PATH];
+	char sName[ 8 ];
+
+	// Routines & hot addresses
+	strcpy( sFilename, g_sProgramDir );
+	strcat( sFilename, g_FileNameProfileRoutines );
+
+	FILE *hFile = fopen( sFilename, "wt" );
+	if (! hFile)
+		return false;
+
+	std::vector<ProfileRoutine_t> vRoutines;
+	const Profile_t nTotal = ProfileRuntimeGetRoutines( vRoutines );
+	const Profile_t nPercent = nTotal ? (100.0 / nTotal) : 0.0;
+
+	fprintf( hFile, "Cycles\t%.0f\n\n", nTotal );
+
+	fprintf( hFile, "Inclusive\t%%\tExclusive\t%%\tCalls\tAddress\tRoutine\n" );
+	for (size_t iRoutine = 0; iRoutine < vRoutines.size(); iRoutine++)
+	{
+		const ProfileRoutine_t & routine = vRoutines[ iRoutine ];
+		fprintf( hFile, "%.0f\t%.2f\t%.0f\t%.2f\t%u\t$%04X\t%s\n"
+			, routine.m_nInclusive, routine.m_nInclusive * nPercent
+			, routine.m_nExclusive, routine.m_nExclusive * nPercent
+			, routine.m_nCalls
+			, routine.m_nAddress
+			, ProfileRuntimeGetName( routine.m_nAddress, sName )
+		);
+	}
+
+	const unsigned __int64* pHistogram = CpuProfileGetHistogram();
+	std::vector<ProfileAddress_t> vAddresses;
+	for (UINT nAddress = 0; nAddress < 64*1024; nAddress++)
+	{
+		if (pHistogram[ nAddress ])
+		{
+			ProfileAddress_t address;
+			address.m_nAddress = (WORD) nAddress;
+			address.m_nCycles  = (Profile_t) pHistogram[ nAddress ];
+			vAddresses.push_back( address );
+		}
+	}
+	std::sort( vAddresses.begin(), vAddresses.end(), ProfileAddress_t() );
+
+	fprintf( hFile, "\nCycles\t%%\tAddress\tSymbol\n" );
+	for (size_t iAddress = 0; iAddress < vAddresses.size(); iAddress++)
+	{
+		const char* pSymbol = FindSymbolFromAddress( vAddresses[ iAddress ].m_nAddress );
+		fprintf( hFile, "%.0f\t%.2f\t$%04X\t%s\n"
+			, vAddresses[ iAddress ].m_nCycles, vAddresses[ iAddress ].m_nCycles * nPercent
+			, vAddresses[ iAddress ].m_nAddress
+			, pSymbol ? pSymbol : ""
+		);
+	}
+
+	fclose( hFile );
+
+	// Folded stacks
+	strcpy( sFilename, g_sProgramDir );
+	strcat( sFilename, g_FileNameProfileStacks );
+
+	hFile = fopen( sFilename, "wt" );
+	if (! hFile)
+		return false;
+
+	ProfileRuntimeSaveStacks( hFile );
+	fclose( hFile );
+
+	return true;
+}
+
+// Top routines, by inclusive cycles
+//===========================================================================
+void ProfileRuntimeList ()
+{
+	if (! CpuProfileGetHistogram())
+		return;
+
+	const int NUM_PROFILE_ROUTINES_LISTED = 16;
+
+	char sText[ CONSOLE_WIDTH ];
+	char sName[ 8 ];
+
+	std::vector<ProfileRoutine_t> vRoutines;
+	const Profile_t nTotal = ProfileRuntimeGetRoutines( vRoutines );
+	const Profile_t nPercent = nTotal ? (100.0 / nTotal) : 0.0;
+
+	ConsoleBufferPushFormat( sText, " Runtime profile%s: %.0f cycles", CpuProfileIsActive() ? "" : " (off)", nTotal );
+	ConsoleBufferPush( TEXT("   Incl%  Excl%     Calls  Routine") );
+
+	for (size_t iRoutine = 0; iRoutine < vRoutines.size() && iRoutine < NUM_PROFILE_ROUTINES_LISTED; iRoutine++)
+	{
+		const ProfileRoutine_t & routine = vRoutines[ iRoutine ];
+		ConsoleBufferPushFormat( sText, "  %6.2f %6.2f %9u  %s"
+			, routine.m_nInclusive * nPercent
+			, routine.m_nExclusive * nPercent
+			, routine.m_nCalls
+			, ProfileRuntimeGetName( routine.m_nAddress, sName )
+		);
+	}
+}
+
+
 static void InitDisasm(void)
 {
 	g_nDisasmCurAddress = regs.pc;
@@ -8524,7 +8989,7 @@ void DebugBegin ()
 //===========================================================================
 void DebugExitDebugger ()
 {
-	if (g_nBreakpoints == 0 && g_hTraceFile == NULL)
+	if (g_nBreakpoints == 0 && g_hTraceFile == NULL && !TraceFile_IsOpen())
 	{
 		DebugEnd();
 		return;
@@ -8615,11 +9080,17 @@ void DebugContinueStepping ()
 			}
 		}
 
-		if (bDoSingleStep)
+		if (bDoSingleStep && CanRunToBreakpoint())
+		{
+			g_bDebugBreakpointHit |= RunToBreakpoint();
+		}
+		else if (bDoSingleStep)
 		{
 			SingleStep(g_bGoCmd_ReinitFlag);
 			g_bGoCmd_ReinitFlag = false;
 
+			TraceFileAddRecord();
+
 			g_bDebugBreakpointHit |= CheckBreakpointsIO() | CheckBreakpointsReg();
 		}
 
@@ -8729,6 +9200,8 @@ static void DebugEnd ()
 		g_hTraceFile = NULL;
 	}
 
+	TraceFile_Close();
+
 	g_vMemorySearchResults.erase( g_vMemorySearchResults.begin(), g_vMemorySearchResults.end() );
 
 	g_nAppMode = MODE_RUNNING;
@@ -9836,3 +10309,9 @@ bool IsDebugSteppingAtFullSpeed(void)
 {
 	return (g_nAppMode == MODE_STEPPING) && g_bDebugFullSpeed;
 }
+
+// True while the CPU loop is running to a breakpoint, ie. executing a whole execution period per SingleStep()
+bool IsDebugRunningToBreakpoint(void)
+{
+	return g_bDebugRunToBreakpoint;
+}
@@ -149,6 +149,7 @@
 	bool FindAddressFromSymbol( const char* pSymbol, WORD * pAddress_ = NULL, int * iTable_ = NULL );
 	WORD GetAddressFromSymbol( const char* symbol); // HACK: returns 0 if symbol not found
 	void SymbolUpdate( SymbolTable_Index_e eSymbolTable, char *pSymbolName, WORD nAddrss, bool bRemoveSymbol, bool bUpdateSymbol );
+	void SymbolTableAdd( SymbolTable_Index_e eSymbolTable, WORD nAddress, const char* pSymbolName );
 
 	const char* FindSymbolFromAddress( WORD nAdress, int * iTable_ = NULL );
 	const char* GetSymbol( WORD nAddress, int nBytes);
@@ -181,3 +182,4 @@
 	void	DebuggerMouseClick( int x, int y );
 
 	bool	IsDebugSteppingAtFullSpeed(void);
+	bool	IsDebugRunningToBreakpoint(void);
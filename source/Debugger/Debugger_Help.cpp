@@ -910,12 +910,16 @@ Update_t CmdHelpSpecific (int nArgs)
 			ConsoleBufferPush( TEXT("  Output a byte or word to the IO address $C0xx" ) );
 			break;
 		case CMD_PROFILE:
-			ConsoleColorizePrintFormat( sTemp, sText, " Usage: [%s | %s | %s]"
+			ConsoleColorizePrintFormat( sTemp, sText, " Usage: [%s | %s | %s | %s | %s]"
 				, g_aParameters[ PARAM_RESET ].m_sName
 				, g_aParameters[ PARAM_SAVE  ].m_sName
 				, g_aParameters[ PARAM_LIST  ].m_sName
+				, g_aParameters[ PARAM_ON    ].m_sName
+				, g_aParameters[ PARAM_OFF   ].m_sName
 			);
 			ConsoleBufferPush( " No arguments resets the profile." );
+			ConsoleBufferPush( " ON/OFF: runtime profiler, at full speed: cycles per address & per routine (via JSR/RTS)" );
+			ConsoleBufferPush( " SAVE also writes ProfileRoutines.txt & ProfileStacks.txt (folded, for flame graphs)" );
 			break;
 	// Registers
 		case CMD_REGISTER_SET:
@@ -956,6 +960,10 @@ Update_t CmdHelpSpecific (int nArgs)
 			break;
 		case CMD_TRACE_FILE:
 			ConsoleColorizePrint( sText, " Usage: \"[filename]\" [v]" );
+			ConsoleBufferPush( "  Text trace (default: Trace.txt)" );
+			ConsoleBufferPush( "  v: with video scanner info" );
+			ConsoleBufferPush( "  filename.bin: binary trace, for TraceDisasm" );
+			ConsoleBufferPush( "  TF again stops the trace" );
 			break;
 		case CMD_TRACE_LINE:
 			ConsoleColorizePrint( sText, " Usage: [#]" );
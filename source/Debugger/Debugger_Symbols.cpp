@@ -72,6 +72,32 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 	SymbolTable_t g_aSymbols[ NUM_SYMBOL_TABLES ];
 	int           g_nSymbolsLoaded = 0;  // on Last Load
 
+// Symbol Index ___________________________________________________________________________________
+
+	// All the displayed symbol tables combined, for O(1) lookups in both directions:
+	// . address -> symbol ID, for the highest table with a symbol at that address (User symbols are searched first)
+	// . name -> symbol ID via a case-insensitive hash, for the highest table, then the lowest address, with that name
+	// . names are interned into fixed-size blocks, so a name returned stays valid until the index is rebuilt
+	// Adding a symbol updates the index; removing symbols or enabling/disabling tables rebuilds it on the next lookup.
+	// See: SymbolTableAdd(), _SymbolIndexInvalidate()
+
+	struct SymbolIndexEntry_t
+	{
+		const char* pName;
+		WORD        nAddress;
+		int         iTable;
+	};
+
+	static const UINT SYMBOL_NAME_BLOCK_SIZE = 64*1024;
+
+	static std::vector<SymbolIndexEntry_t> g_vSymbolIndex; // [0] unused: symbol ID 0 is "no symbol"
+	static UINT                g_aSymbolAddressIndex[ 64*1024 ]; // symbol ID
+	static std::vector<UINT>   g_vSymbolNameHash; // symbol ID (0 = empty slot), open addressing, size is a power of 2
+	static UINT                g_nSymbolNameHashUsed = 0;
+	static std::vector<char*>  g_vSymbolNameBlocks;
+	static UINT                g_nSymbolNameBlockUsed = SYMBOL_NAME_BLOCK_SIZE;
+	static bool                g_bSymbolIndexValid = false;
+
 // Utils _ ________________________________________________________________________________________
 
 	void      _CmdSymbolsInfoHeader( int iTable, char * pText, int nDisplaySize = 0 );
@@ -81,6 +107,148 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 
 // Private ________________________________________________________________________________________
 
+//===========================================================================
+static UINT _SymbolNameHash( const char* pName )
+{
+	// FNV-1a, case-insensitive
+	UINT nHash = 2166136261u;
+	while (*pName)
+	{
+		nHash ^= (BYTE) toupper( *pName++ );
+		nHash *= 16777619u;
+	}
+	return nHash;
+}
+
+// Returns the hash slot for this name: holding its symbol ID, else the (empty) slot to add it in
+static UINT& _SymbolNameHashSlot( const char* pName )
+{
+	const UINT nMask = (UINT) g_vSymbolNameHash.size() - 1;
+	UINT iSlot = _SymbolNameHash( pName ) & nMask;
+	while (g_vSymbolNameHash[ iSlot ] && _tcsicmp( g_vSymbolIndex[ g_vSymbolNameHash[ iSlot ] ].pName, pName ))
+		iSlot = (iSlot + 1) & nMask;
+
+	return g_vSymbolNameHash[ iSlot ];
+}
+
+static void _SymbolNameHashResize( UINT nSize )
+{
+	std::vector<UINT> vOld;
+	vOld.swap( g_vSymbolNameHash );
+	g_vSymbolNameHash.assign( nSize, 0 );
+
+	for (size_t iSlot = 0; iSlot < vOld.size(); iSlot++)
+	{
+		if (vOld[ iSlot ])
+			_SymbolNameHashSlot( g_vSymbolIndex[ vOld[ iSlot ] ].pName ) = vOld[ iSlot ];
+	}
+}
+
+static const char* _SymbolNameCopy( const char* pName )
+{
+	const UINT nLen = (UINT) strlen( pName ) + 1;
+	if (g_nSymbolNameBlockUsed + nLen > SYMBOL_NAME_BLOCK_SIZE)
+	{
+		g_vSymbolNameBlocks.push_back( new char[ SYMBOL_NAME_BLOCK_SIZE ] );
+		g_nSymbolNameBlockUsed = 0;
+	}
+
+	char* pCopy = g_vSymbolNameBlocks.back() + g_nSymbolNameBlockUsed;
+	memcpy( pCopy, pName, nLen );
+	g_nSymbolNameBlockUsed += nLen;
+	return pCopy;
+}
+
+//===========================================================================
+static void _SymbolIndexAdd( int iTable, WORD nAddress, const char* pName )
+{
+	if ((g_nSymbolNameHashUsed + 1) * 2 > g_vSymbolNameHash.size())
+		_SymbolNameHashResize( (UINT) g_vSymbolNameHash.size() * 2 );
+
+	UINT& nNameSlot = _SymbolNameHashSlot( pName );
+	const UINT nPrevID = nNameSlot;
+
+	SymbolIndexEntry_t entry;
+	entry.pName    = (nPrevID && !strcmp( g_vSymbolIndex[ nPrevID ].pName, pName ))
+		? g_vSymbolIndex[ nPrevID ].pName // intern
+		: _SymbolNameCopy( pName );
+	entry.nAddress = nAddress;
+	entry.iTable   = iTable;
+
+	const UINT nID = (UINT) g_vSymbolIndex.size();
+	g_vSymbolIndex.push_back( entry );
+
+	if (! nPrevID)
+	{
+		nNameSlot = nID;
+		g_nSymbolNameHashUsed++;
+	}
+	else
+	{
+		const SymbolIndexEntry_t& prev = g_vSymbolIndex[ nPrevID ];
+		if ((prev.iTable < iTable) || (prev.iTable == iTable && nAddress < prev.nAddress))
+			nNameSlot = nID;
+	}
+
+	const UINT nPrevAddressID = g_aSymbolAddressIndex[ nAddress ];
+	if (!nPrevAddressID || g_vSymbolIndex[ nPrevAddressID ].iTable <= iTable)
+		g_aSymbolAddressIndex[ nAddress ] = nID;
+}
+
+//===========================================================================
+static void _SymbolIndexRebuild()
+{
+	for (size_t iBlock = 0; iBlock < g_vSymbolNameBlocks.size(); iBlock++)
+		delete [] g_vSymbolNameBlocks[ iBlock ];
+	g_vSymbolNameBlocks.clear();
+	g_nSymbolNameBlockUsed = SYMBOL_NAME_BLOCK_SIZE;
+
+	size_t nSymbols = 0;
+	for (int iTable = 0; iTable < NUM_SYMBOL_TABLES; iTable++)
+	{
+		if (g_bDisplaySymbolTables & (1 << iTable))
+			nSymbols += g_aSymbols[ iTable ].size();
+	}
+
+	UINT nHashSize = 1024;
+	while (nHashSize < nSymbols * 2)
+		nHashSize <<= 1;
+
+	g_vSymbolIndex.clear();
+	g_vSymbolIndex.reserve( nSymbols + 1 );
+	g_vSymbolIndex.push_back( SymbolIndexEntry_t() );
+	memset( g_aSymbolAddressIndex, 0, sizeof(g_aSymbolAddressIndex) );
+	g_vSymbolNameHash.assign( nHashSize, 0 );
+	g_nSymbolNameHashUsed = 0;
+
+	// Highest table first, so that each table only has to beat lower tables
+	for (int iTable = NUM_SYMBOL_TABLES; iTable-- > 0; )
+	{
+		if (! (g_bDisplaySymbolTables & (1 << iTable)))
+			continue;
+
+		SymbolTable_t :: iterator  iSymbol = g_aSymbols[iTable].begin();
+		while (iSymbol != g_aSymbols[iTable].end())
+		{
+			_SymbolIndexAdd( iTable, iSymbol->first, iSymbol->second.c_str() );
+			++iSymbol;
+		}
+	}
+
+	g_bSymbolIndexValid = true;
+}
+
+static void _SymbolIndexInvalidate()
+{
+	g_bSymbolIndexValid = false;
+}
+
+static void _SymbolIndexUpdate()
+{
+	if (! g_bSymbolIndexValid)
+		_SymbolIndexRebuild();
+}
+
 //===========================================================================
 void _PrintCurrentPath()
 {
@@ -142,60 +310,55 @@ int GetSymbolTableFromCommand()
 //===========================================================================
 const char* FindSymbolFromAddress (WORD nAddress, int * iTable_ )
 {
-	// Bugfix/User feature: User symbols should be searched first
-	int iTable = NUM_SYMBOL_TABLES;
-	while (iTable-- > 0)
-	{
-		if (! g_aSymbols[iTable].size())
-			continue;
+	// Bugfix/User feature: User symbols should be searched first (see: _SymbolIndexAdd)
+	_SymbolIndexUpdate();
 
-		if (! (g_bDisplaySymbolTables & (1 << iTable)))
-			continue;
+	const UINT nID = g_aSymbolAddressIndex[ nAddress ];
+	if (! nID)
+		return NULL;
 
-		std::map<WORD, std::string>::iterator iSymbols = g_aSymbols[iTable].find(nAddress);
-		if(g_aSymbols[iTable].find(nAddress) != g_aSymbols[iTable].end())
-		{
-			if (iTable_)
-			{
-				*iTable_ = iTable;
-			}
-			return iSymbols->second.c_str();
-		}
-	}	
-	return NULL;	
+	if (iTable_)
+	{
+		*iTable_ = g_vSymbolIndex[ nID ].iTable;
+	}
+	return g_vSymbolIndex[ nID ].pName;
 }
 
 //===========================================================================
 bool FindAddressFromSymbol ( const char* pSymbol, WORD * pAddress_, int * iTable_ )
 {
-	// Bugfix/User feature: User symbols should be searched first
-	for (int iTable = NUM_SYMBOL_TABLES; iTable-- > 0; )
-	{
-		if (! g_aSymbols[iTable].size())
-			continue;
+	// Bugfix/User feature: User symbols should be searched first (see: _SymbolIndexAdd)
+	_SymbolIndexUpdate();
 
-		if (! (g_bDisplaySymbolTables & (1 << iTable)))
-			continue;
+	const UINT nID = _SymbolNameHashSlot( pSymbol );
+	if (! nID)
+		return false;
 
-		SymbolTable_t :: iterator  iSymbol = g_aSymbols[iTable].begin();
-		while (iSymbol != g_aSymbols[iTable].end())
-		{
-			if (!_tcsicmp( iSymbol->second.c_str(), pSymbol))
-			{
-				if (pAddress_)
-				{
-					*pAddress_ = iSymbol->first;
-				}
-				if (iTable_)
-				{
-					*iTable_ = iTable;
-				}
-				return true;
-			}
-			iSymbol++;
-		}
+	if (pAddress_)
+	{
+		*pAddress_ = g_vSymbolIndex[ nID ].nAddress;
 	}
-	return false;
+	if (iTable_)
+	{
+		*iTable_ = g_vSymbolIndex[ nID ].iTable;
+	}
+	return true;
+}
+
+//===========================================================================
+// Add (or replace) a symbol, keeping the symbol index up to date
+void SymbolTableAdd ( SymbolTable_Index_e eSymbolTable, WORD nAddress, const char* pSymbolName )
+{
+	SymbolTable_t& table = g_aSymbols[ eSymbolTable ];
+	const bool bReplace = (table.find( nAddress ) != table.end());
+
+	table[ nAddress ] = pSymbolName;
+
+	if (bReplace)
+		_SymbolIndexInvalidate(); // old name is still indexed
+	else
+	if (g_bSymbolIndexValid && (g_bDisplaySymbolTables & (1 << eSymbolTable)))
+		_SymbolIndexAdd( eSymbolTable, nAddress, table[ nAddress ].c_str() );
 }
 
 
@@ -737,7 +900,7 @@ int ParseSymbolTable( TCHAR *pPathFileName, SymbolTable_Index_e eSymbolTableWrit
 	
 			// else // It is not a bug to have duplicate addresses by different names
 
-			g_aSymbols[ eSymbolTableWrite ] [ (WORD) nAddress ] = sName;
+			SymbolTableAdd( eSymbolTableWrite, (WORD) nAddress, sName );
 			nSymbolsLoaded++; // TODO: FIXME: BUG: This is the total symbols read, not added
 		}
 		fclose(hFile);
@@ -825,6 +988,7 @@ Update_t CmdSymbolsLoad (int nArgs)
 Update_t _CmdSymbolsClear( SymbolTable_Index_e eSymbolTable )
 {
 	g_aSymbols[ eSymbolTable ].clear();
+	_SymbolIndexInvalidate();
 	
 	return UPDATE_SYMBOLS;
 }
@@ -852,6 +1016,7 @@ void SymbolUpdate( SymbolTable_Index_e eSymbolTable, char *pSymbolName, WORD nAd
 				}
 
 				g_aSymbols[ eSymbolTable ].erase( nAddressPrev );
+				_SymbolIndexInvalidate();
 
 				if (bUpdateSymbol)
 				{
@@ -883,7 +1048,7 @@ void SymbolUpdate( SymbolTable_Index_e eSymbolTable, char *pSymbolName, WORD nAd
 				// TODO: Probably should check if same name?
 			}
 #endif
-			g_aSymbols[ eSymbolTable ][ nAddress ] = pSymbolName;
+			SymbolTableAdd( eSymbolTable, nAddress, pSymbolName );
 
 			// Tell user symbol was added
 			char sText[ CONSOLE_WIDTH * 2 ];
@@ -1001,6 +1166,7 @@ Update_t _CmdSymbolsCommon ( int nArgs, int bSymbolTables )
 			if (iParam == PARAM_ON)
 			{
 				g_bDisplaySymbolTables |= bSymbolTables;
+				_SymbolIndexInvalidate();
 				int iTable = _GetSymbolTableFromFlag( bSymbolTables );
 				if (iTable != NUM_SYMBOL_TABLES)
 				{
@@ -1013,6 +1179,7 @@ Update_t _CmdSymbolsCommon ( int nArgs, int bSymbolTables )
 			if (iParam == PARAM_OFF)
 			{
 				g_bDisplaySymbolTables &= ~bSymbolTables;
+				_SymbolIndexInvalidate();
 				int iTable = _GetSymbolTableFromFlag( bSymbolTables );
 				if (iTable != NUM_SYMBOL_TABLES)
 				{
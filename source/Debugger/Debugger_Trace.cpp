@@ -0,0 +1,191 @@
+/*
+AppleWin : An Apple //e emulator for Windows
+
+Copyright (C) 1994-1996, Michael O'Brien
+Copyright (C) 1999-2001, Oliver Schmidt
+Copyright (C) 2002-2005, Tom Charlesworth
+Copyright (C) 2006-2019, Tom Charlesworth, Michael Pohoreski, Nick Westgate
+
+AppleWin is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+AppleWin is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with AppleWin; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+*/
+
+/* Description: Debugger binary trace file
+ *
+ * The emulation thread adds a fixed-size record per opcode to a ring (no formatting, no file I/O).
+ * A background thread writes the ring to the file in large blocks.
+ * If the ring fills (ie. the disk can't keep up) then the emulation thread waits, so no records are lost.
+ */
+
+#include "StdAfx.h"
+
+#include "Debugger_Trace.h"
+
+static const UINT kRingRecords = 1 << 20;		// 16MB
+static const UINT kWakeRecords = 1 << 16;		// Wake the writer every 1MB of records
+
+static TraceRecord_t* g_pRing = NULL;
+static volatile LONG g_nWrite = 0;				// Free-running indices: only the emulation thread writes g_nWrite...
+static volatile LONG g_nRead = 0;				// ...and only the writer thread writes g_nRead
+
+static FILE* g_hFile = NULL;
+static HANDLE g_hWriterThread = NULL;
+static HANDLE g_hWakeEvent = NULL;
+static volatile bool g_bWriterQuit = false;
+
+static unsigned __int64 g_uLastCycle = 0;
+static unsigned __int64 g_uNumRecords = 0;
+
+//===========================================================================
+
+// Writer thread: write all records queued so far
+static void WriteQueuedRecords(void)
+{
+	const LONG nWrite = g_nWrite;
+	MemoryBarrier();	// Read the records after reading g_nWrite
+
+	LONG nRead = g_nRead;
+	while (nRead != nWrite)
+	{
+		const UINT uIdx = (UINT)nRead & (kRingRecords-1);
+		UINT uNum = (UINT)(nWrite - nRead);
+		if (uNum > kRingRecords - uIdx)
+			uNum = kRingRecords - uIdx;	// Up to the end of the ring: then wrap
+
+		fwrite(&g_pRing[uIdx], sizeof(TraceRecord_t), uNum, g_hFile);
+		nRead += uNum;
+	}
+
+	MemoryBarrier();	// Finish reading the records before freeing their slots
+	g_nRead = nRead;
+}
+
+static DWORD WINAPI TraceWriterThread(LPVOID)
+{
+	while (true)
+	{
+		WaitForSingleObject(g_hWakeEvent, 100);
+
+		const bool bQuit = g_bWriterQuit;
+		WriteQueuedRecords();
+		if (bQuit)
+			break;
+	}
+
+	return 0;
+}
+
+//===========================================================================
+
+bool TraceFile_Open(const char* pszPathName, const DWORD nCpuType, const unsigned __int64 uCycle)
+{
+	TraceFile_Close();
+
+	g_hFile = fopen(pszPathName, "wb");
+	if (!g_hFile)
+		return false;
+
+	TraceFileHeader_t header;
+	memset(&header, 0, sizeof(header));
+	strcpy(header.sMagic, TRACE_FILE_MAGIC);
+	header.nVersion = TRACE_FILE_VERSION;
+	header.nRecordSize = sizeof(TraceRecord_t);
+	header.nCpuType = nCpuType;
+	header.nStartCycle = uCycle;
+	fwrite(&header, sizeof(header), 1, g_hFile);
+
+	g_pRing = new TraceRecord_t[kRingRecords];
+	g_nWrite = g_nRead = 0;
+	g_uLastCycle = uCycle;
+	g_uNumRecords = 0;
+
+	g_bWriterQuit = false;
+	g_hWakeEvent = CreateEvent(NULL, FALSE, FALSE, NULL);
+
+	DWORD dwThreadId;
+	if (g_hWakeEvent)
+		g_hWriterThread = CreateThread(NULL, 0, TraceWriterThread, NULL, 0, &dwThreadId);
+
+	if (!g_hWriterThread)
+	{
+		// Without the writer thread nothing drains the ring, so TraceFile_Add() would wait forever
+		if (g_hWakeEvent)
+			CloseHandle(g_hWakeEvent);
+		g_hWakeEvent = NULL;
+
+		fclose(g_hFile);
+		g_hFile = NULL;
+
+		delete [] g_pRing;
+		g_pRing = NULL;
+		return false;
+	}
+
+	return true;
+}
+
+void TraceFile_Close(void)
+{
+	if (!g_hFile)
+		return;
+
+	g_bWriterQuit = true;
+	SetEvent(g_hWakeEvent);
+	WaitForSingleObject(g_hWriterThread, INFINITE);	// NB. Writes any remaining records
+
+	CloseHandle(g_hWriterThread);
+	g_hWriterThread = NULL;
+	CloseHandle(g_hWakeEvent);
+	g_hWakeEvent = NULL;
+
+	fclose(g_hFile);
+	g_hFile = NULL;
+
+	delete [] g_pRing;
+	g_pRing = NULL;
+}
+
+bool TraceFile_IsOpen(void)
+{
+	return g_hFile != NULL;
+}
+
+// Emulation thread only
+// . uCycle: the cycle at which the CPU is about to execute the record's opcode
+void TraceFile_Add(TraceRecord_t& record, const unsigned __int64 uCycle)
+{
+	const unsigned __int64 uCycles = uCycle - g_uLastCycle;
+	record.nCycles = (uCycles > 0xFFFFFFFF) ? 0xFFFFFFFF : (DWORD)uCycles;
+	g_uLastCycle = uCycle;
+
+	while ((UINT)(g_nWrite - g_nRead) >= kRingRecords)
+	{
+		SetEvent(g_hWakeEvent);
+		Sleep(1);	// Ring is full: wait for the writer
+	}
+
+	g_pRing[(UINT)g_nWrite & (kRingRecords-1)] = record;
+	MemoryBarrier();	// Write the record before publishing it
+	g_nWrite = g_nWrite + 1;
+
+	if (((UINT)g_nWrite & (kWakeRecords-1)) == 0)
+		SetEvent(g_hWakeEvent);
+
+	g_uNumRecords++;
+}
+
+unsigned __int64 TraceFile_GetNumRecords(void)
+{
+	return g_uNumRecords;
+}
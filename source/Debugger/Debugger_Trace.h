@@ -0,0 +1,33 @@
+#pragma once
+
+// Binary instruction trace ("TF"): one TraceRecord_t per 6502 opcode, queued in a ring & written to file by a background thread
+// . a record is the CPU state just before the opcode at nPC executes
+// . TraceDisasm disassembles (& symbolises) a trace file afterwards
+
+#define TRACE_FILE_MAGIC	"AWTRACE"
+const DWORD TRACE_FILE_VERSION = 1;
+
+struct TraceFileHeader_t		// 32 bytes
+{
+	char  sMagic[8];			// TRACE_FILE_MAGIC
+	DWORD nVersion;
+	DWORD nRecordSize;			// sizeof(TraceRecord_t)
+	DWORD nCpuType;				// eCpuType, for the opcode table
+	DWORD nReserved;
+	unsigned __int64 nStartCycle;	// Cycle of the 1st record
+};
+
+struct TraceRecord_t			// 16 bytes
+{
+	DWORD nCycles;				// Cycles since the previous record (ie. the previous opcode, plus any interrupt)
+	WORD  nPC;
+	BYTE  aOpcode[3];			// Opcode & operand bytes (only the opcode's length is meaningful)
+	BYTE  nA, nX, nY, nP, nS;	// nS: low byte of SP
+	BYTE  nReserved[2];
+};
+
+bool	TraceFile_Open(const char* pszPathName, const DWORD nCpuType, const unsigned __int64 uCycle);
+void	TraceFile_Close(void);
+bool	TraceFile_IsOpen(void);
+void	TraceFile_Add(TraceRecord_t& record, const unsigned __int64 uCycle);
+unsigned __int64 TraceFile_GetNumRecords(void);
@@ -1092,6 +1092,35 @@ const	DisasmData_t* pDisasmData; // If != NULL then bytes are marked up as data
 		}
 	};
 
+	// Runtime profiler (PROFILE ON)
+	struct ProfileRoutine_t
+	{
+		WORD      m_nAddress;
+		UINT      m_nCalls;
+		Profile_t m_nInclusive; // Cycles, including the routines it calls
+		Profile_t m_nExclusive;
+
+		// functor
+		bool operator () (const ProfileRoutine_t & rLHS, const ProfileRoutine_t & rRHS) const
+		{
+			bool bGreater = (rLHS.m_nInclusive > rRHS.m_nInclusive);
+			return bGreater;
+		}
+	};
+
+	struct ProfileAddress_t
+	{
+		WORD      m_nAddress;
+		Profile_t m_nCycles; // Histogram
+
+		// functor
+		bool operator () (const ProfileAddress_t & rLHS, const ProfileAddress_t & rRHS) const
+		{
+			bool bGreater = (rLHS.m_nCycles > rRHS.m_nCycles);
+			return bGreater;
+		}
+	};
+
 	enum ProfileFormat_e
 	{
 		PROFILE_FORMAT_SPACE,
@@ -1331,6 +1360,7 @@ const	DisasmData_t* pDisasmData; // If != NULL then bytes are marked up as data
 // Disk
 	, _PARAM_DISK_BEGIN = _PARAM_CONFIG_END // Daisy Chain
 		, PARAM_DISK_EJECT = _PARAM_DISK_BEGIN // DISK 1 EJECT
+		, PARAM_DISK_INDEX                     // DISK INDEX ["Directory"]
 		, PARAM_DISK_INFO                      // DISK 1 INFO
 		, PARAM_DISK_PROTECT                   // DISK 1 PROTECT
 		, PARAM_DISK_READ                      // DISK 1 READ Track Sector NumSectors MemAddress
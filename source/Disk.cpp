@@ -1212,6 +1212,270 @@ void DiskLoadRom(LPBYTE pCxRomPeripheral, UINT uSlot)
 
 //===========================================================================
 
+#ifdef DISK_FAST_TRAP
+// Fast disk: service standard DOS 3.3 RWTS & ProDOS 8 Disk II driver calls directly from the image, bypassing nibble emulation
+// . Called by the CPU loop before fetching the opcode at DISK_FAST_TRAP_RWTS or DISK_FAST_TRAP_PRODOS
+// . Only when enhancedisk is set, and only for DO/PO images (ie. anything with a sector order)
+// . Anything non-standard returns false (patched RWTS, unknown IOB, FORMAT, NIB images, etc) and the call is emulated as normal
+// . The emulated head, phases & motor are left untouched, so RWTS's & ProDOS's own record of the head position stays valid
+// . The results (memory, IOB/error code, A & C) match the real routines, but the call takes no emulated time
+
+#define RWTS_INTERLEAVE		0xBFB8	// 16 byte logical->physical sector table
+#define RWTS_CMD_SEEK		0x00
+#define RWTS_CMD_READ		0x01
+#define RWTS_CMD_WRITE		0x02
+#define RWTS_ERR_WRITE_PROTECTED	0x10
+#define RWTS_ERR_VOLUME_MISMATCH	0x20
+
+#define PRODOS_MLI			0xBF00	// JMP MLI
+#define PRODOS_DEVADR		0xBF10	// Device driver vectors: [drive 1: slot 0..7][drive 2: slot 0..7]
+#define PRODOS_CMD_STATUS	0x00
+#define PRODOS_CMD_READ		0x01
+#define PRODOS_CMD_WRITE	0x02
+#define PRODOS_ERR_WRITE_PROTECTED	0x2B
+
+static BYTE FastTrapReadByte(const WORD addr)
+{
+#ifdef MEM_NOCOPY_PAGING
+	return *(memread[addr >> 8] + (addr & 0xFF));
+#else
+	return *(mem + addr);
+#endif
+}
+
+static WORD FastTrapReadWord(const WORD addr)
+{
+	return FastTrapReadByte(addr) | (FastTrapReadByte(addr+1) << 8);
+}
+
+static void FastTrapWriteByte(const WORD addr, const BYTE data)
+{
+	memdirty[addr >> 8] = MEMDIRTY_CPU;
+	LPBYTE page = memwrite[addr >> 8];
+	if (!page)
+		page = memtrapwrite[addr >> 8];	// Not a 6502 access, so bypass any page trap (see MemSetPageTraps())
+	if (page)
+		*(page+(addr & 0xFF)) = data;
+}
+
+// memcpy to 6502 memory as the current paging sees it: a page at a time, dirtying each page
+// . NB. Never called for I/O space (see FastTrapIsValidBuffer())
+static void FastTrapCopyToMemory(WORD addr, const BYTE* pData, UINT uLen)
+{
+	while (uLen)
+	{
+		const UINT uChunk = MIN(uLen, 0x100 - (addr & 0xFF));
+
+		memdirty[addr >> 8] = MEMDIRTY_CPU;
+		LPBYTE page = memwrite[addr >> 8];
+		if (!page)
+			page = memtrapwrite[addr >> 8];	// Bypass any page trap (as FastTrapWriteByte())
+		if (page)
+			memcpy(page + (addr & 0xFF), pData, uChunk);	// else ROM: writes are ignored
+
+		addr += uChunk;
+		pData += uChunk;
+		uLen -= uChunk;
+	}
+}
+
+static void FastTrapCopyFromMemory(WORD addr, BYTE* pData, UINT uLen)
+{
+	while (uLen--)
+		*pData++ = FastTrapReadByte(addr++);
+}
+
+static bool FastTrapIsValidBuffer(const WORD addr, const UINT uLen)
+{
+	const UINT uEnd = addr + uLen - 1;
+	return uEnd <= 0xFFFF && (uEnd < 0xC000 || addr >= 0xD000);
+}
+
+static bool FastTrapReadWriteSector(const int iDrive, const int nTrack, const int nPhysicalSector, const WORD wBuffer, const bool bWrite)
+{
+	Drive_t* pDrive = &g_aFloppyDrive[iDrive];
+	Disk_t* pFloppy = &pDrive->disk;
+	BYTE sector[256];
+
+	DiskFlushCurrentTrack(iDrive);	// The image must include any nibble-level writes
+
+	if (!bWrite)
+	{
+		if (!ImageReadSector(pFloppy->imagehandle, nTrack, nPhysicalSector, sector))
+			return false;
+
+		FastTrapCopyToMemory(wBuffer, sector, sizeof(sector));
+	}
+	else
+	{
+		FastTrapCopyFromMemory(wBuffer, sector, sizeof(sector));
+
+		if (!ImageWriteSector(pFloppy->imagehandle, nTrack, nPhysicalSector, sector))
+			return false;
+
+		if (pDrive->track == nTrack)
+			pFloppy->trackimagedata = false;	// Re-read (re-nibblize) the track under the head on the next access
+	}
+
+	return true;
+}
+
+// Emulate the routine's RTS, with the error code in A and C set on error
+static void FastTrapReturn(const BYTE uErr)
+{
+	regs.a = uErr;
+	regs.ps = uErr ? (regs.ps | 0x01) : (regs.ps & ~0x01);	// C flag
+
+	regs.sp = ((regs.sp + 1) & 0xFF) | 0x100;
+	const BYTE lo = FastTrapReadByte(regs.sp);
+	regs.sp = ((regs.sp + 1) & 0xFF) | 0x100;
+	const BYTE hi = FastTrapReadByte(regs.sp);
+	regs.pc = ((hi << 8) | lo) + 1;
+}
+
+// RWTS: A/Y = IOB
+static bool FastTrapRWTS(void)
+{
+	// STY $48 : STA $49 : LDY #$02 : STY $06F8 : LDY #$04 : STY $04F8
+	static const BYTE kSignature[] = {0x84,0x48,0x85,0x49,0xA0,0x02,0x8C,0xF8,0x06,0xA0,0x04,0x8C,0xF8,0x04};
+	for (UINT i = 0; i < sizeof(kSignature); i++)
+	{
+		if (FastTrapReadByte(DISK_FAST_TRAP_RWTS + i) != kSignature[i])
+			return false;
+	}
+
+	const WORD iob = (regs.a << 8) | regs.y;
+	if (!FastTrapIsValidBuffer(iob, 0x11) || FastTrapReadByte(iob+0x00) != 0x01)	// IOB type
+		return false;
+
+	const BYTE slot16 = FastTrapReadByte(iob+0x01);
+	const BYTE drive = FastTrapReadByte(iob+0x02);
+	if (slot16 != (g_uSlot << 4) || (drive != 1 && drive != 2))
+		return false;
+
+	const int iDrive = drive - 1;
+	Disk_t* pFloppy = &g_aFloppyDrive[iDrive].disk;
+	if (!pFloppy->imagehandle)
+		return false;
+
+	const BYTE volume = FastTrapReadByte(iob+0x03);
+	const BYTE track = FastTrapReadByte(iob+0x04);
+	const BYTE logicalSector = FastTrapReadByte(iob+0x05);
+	const WORD wBuffer = FastTrapReadWord(iob+0x08);
+	const BYTE command = FastTrapReadByte(iob+0x0C);
+
+	if (command != RWTS_CMD_SEEK && command != RWTS_CMD_READ && command != RWTS_CMD_WRITE)
+		return false;
+
+	if (track >= ImageGetNumTracks(pFloppy->imagehandle) || logicalSector >= NUM_SECTORS || !FastTrapIsValidBuffer(wBuffer, 256))
+		return false;
+
+	const BYTE physicalSector = FastTrapReadByte(RWTS_INTERLEAVE + logicalSector);
+	if (physicalSector >= NUM_SECTORS)
+		return false;
+
+	const BYTE volumeFound = ImageGetVolumeNumber(pFloppy->imagehandle);
+	BYTE uErr = 0;
+
+	if (command == RWTS_CMD_SEEK)
+		;
+	else if (volume && volume != volumeFound)
+		uErr = RWTS_ERR_VOLUME_MISMATCH;
+	else if (command == RWTS_CMD_WRITE && pFloppy->bWriteProtected)
+		uErr = RWTS_ERR_WRITE_PROTECTED;
+	else if (!FastTrapReadWriteSector(iDrive, track, physicalSector, wBuffer, command == RWTS_CMD_WRITE))
+		return false;
+
+	FastTrapWriteByte(0x48, iob & 0xFF);
+	FastTrapWriteByte(0x49, iob >> 8);
+	FastTrapWriteByte(iob+0x0D, uErr);			// Return code
+	FastTrapWriteByte(iob+0x0E, volumeFound);
+	FastTrapWriteByte(iob+0x0F, slot16);		// Previous slot
+	FastTrapWriteByte(iob+0x10, drive);			// Previous drive
+
+	FastTrapReturn(uErr);
+	return true;
+}
+
+// ProDOS block driver: $42=command, $43=unit (DSSS0000), $44/45=buffer, $46/47=block
+static bool FastTrapProDOS(void)
+{
+	if (!(GetMemMode() & MF_HIGHRAM) || FastTrapReadByte(PRODOS_MLI) != 0x4C)	// JMP
+		return false;
+
+	const BYTE command = FastTrapReadByte(0x42);
+	const BYTE unit = FastTrapReadByte(0x43);
+	const UINT slot = (unit >> 4) & 7;
+	const int iDrive = (unit & 0x80) ? DRIVE_2 : DRIVE_1;
+
+	if (slot != g_uSlot || FastTrapReadWord(PRODOS_DEVADR + iDrive*0x10 + slot*2) != DISK_FAST_TRAP_PRODOS)
+		return false;
+
+	Disk_t* pFloppy = &g_aFloppyDrive[iDrive].disk;
+	if (!pFloppy->imagehandle)
+		return false;
+
+	const WORD wBuffer = FastTrapReadWord(0x44);
+	const WORD wBlock = FastTrapReadWord(0x46);
+	const UINT uNumBlocks = ImageGetNumTracks(pFloppy->imagehandle) * (NUM_SECTORS/2);
+	BYTE uErr = 0;
+
+	if (command == PRODOS_CMD_STATUS)
+	{
+		if (pFloppy->bWriteProtected)
+			uErr = PRODOS_ERR_WRITE_PROTECTED;
+		regs.x = uNumBlocks & 0xFF;
+		regs.y = uNumBlocks >> 8;
+	}
+	else if (command == PRODOS_CMD_READ || command == PRODOS_CMD_WRITE)
+	{
+		if (wBlock >= uNumBlocks || !FastTrapIsValidBuffer(wBuffer, 512))
+			return false;
+
+		const bool bWrite = command == PRODOS_CMD_WRITE;
+		if (bWrite && pFloppy->bWriteProtected)
+		{
+			uErr = PRODOS_ERR_WRITE_PROTECTED;
+		}
+		else
+		{
+			// A block is 2 ProDOS-order logical sectors
+			static const BYTE kProDOSLogicalToPhysical[NUM_SECTORS] = {0x0,0x2,0x4,0x6,0x8,0xA,0xC,0xE,0x1,0x3,0x5,0x7,0x9,0xB,0xD,0xF};
+			const int nTrack = wBlock / (NUM_SECTORS/2);
+			const UINT uLogicalSector = (wBlock % (NUM_SECTORS/2)) * 2;
+
+			if (!FastTrapReadWriteSector(iDrive, nTrack, kProDOSLogicalToPhysical[uLogicalSector+0], wBuffer+0x000, bWrite) ||
+				!FastTrapReadWriteSector(iDrive, nTrack, kProDOSLogicalToPhysical[uLogicalSector+1], wBuffer+0x100, bWrite))
+				return false;
+		}
+	}
+	else
+	{
+		return false;	// eg. FORMAT
+	}
+
+	FastTrapReturn(uErr);
+	return true;
+}
+
+// Returns true if the call was serviced, in which case regs have been updated to return to the caller
+bool DiskFastTrap(void)
+{
+	if (!enhancedisk || !g_uSlot)
+		return false;
+
+	if (regs.pc == DISK_FAST_TRAP_RWTS)
+		return FastTrapRWTS();
+
+	if (regs.pc == DISK_FAST_TRAP_PRODOS)
+		return FastTrapProDOS();
+
+	return false;
+}
+#endif
+
+//===========================================================================
+
 static BYTE __stdcall Disk_IORead(WORD pc, WORD addr, BYTE bWrite, BYTE d, ULONG nExecutedCycles)
 {
 	switch (addr & 0xF)
@@ -1433,6 +1697,13 @@ void DiskSaveSnapshot(class YamlSaveHelper& yamlSaveHelper)
 
 	DiskSaveSnapshotDisk2Unit(yamlSaveHelper, DRIVE_1);
 	DiskSaveSnapshotDisk2Unit(yamlSaveHelper, DRIVE_2);
+
+	// Barrier: ensure the image files on the host are consistent with the save-state
+	for (UINT unit = DRIVE_1; unit < NUM_DRIVES; unit++)
+	{
+		if (g_aFloppyDrive[unit].disk.imagehandle)
+			ImageFlush(g_aFloppyDrive[unit].disk.imagehandle);
+	}
 }
 
 static void DiskLoadSnapshotDriveUnit(YamlLoadHelper& yamlLoadHelper, UINT unit)
@@ -86,6 +86,12 @@ bool Disk_IsDriveEmpty(const int iDrive);
 bool Disk_GetEnhanceDisk(void);
 void Disk_SetEnhanceDisk(bool bEnhanceDisk);
 
+#ifdef DISK_FAST_TRAP
+const WORD DISK_FAST_TRAP_RWTS = 0xBD00;	// DOS 3.3 RWTS entry
+const WORD DISK_FAST_TRAP_PRODOS = 0xD000;	// ProDOS 8 Disk II driver entry (language card RAM)
+bool DiskFastTrap(void);
+#endif
+
 //
 
 // For sharing with class FormatTrack
@@ -30,6 +30,8 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 
 #include "DiskImage.h"
 #include "DiskImageHelper.h"
+#include "DiskImageIndex.h"
+#include "Log.h"
 
 
 static CDiskImageHelper sg_DiskImageHelper;
@@ -113,6 +115,16 @@ void ImageClose(ImageInfo* const pImageInfo, const bool bOpenError /*=false*/)
 		}
 	}
 
+	CImageBase::WriteBackFlush(pImageInfo);	// Barrier: eject & shutdown
+
+	if (pImageInfo->uTrackCacheHits + pImageInfo->uTrackCacheMisses)
+	{
+		UINT uHits, uMisses;
+		ImageGetTrackCacheStats(pImageInfo, uHits, uMisses);
+		LogFileOutput("ImageClose: track cache: hits=%d, misses=%d (hit rate=%d%%) : %s\n",
+			uHits, uMisses, uHits * 100 / (uHits + uMisses), pImageInfo->szFilename);
+	}
+
 	pImageInfo->pImageHelper->Close(pImageInfo, bDeleteFile);
 
 	VirtualFree(pImageInfo, 0, MEM_RELEASE);
@@ -137,6 +149,9 @@ BOOL ImageBoot(ImageInfo* const pImageInfo)
 
 void ImageDestroy(void)
 {
+	CImageBase::WriteBackDestroy();
+	ImageIndexDestroy();
+
 	VirtualFree(sg_DiskImageHelper.GetWorkBuffer(), 0, MEM_RELEASE);
 	sg_DiskImageHelper.SetWorkBuffer(NULL);
 }
@@ -147,6 +162,26 @@ void ImageInitialize(void)
 {
 	LPBYTE pBuffer = (LPBYTE) VirtualAlloc(NULL, TRACK_DENIBBLIZED_SIZE*2, MEM_COMMIT, PAGE_READWRITE);
 	sg_DiskImageHelper.SetWorkBuffer(pBuffer);
+
+	CImageBase::WriteBackInitialize();
+	ImageIndexInitialize();
+}
+
+//===========================================================================
+
+// Nibblized track cache counters (DO/PO images only)
+void ImageGetTrackCacheStats(ImageInfo* const pImageInfo, UINT& uHits, UINT& uMisses)
+{
+	uHits = pImageInfo->uTrackCacheHits;
+	uMisses = pImageInfo->uTrackCacheMisses;
+}
+
+//===========================================================================
+
+// Block until any dirty tracks queued for write-back are in the host file
+void ImageFlush(ImageInfo* const pImageInfo)
+{
+	CImageBase::WriteBackFlush(pImageInfo);
 }
 
 //===========================================================================
@@ -193,6 +228,45 @@ void ImageWriteTrack(	ImageInfo* const pImageInfo,
 
 //===========================================================================
 
+bool ImageReadSector(ImageInfo* const pImageInfo, const int nTrack, const int nPhysicalSector, LPBYTE pSectorBuffer)
+{
+	if (nTrack < 0 || nTrack >= (int)pImageInfo->uNumTracks || !pImageInfo->ValidTrack[nTrack])
+		return false;
+
+	if (nPhysicalSector < 0 || nPhysicalSector >= NUM_SECTORS)
+		return false;
+
+	if (!pImageInfo->pImageType->AllowRW())
+		return false;
+
+	return pImageInfo->pImageType->ReadSector(pImageInfo, nTrack, nPhysicalSector, pSectorBuffer);
+}
+
+//===========================================================================
+
+bool ImageWriteSector(ImageInfo* const pImageInfo, const int nTrack, const int nPhysicalSector, LPBYTE pSectorBuffer)
+{
+	if (nTrack < 0 || nTrack >= (int)pImageInfo->uNumTracks || !pImageInfo->ValidTrack[nTrack])
+		return false;
+
+	if (nPhysicalSector < 0 || nPhysicalSector >= NUM_SECTORS)
+		return false;
+
+	if (!pImageInfo->pImageType->AllowRW() || pImageInfo->bWriteProtected)
+		return false;
+
+	return pImageInfo->pImageType->WriteSector(pImageInfo, nTrack, nPhysicalSector, pSectorBuffer);
+}
+
+//===========================================================================
+
+BYTE ImageGetVolumeNumber(ImageInfo* const pImageInfo)
+{
+	return pImageInfo->pImageType->GetVolumeNumber();
+}
+
+//===========================================================================
+
 bool ImageReadBlock(	ImageInfo* const pImageInfo,
 						UINT nBlock,
 						LPBYTE pBlockBuffer)
@@ -67,12 +67,17 @@ struct ImageInfo;
 
 ImageError_e ImageOpen(LPCTSTR pszImageFilename, ImageInfo** ppImageInfo, bool* pWriteProtected, const bool bCreateIfNecessary, std::string& strFilenameInZip, const bool bExpectFloppy=true);
 void ImageClose(ImageInfo* const pImageInfo, const bool bOpenError=false);
+void ImageFlush(ImageInfo* const pImageInfo);
+void ImageGetTrackCacheStats(ImageInfo* const pImageInfo, UINT& uHits, UINT& uMisses);
 BOOL ImageBoot(ImageInfo* const pImageInfo);
 void ImageDestroy(void);
 void ImageInitialize(void);
 
 void ImageReadTrack(ImageInfo* const pImageInfo, int nTrack, int nQuarterTrack, LPBYTE pTrackImageBuffer, int* pNibbles);
 void ImageWriteTrack(ImageInfo* const pImageInfo, int nTrack, int nQuarterTrack, LPBYTE pTrackImage, int nNibbles);
+bool ImageReadSector(ImageInfo* const pImageInfo, const int nTrack, const int nPhysicalSector, LPBYTE pSectorBuffer);
+bool ImageWriteSector(ImageInfo* const pImageInfo, const int nTrack, const int nPhysicalSector, LPBYTE pSectorBuffer);
+BYTE ImageGetVolumeNumber(ImageInfo* const pImageInfo);
 bool ImageReadBlock(ImageInfo* const pImageInfo, UINT nBlock, LPBYTE pBlockBuffer);
 bool ImageWriteBlock(ImageInfo* const pImageInfo, UINT nBlock, LPBYTE pBlockBuffer);
 
@@ -37,6 +37,8 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 #include "Disk.h"
 #include "DiskImage.h"
 #include "DiskImageHelper.h"
+#include "DiskImageIndex.h"
+#include "Log.h"
 #include "Memory.h"
 
 
@@ -79,33 +81,48 @@ bool CImageBase::ReadTrack(ImageInfo* pImageInfo, const int nTrack, LPBYTE pTrac
 
 //-------------------------------------
 
-bool CImageBase::WriteTrack(ImageInfo* pImageInfo, const int nTrack, LPBYTE pTrackBuffer, const UINT uTrackSize)
+// Dirty tracks are written back to the host file by a worker thread, so that the emulation thread never blocks on host I/O:
+// . WriteTrack() just updates pImageBuffer and marks the track (or whole gz/zip image) dirty
+// . The worker copies the latest data out of pImageBuffer, so multiple writes to the same track are coalesced
+// . gz/zip images are only recompressed once the image has been idle for WRITEBACK_IDLE_PERIOD_MS
+// . WriteBackFlush() is the barrier used on eject, save-state & shutdown
+
+#define WRITEBACK_IDLE_PERIOD_MS 500
+
+static CRITICAL_SECTION g_WriteBackCS;		// Guards pImageBuffer updates, the ImageInfo write-back state & g_vecWriteBackQueue
+static CRITICAL_SECTION g_WriteBackIoCS;	// Held while writing to the host file (worker or flush)
+static std::vector<ImageInfo*> g_vecWriteBackQueue;
+static HANDLE g_hWriteBackThread = NULL;
+static HANDLE g_hWriteBackEvent[2] = {NULL, NULL};	// [0]=work, [1]=exit
+static bool g_bWriteBackValid = false;	// The critical sections are initialised
+
+static bool FlushBlockAccess(ImageInfo* pImageInfo);
+
+static bool IsWriteBackPending(ImageInfo* pImageInfo)
 {
-	const long Offset = pImageInfo->uOffset + nTrack * uTrackSize;
-	memcpy(&pImageInfo->pImageBuffer[Offset], pTrackBuffer, uTrackSize);
+	if (pImageInfo->bDirtyImage)
+		return true;
 
-	if (pImageInfo->FileType == eFileNormal)
+	for (UINT nTrack = 0; nTrack < TRACKS_MAX; nTrack++)
 	{
-		if (pImageInfo->hFile == INVALID_HANDLE_VALUE)
-			return false;
+		if (pImageInfo->DirtyTrack[nTrack])
+			return true;
+	}
 
-		SetFilePointer(pImageInfo->hFile, Offset, NULL, FILE_BEGIN);
+	return false;
+}
 
-		DWORD dwBytesWritten;
-		BOOL bRes = WriteFile(pImageInfo->hFile, pTrackBuffer, uTrackSize, &dwBytesWritten, NULL);
-		_ASSERT(dwBytesWritten == uTrackSize);
-		if (!bRes || dwBytesWritten != uTrackSize)
-			return false;
-	}
-	else if (pImageInfo->FileType == eFileGZip)
+static bool WriteBackCompressedImage(ImageInfo* pImageInfo, const LPBYTE pImage, const UINT uImageSize)
+{
+	if (pImageInfo->FileType == eFileGZip)
 	{
 		// Write entire compressed image each time (dirty track change or dirty disk removal)
 		gzFile hGZFile = gzopen(pImageInfo->szFilename, "wb");
 		if (hGZFile == NULL)
 			return false;
 
-		int nLen = gzwrite(hGZFile, pImageInfo->pImageBuffer, pImageInfo->uImageSize);
-		if (nLen != pImageInfo->uImageSize)
+		int nLen = gzwrite(hGZFile, pImage, uImageSize);
+		if (nLen != uImageSize)
 			return false;
 
 		int nRes = gzclose(hGZFile);
@@ -125,7 +142,7 @@ bool CImageBase::WriteTrack(ImageInfo* pImageInfo, const int nTrack, LPBYTE pTra
 		if (nRes != ZIP_OK)
 			return false;
 
-		nRes = zipWriteInFileInZip(hZipFile, pImageInfo->pImageBuffer, pImageInfo->uImageSize);
+		nRes = zipWriteInFileInZip(hZipFile, pImage, uImageSize);
 		if (nRes != ZIP_OK)
 			return false;
 
@@ -146,117 +163,597 @@ bool CImageBase::WriteTrack(ImageInfo* pImageInfo, const int nTrack, LPBYTE pTra
 	return true;
 }
 
-//-----------------------------------------------------------------------------
+// Pre: g_WriteBackIoCS is held
+// . Data is copied out of pImageBuffer under g_WriteBackCS, and written with no lock held (so WriteTrack() is never blocked)
+static bool WriteBackImage(ImageInfo* pImageInfo)
+{
+	bool bRes = true;
 
-bool CImageBase::ReadBlock(ImageInfo* pImageInfo, const int nBlock, LPBYTE pBlockBuffer)
+	if (pImageInfo->FileType == eFileNormal)
+	{
+		std::vector<BYTE> vecTrack;
+
+		for (UINT nTrack = 0; nTrack < TRACKS_MAX; nTrack++)
+		{
+			long Offset = 0;
+
+			EnterCriticalSection(&g_WriteBackCS);
+			const bool bDirty = pImageInfo->DirtyTrack[nTrack] != 0;
+			if (bDirty)
+			{
+				Offset = pImageInfo->uOffset + nTrack * pImageInfo->uDirtyTrackSize;
+				vecTrack.assign(&pImageInfo->pImageBuffer[Offset], &pImageInfo->pImageBuffer[Offset] + pImageInfo->uDirtyTrackSize);
+				pImageInfo->DirtyTrack[nTrack] = 0;
+			}
+			LeaveCriticalSection(&g_WriteBackCS);
+
+			if (!bDirty || pImageInfo->hFile == INVALID_HANDLE_VALUE)
+				continue;
+
+			SetFilePointer(pImageInfo->hFile, Offset, NULL, FILE_BEGIN);
+
+			DWORD dwBytesWritten;
+			BOOL bWriteRes = WriteFile(pImageInfo->hFile, &vecTrack[0], vecTrack.size(), &dwBytesWritten, NULL);
+			_ASSERT(dwBytesWritten == vecTrack.size());
+			if (!bWriteRes || dwBytesWritten != vecTrack.size())
+				bRes = false;
+		}
+	}
+	else
+	{
+		LPBYTE pImage = NULL;
+		UINT uImageSize = 0;
+
+		EnterCriticalSection(&g_WriteBackCS);
+		if (pImageInfo->bDirtyImage)
+		{
+			uImageSize = pImageInfo->uImageSize;	// NB. A gz/zip hard disk image can grow
+			pImage = new BYTE [uImageSize];
+			memcpy(pImage, pImageInfo->pImageBuffer, uImageSize);
+			pImageInfo->bDirtyImage = false;
+		}
+		LeaveCriticalSection(&g_WriteBackCS);
+
+		if (pImage)
+		{
+			bRes = WriteBackCompressedImage(pImageInfo, pImage, uImageSize);
+			delete [] pImage;
+		}
+	}
+
+	if (!bRes)
+		LogFileOutput("WriteBackImage: failed to write: %s\n", pImageInfo->szFilename);
+
+	// Only dequeue if there were no new writes while doing the I/O
+	EnterCriticalSection(&g_WriteBackCS);
+	if (pImageInfo->bWriteBackQueued && !IsWriteBackPending(pImageInfo))
+	{
+		g_vecWriteBackQueue.erase( std::find(g_vecWriteBackQueue.begin(), g_vecWriteBackQueue.end(), pImageInfo) );
+		pImageInfo->bWriteBackQueued = false;
+	}
+	LeaveCriticalSection(&g_WriteBackCS);
+
+	return bRes;
+}
+
+static DWORD WINAPI WriteBackThread(LPVOID lpParameter)
 {
-	long Offset = pImageInfo->uOffset + nBlock * HD_BLOCK_SIZE;
+	DWORD dwTimeout = INFINITE;
+
+	while(1)
+	{
+		DWORD dwWaitResult = WaitForMultipleObjects(2, g_hWriteBackEvent, FALSE, dwTimeout);
+		if (dwWaitResult == WAIT_OBJECT_0+1)	// Exit event
+			break;
+
+		// Work event or idle timeout
+		dwTimeout = INFINITE;
+
+		EnterCriticalSection(&g_WriteBackIoCS);
+
+		EnterCriticalSection(&g_WriteBackCS);
+		std::vector<ImageInfo*> vecQueue(g_vecWriteBackQueue);
+		LeaveCriticalSection(&g_WriteBackCS);
+
+		for (UINT i = 0; i < vecQueue.size(); i++)
+		{
+			ImageInfo* pImageInfo = vecQueue[i];
+
+			if (pImageInfo->FileType != eFileNormal)
+			{
+				// Defer recompressing until the image has been idle for a while (eg. a whole file write is in progress)
+				EnterCriticalSection(&g_WriteBackCS);
+				const DWORD dwIdle = GetTickCount() - pImageInfo->dwLastWriteTime;
+				LeaveCriticalSection(&g_WriteBackCS);
+
+				if (dwIdle < WRITEBACK_IDLE_PERIOD_MS)
+				{
+					dwTimeout = min(dwTimeout, WRITEBACK_IDLE_PERIOD_MS - dwIdle);
+					continue;
+				}
+			}
+
+			WriteBackImage(pImageInfo);
+		}
+
+		LeaveCriticalSection(&g_WriteBackIoCS);
+	}
+
+	return 0;
+}
+
+void CImageBase::WriteBackInitialize(void)
+{
+	InitializeCriticalSection(&g_WriteBackCS);
+	InitializeCriticalSection(&g_WriteBackIoCS);
+	g_bWriteBackValid = true;
+
+	g_hWriteBackEvent[0] = CreateEvent(NULL,	// lpEventAttributes
+										FALSE,	// bManualReset (FALSE = auto-reset)
+										FALSE,	// bInitialState (FALSE = non-signaled)
+										NULL);	// lpName
+	g_hWriteBackEvent[1] = CreateEvent(NULL, FALSE, FALSE, NULL);
+
+	if ((g_hWriteBackEvent[0] == NULL) || (g_hWriteBackEvent[1] == NULL))
+	{
+		LogFileOutput("WriteBackInitialize: CreateEvent failed: falling back to synchronous writes\n");
+		return;
+	}
+
+	DWORD dwThreadId;
+	g_hWriteBackThread = CreateThread(NULL,				// lpThreadAttributes
+										0,				// dwStackSize
+										WriteBackThread,
+										NULL,			// lpParameter
+										0,				// dwCreationFlags : 0 = Run immediately
+										&dwThreadId);	// lpThreadId
+	LogFileOutput("WriteBackInitialize: CreateThread(), g_hWriteBackThread=0x%08X\n", (UINT32)g_hWriteBackThread);
+}
+
+// Pre: all images have been closed (ie. already flushed)
+void CImageBase::WriteBackDestroy(void)
+{
+	_ASSERT(g_vecWriteBackQueue.empty());
+
+	if (g_hWriteBackThread)
+	{
+		SetEvent(g_hWriteBackEvent[1]);	// Signal to thread that it should exit
+		WaitForSingleObject(g_hWriteBackThread, INFINITE);
+		CloseHandle(g_hWriteBackThread);
+		g_hWriteBackThread = NULL;
+	}
+
+	for (UINT i = 0; i < 2; i++)
+	{
+		if (g_hWriteBackEvent[i])
+		{
+			CloseHandle(g_hWriteBackEvent[i]);
+			g_hWriteBackEvent[i] = NULL;
+		}
+	}
+
+	g_bWriteBackValid = false;
+	DeleteCriticalSection(&g_WriteBackIoCS);
+	DeleteCriticalSection(&g_WriteBackCS);
+}
+
+// Barrier: returns once all of this image's dirty data is in the host file
+// . A no-op after WriteBackDestroy(): all images should have already been flushed by then
+void CImageBase::WriteBackFlush(ImageInfo* pImageInfo)
+{
+	_ASSERT(g_bWriteBackValid);
+	if (!g_bWriteBackValid)
+		return;
+
+	EnterCriticalSection(&g_WriteBackIoCS);
+	WriteBackImage(pImageInfo);
+	LeaveCriticalSection(&g_WriteBackIoCS);
+
+	FlushBlockAccess(pImageInfo);
+}
+
+// Pre: g_WriteBackCS is held, and the image's dirty state has just been updated
+static void QueueWriteBack(ImageInfo* pImageInfo)
+{
+	pImageInfo->dwLastWriteTime = GetTickCount();
+
+	if (!pImageInfo->bWriteBackQueued)
+	{
+		g_vecWriteBackQueue.push_back(pImageInfo);
+		pImageInfo->bWriteBackQueued = true;
+	}
+}
+
+static void SignalWriteBack(ImageInfo* pImageInfo)
+{
+	if (g_hWriteBackThread)
+		SetEvent(g_hWriteBackEvent[0]);
+	else
+		CImageBase::WriteBackFlush(pImageInfo);
+}
+
+//-------------------------------------
+
+bool CImageBase::WriteTrack(ImageInfo* pImageInfo, const int nTrack, LPBYTE pTrackBuffer, const UINT uTrackSize)
+{
+	const long Offset = pImageInfo->uOffset + nTrack * uTrackSize;
+
+	EnterCriticalSection(&g_WriteBackCS);
+
+	memcpy(&pImageInfo->pImageBuffer[Offset], pTrackBuffer, uTrackSize);
+	pImageInfo->TrackCacheNibbles[nTrack] = 0;	// Invalidate nibblized track
 
 	if (pImageInfo->FileType == eFileNormal)
 	{
 		if (pImageInfo->hFile == INVALID_HANDLE_VALUE)
+		{
+			LeaveCriticalSection(&g_WriteBackCS);
 			return false;
+		}
 
-		SetFilePointer(pImageInfo->hFile, Offset, NULL, FILE_BEGIN);
-
-		DWORD dwBytesRead;
-		BOOL bRes = ReadFile(pImageInfo->hFile, pBlockBuffer, HD_BLOCK_SIZE, &dwBytesRead, NULL);
-		if (!bRes || dwBytesRead != HD_BLOCK_SIZE)
-			return false;
+		pImageInfo->DirtyTrack[nTrack] = 1;
+		pImageInfo->uDirtyTrackSize = uTrackSize;
 	}
-	else if ((pImageInfo->FileType == eFileGZip) || (pImageInfo->FileType == eFileZip))
+	else
 	{
-		memcpy(pBlockBuffer, &pImageInfo->pImageBuffer[Offset], HD_BLOCK_SIZE);
+		pImageInfo->bDirtyImage = true;
 	}
-	else
+
+	QueueWriteBack(pImageInfo);
+
+	LeaveCriticalSection(&g_WriteBackCS);
+
+	SignalWriteBack(pImageInfo);
+
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+
+// Sector-level access to DO/PO images (eg. for DISK_FAST_TRAP)
+// . Returns false for any other image type (ie. there's no sector order to map a physical sector to a file offset)
+static bool GetSectorOrder(CImageBase* pImageType, CImageBase::SectorOrder_e& SectorOrder)
+{
+	switch (pImageType->GetType())
 	{
-		_ASSERT(0);
+	case eImageDO:	SectorOrder = CImageBase::eDOSOrder; return true;
+	case eImagePO:	SectorOrder = CImageBase::eProDOSOrder; return true;
+	default:		return false;
+	}
+}
+
+bool CImageBase::ReadSector(ImageInfo* pImageInfo, const int nTrack, const int nPhysicalSector, LPBYTE pSectorBuffer)
+{
+	SectorOrder_e SectorOrder;
+	if (!GetSectorOrder(this, SectorOrder))
+		return false;
+
+	const long Offset = pImageInfo->uOffset + nTrack * TRACK_DENIBBLIZED_SIZE + ms_SectorNumber[SectorOrder][nPhysicalSector] * 256;
+	memcpy(pSectorBuffer, &pImageInfo->pImageBuffer[Offset], 256);
+
+	return true;
+}
+
+// Read-modify-write of the whole track, so that the write-back queue & nibblized track cache see a normal WriteTrack()
+bool CImageBase::WriteSector(ImageInfo* pImageInfo, const int nTrack, const int nPhysicalSector, LPBYTE pSectorBuffer)
+{
+	SectorOrder_e SectorOrder;
+	if (!GetSectorOrder(this, SectorOrder))
+		return false;
+
+	ReadTrack(pImageInfo, nTrack, ms_pWorkBuffer, TRACK_DENIBBLIZED_SIZE);
+	memcpy(ms_pWorkBuffer + ms_SectorNumber[SectorOrder][nPhysicalSector] * 256, pSectorBuffer, 256);
+	return WriteTrack(pImageInfo, nTrack, ms_pWorkBuffer, TRACK_DENIBBLIZED_SIZE);
+}
+
+//-----------------------------------------------------------------------------
+
+// Hard disk images (eFileNormal) are accessed through a file mapping of the whole image, so a block r/w is just a memcpy
+// . If the file can't be mapped, then fall back to an LRU cache of blocks with write-behind (dirty blocks are written on eviction or flush)
+// . Growing the image is a single extend of the file (zero-filled), however far past the end the block is
+// . NB. Set up on the first block access, since CheckNormalFile() is common to floppy & hard disk images
+
+#define HD_BLOCK_CACHE_SIZE 128	// # blocks (64KB)
+
+struct HDBlockCacheEntry
+{
+	UINT uBlock;
+	UINT uLastUse;
+	bool bValid;
+	bool bDirty;
+	BYTE data[HD_BLOCK_SIZE];
+};
+
+struct HDBlockCache
+{
+	UINT uUseCount;
+	HDBlockCacheEntry entries[HD_BLOCK_CACHE_SIZE];
+};
+
+static bool MapImage(ImageInfo* pImageInfo)
+{
+	const bool bReadOnly = pImageInfo->bWriteProtected;
+
+	pImageInfo->hMapping = CreateFileMapping(pImageInfo->hFile, NULL, bReadOnly ? PAGE_READONLY : PAGE_READWRITE, 0, pImageInfo->uFileSize, NULL);
+	if (pImageInfo->hMapping == NULL)
+		return false;
+
+	pImageInfo->pMappedImage = (BYTE*) MapViewOfFile(pImageInfo->hMapping, bReadOnly ? FILE_MAP_READ : FILE_MAP_WRITE, 0, 0, 0);
+	if (pImageInfo->pMappedImage == NULL)
+	{
+		CloseHandle(pImageInfo->hMapping);
+		pImageInfo->hMapping = NULL;
 		return false;
 	}
 
 	return true;
 }
 
-//-------------------------------------
+static void UnmapImage(ImageInfo* pImageInfo)
+{
+	if (pImageInfo->pMappedImage)
+	{
+		UnmapViewOfFile(pImageInfo->pMappedImage);
+		pImageInfo->pMappedImage = NULL;
+	}
 
-bool CImageBase::WriteBlock(ImageInfo* pImageInfo, const int nBlock, LPBYTE pBlockBuffer)
+	if (pImageInfo->hMapping)
+	{
+		CloseHandle(pImageInfo->hMapping);
+		pImageInfo->hMapping = NULL;
+	}
+}
+
+static void InitBlockAccess(ImageInfo* pImageInfo)
 {
-	long Offset = pImageInfo->uOffset + nBlock * HD_BLOCK_SIZE;
-	const bool bGrowImageBuffer = (UINT)Offset+HD_BLOCK_SIZE > pImageInfo->uImageSize;
+	pImageInfo->bBlockAccessInit = true;
+	pImageInfo->uFileSize = GetFileSize(pImageInfo->hFile, NULL);
 
-	if (pImageInfo->FileType == eFileGZip || pImageInfo->FileType == eFileZip)
+	if (!MapImage(pImageInfo))
 	{
-		if (bGrowImageBuffer)
+		LogFileOutput("InitBlockAccess: failed to map file, using block cache: %s\n", pImageInfo->szFilename);
+		pImageInfo->pBlockCache = new HDBlockCache;
+		memset(pImageInfo->pBlockCache, 0, sizeof(HDBlockCache));
+	}
+}
+
+static bool WriteCachedBlock(ImageInfo* pImageInfo, HDBlockCacheEntry* pEntry)
+{
+	SetFilePointer(pImageInfo->hFile, pImageInfo->uOffset + pEntry->uBlock * HD_BLOCK_SIZE, NULL, FILE_BEGIN);
+
+	DWORD dwBytesWritten;
+	BOOL bRes = WriteFile(pImageInfo->hFile, pEntry->data, HD_BLOCK_SIZE, &dwBytesWritten, NULL);
+	if (!bRes || dwBytesWritten != HD_BLOCK_SIZE)
+		return false;
+
+	pEntry->bDirty = false;
+	return true;
+}
+
+// Returns the cache entry for nBlock, or NULL on an I/O error
+// . bRead: on a miss, read the block from the file (else the caller will overwrite the whole block)
+static HDBlockCacheEntry* GetCachedBlock(ImageInfo* pImageInfo, const UINT nBlock, const bool bRead)
+{
+	HDBlockCache* pCache = pImageInfo->pBlockCache;
+	HDBlockCacheEntry* pLRU = &pCache->entries[0];
+
+	for (UINT i = 0; i < HD_BLOCK_CACHE_SIZE; i++)
+	{
+		HDBlockCacheEntry* pEntry = &pCache->entries[i];
+		if (pEntry->bValid && pEntry->uBlock == nBlock)
 		{
-			// Horribly inefficient! (Unzip to a normal file if you want better performance!)
-			const UINT uNewImageSize = Offset+HD_BLOCK_SIZE;
-			BYTE* pNewImageBuffer = new BYTE [uNewImageSize];
+			pEntry->uLastUse = ++pCache->uUseCount;
+			return pEntry;
+		}
 
-			memcpy(pNewImageBuffer, pImageInfo->pImageBuffer, pImageInfo->uImageSize);
-			memset(&pNewImageBuffer[pImageInfo->uImageSize], 0, uNewImageSize-pImageInfo->uImageSize);	// Should always be HD_BLOCK_SIZE (so this is redundant)
+		if (!pEntry->bValid || (pLRU->bValid && pEntry->uLastUse < pLRU->uLastUse))
+			pLRU = pEntry;
+	}
 
-			delete [] pImageInfo->pImageBuffer;
-			pImageInfo->pImageBuffer = pNewImageBuffer;
-			pImageInfo->uImageSize = uNewImageSize;
+	if (pLRU->bValid && pLRU->bDirty && !WriteCachedBlock(pImageInfo, pLRU))
+		return NULL;
+
+	pLRU->bValid = false;
+
+	if (bRead)
+	{
+		SetFilePointer(pImageInfo->hFile, pImageInfo->uOffset + nBlock * HD_BLOCK_SIZE, NULL, FILE_BEGIN);
+
+		DWORD dwBytesRead;
+		BOOL bRes = ReadFile(pImageInfo->hFile, pLRU->data, HD_BLOCK_SIZE, &dwBytesRead, NULL);
+		if (!bRes || dwBytesRead != HD_BLOCK_SIZE)
+			return NULL;
+	}
+
+	pLRU->uBlock = nBlock;
+	pLRU->uLastUse = ++pCache->uUseCount;
+	pLRU->bValid = true;
+	pLRU->bDirty = false;
+	return pLRU;
+}
+
+static bool FlushBlockAccess(ImageInfo* pImageInfo)
+{
+	bool bRes = true;
+
+	if (pImageInfo->pMappedImage)
+		bRes = FlushViewOfFile(pImageInfo->pMappedImage, 0) != FALSE;
+
+	if (pImageInfo->pBlockCache)
+	{
+		for (UINT i = 0; i < HD_BLOCK_CACHE_SIZE; i++)
+		{
+			HDBlockCacheEntry* pEntry = &pImageInfo->pBlockCache->entries[i];
+			if (pEntry->bValid && pEntry->bDirty && !WriteCachedBlock(pImageInfo, pEntry))
+				bRes = false;
 		}
+	}
 
-		memcpy(&pImageInfo->pImageBuffer[Offset], pBlockBuffer, HD_BLOCK_SIZE);
+	return bRes;
+}
+
+// Extend the file (zero-filled) so that it's uNewFileSize bytes
+static bool ExtendImage(ImageInfo* pImageInfo, const UINT uNewFileSize)
+{
+	const bool bMapped = pImageInfo->pMappedImage != NULL;
+	if (bMapped)
+		UnmapImage(pImageInfo);
+
+	SetFilePointer(pImageInfo->hFile, uNewFileSize, NULL, FILE_BEGIN);
+	const bool bRes = SetEndOfFile(pImageInfo->hFile) != FALSE;
+	if (bRes)
+		pImageInfo->uFileSize = uNewFileSize;
+
+	if (bMapped && !MapImage(pImageInfo))
+	{
+		LogFileOutput("ExtendImage: failed to re-map file, using block cache: %s\n", pImageInfo->szFilename);
+		pImageInfo->pBlockCache = new HDBlockCache;
+		memset(pImageInfo->pBlockCache, 0, sizeof(HDBlockCache));
 	}
 
+	return bRes;
+}
+
+void CImageBase::ReleaseBlockAccess(ImageInfo* pImageInfo)
+{
+	FlushBlockAccess(pImageInfo);
+	UnmapImage(pImageInfo);
+
+	delete pImageInfo->pBlockCache;
+	pImageInfo->pBlockCache = NULL;
+	pImageInfo->bBlockAccessInit = false;
+}
+
+//-------------------------------------
+
+// Get the file offset of nBlock, or false if the block would end beyond 4GB
+// NB. Do the math in 64 bits, as nBlock can be any 32-bit block number from a SmartPort extended call
+static bool GetBlockOffset(const ImageInfo* pImageInfo, const int nBlock, UINT& uOffset)
+{
+	if (nBlock < 0)
+		return false;
+
+	const UINT64 uOffset64 = (UINT64)pImageInfo->uOffset + (UINT64)nBlock * HD_BLOCK_SIZE;
+	if (uOffset64 + HD_BLOCK_SIZE > 0xFFFFFFFF)
+		return false;
+
+	uOffset = (UINT) uOffset64;
+	return true;
+}
+
+bool CImageBase::ReadBlock(ImageInfo* pImageInfo, const int nBlock, LPBYTE pBlockBuffer)
+{
+	UINT Offset;
+	if (!GetBlockOffset(pImageInfo, nBlock, Offset))
+		return false;
+
 	if (pImageInfo->FileType == eFileNormal)
 	{
 		if (pImageInfo->hFile == INVALID_HANDLE_VALUE)
 			return false;
 
-		SetFilePointer(pImageInfo->hFile, Offset, NULL, FILE_BEGIN);
+		if (!pImageInfo->bBlockAccessInit)
+			InitBlockAccess(pImageInfo);
 
-		DWORD dwBytesWritten;
-		BOOL bRes = WriteFile(pImageInfo->hFile, pBlockBuffer, HD_BLOCK_SIZE, &dwBytesWritten, NULL);
-		if (!bRes || dwBytesWritten != HD_BLOCK_SIZE)
+		if (Offset+HD_BLOCK_SIZE > pImageInfo->uFileSize)
 			return false;
 
-		if (bGrowImageBuffer)
-			pImageInfo->uImageSize += HD_BLOCK_SIZE;
+		if (pImageInfo->pMappedImage)
+		{
+			memcpy(pBlockBuffer, &pImageInfo->pMappedImage[Offset], HD_BLOCK_SIZE);
+		}
+		else
+		{
+			HDBlockCacheEntry* pEntry = GetCachedBlock(pImageInfo, nBlock, true);
+			if (!pEntry)
+				return false;
+
+			memcpy(pBlockBuffer, pEntry->data, HD_BLOCK_SIZE);
+		}
 	}
-	else if (pImageInfo->FileType == eFileGZip)
+	else if ((pImageInfo->FileType == eFileGZip) || (pImageInfo->FileType == eFileZip))
 	{
-		// Write entire compressed image each time a block is written
-		gzFile hGZFile = gzopen(pImageInfo->szFilename, "wb");
-		if (hGZFile == NULL)
+		if (Offset+HD_BLOCK_SIZE > pImageInfo->uImageSize)
 			return false;
 
-		int nLen = gzwrite(hGZFile, pImageInfo->pImageBuffer, pImageInfo->uImageSize);
-		if (nLen != pImageInfo->uImageSize)
-			return false;
+		memcpy(pBlockBuffer, &pImageInfo->pImageBuffer[Offset], HD_BLOCK_SIZE);
+	}
+	else
+	{
+		_ASSERT(0);
+		return false;
+	}
 
-		int nRes = gzclose(hGZFile);
-		hGZFile = NULL;
-		if (nRes != Z_OK)
+	return true;
+}
+
+//-------------------------------------
+
+bool CImageBase::WriteBlock(ImageInfo* pImageInfo, const int nBlock, LPBYTE pBlockBuffer)
+{
+	UINT Offset;
+	if (!GetBlockOffset(pImageInfo, nBlock, Offset))
+		return false;
+
+	const bool bGrowImageBuffer = Offset+HD_BLOCK_SIZE > pImageInfo->uImageSize;
+
+	if (pImageInfo->FileType == eFileNormal)
+	{
+		if (pImageInfo->hFile == INVALID_HANDLE_VALUE)
 			return false;
+
+		if (!pImageInfo->bBlockAccessInit)
+			InitBlockAccess(pImageInfo);
+
+		if (Offset+HD_BLOCK_SIZE > pImageInfo->uFileSize)
+		{
+			if (!ExtendImage(pImageInfo, Offset+HD_BLOCK_SIZE))
+				return false;
+		}
+
+		if (pImageInfo->pMappedImage)
+		{
+			memcpy(&pImageInfo->pMappedImage[Offset], pBlockBuffer, HD_BLOCK_SIZE);
+		}
+		else
+		{
+			HDBlockCacheEntry* pEntry = GetCachedBlock(pImageInfo, nBlock, false);
+			if (!pEntry)
+				return false;
+
+			memcpy(pEntry->data, pBlockBuffer, HD_BLOCK_SIZE);
+			pEntry->bDirty = true;
+		}
+
+		if (bGrowImageBuffer)
+			pImageInfo->uImageSize = Offset+HD_BLOCK_SIZE;
 	}
-	else if (pImageInfo->FileType == eFileZip)
+	else if (pImageInfo->FileType == eFileGZip || pImageInfo->FileType == eFileZip)
 	{
-		// Write entire compressed image each time a block is written
-		// NB. Only support Zip archives with a single file
-		zipFile hZipFile = zipOpen(pImageInfo->szFilename, APPEND_STATUS_CREATE);
-		if (hZipFile == NULL)
-			return false;
+		// Recompressing the entire image is left to the write-back thread (once the image is idle) - see WriteTrack()
+		EnterCriticalSection(&g_WriteBackCS);
 
-		int nRes = zipOpenNewFileInZip(hZipFile, pImageInfo->szFilenameInZip, &pImageInfo->zipFileInfo, NULL, 0, NULL, 0, NULL, Z_DEFLATED, Z_BEST_SPEED);
-		if (nRes != ZIP_OK)
-			return false;
+		if (bGrowImageBuffer)
+		{
+			// Grow in one go (zero-filled), however far past the end the block is
+			const UINT uNewImageSize = Offset+HD_BLOCK_SIZE;
+			BYTE* pNewImageBuffer = new BYTE [uNewImageSize];
 
-		nRes = zipWriteInFileInZip(hZipFile, pImageInfo->pImageBuffer, pImageInfo->uImageSize);
-		if (nRes != ZIP_OK)
-			return false;
+			memcpy(pNewImageBuffer, pImageInfo->pImageBuffer, pImageInfo->uImageSize);
+			memset(&pNewImageBuffer[pImageInfo->uImageSize], 0, uNewImageSize-pImageInfo->uImageSize);
 
-		nRes = zipCloseFileInZip(hZipFile);
-		if (nRes != ZIP_OK)
-			return false;
+			delete [] pImageInfo->pImageBuffer;
+			pImageInfo->pImageBuffer = pNewImageBuffer;
+			pImageInfo->uImageSize = uNewImageSize;
+		}
 
-		nRes = zipClose(hZipFile, NULL);
-		if (nRes != ZIP_OK)
-			return false;
+		memcpy(&pImageInfo->pImageBuffer[Offset], pBlockBuffer, HD_BLOCK_SIZE);
+		pImageInfo->bDirtyImage = true;
+		QueueWriteBack(pImageInfo);
+
+		LeaveCriticalSection(&g_WriteBackCS);
+
+		SignalWriteBack(pImageInfo);
 	}
 	else
 	{
@@ -547,6 +1044,35 @@ DWORD CImageBase::NibblizeTrack(LPBYTE trackimagebuffer, SectorOrder_e SectorOrd
 
 //-------------------------------------
 
+// Head stepping back & forth (eg. RWTS seeks, copy-protection) would otherwise re-nibblize the same tracks over & over
+// . The cached track is invalidated by WriteTrack()
+DWORD CImageBase::NibblizeTrackCached(ImageInfo* pImageInfo, LPBYTE trackimagebuffer, SectorOrder_e SectorOrder, int track)
+{
+	if (!pImageInfo->pTrackCache)
+		pImageInfo->pTrackCache = new BYTE [TRACKS_MAX * NIBBLES_PER_TRACK];
+
+	LPBYTE pCachedTrack = &pImageInfo->pTrackCache[track * NIBBLES_PER_TRACK];
+	DWORD dwNibbles = pImageInfo->TrackCacheNibbles[track];
+
+	if (dwNibbles)
+	{
+		pImageInfo->uTrackCacheHits++;
+	}
+	else
+	{
+		pImageInfo->uTrackCacheMisses++;
+		ReadTrack(pImageInfo, track, ms_pWorkBuffer, TRACK_DENIBBLIZED_SIZE);
+		dwNibbles = NibblizeTrack(pCachedTrack, SectorOrder, track);
+		_ASSERT(dwNibbles <= NIBBLES_PER_TRACK);
+		pImageInfo->TrackCacheNibbles[track] = (WORD) dwNibbles;
+	}
+
+	CopyMemory(trackimagebuffer, pCachedTrack, dwNibbles);	// NB. Disk.cpp writes into its track buffer, so it can't alias the cache
+	return dwNibbles;
+}
+
+//-------------------------------------
+
 void CImageBase::SkewTrack(const int nTrack, const int nNumNibbles, const LPBYTE pTrackImageBuffer)
 {
 	int nSkewBytes = (nTrack*768) % nNumNibbles;
@@ -633,8 +1159,7 @@ public:
 
 	virtual void Read(ImageInfo* pImageInfo, int nTrack, int nQuarterTrack, LPBYTE pTrackImageBuffer, int* pNibbles)
 	{
-		ReadTrack(pImageInfo, nTrack, ms_pWorkBuffer, TRACK_DENIBBLIZED_SIZE);
-		*pNibbles = NibblizeTrack(pTrackImageBuffer, eDOSOrder, nTrack);
+		*pNibbles = NibblizeTrackCached(pImageInfo, pTrackImageBuffer, eDOSOrder, nTrack);
 		if (!Disk_GetEnhanceDisk())
 			SkewTrack(nTrack, *pNibbles, pTrackImageBuffer);
 	}
@@ -699,8 +1224,7 @@ public:
 
 	virtual void Read(ImageInfo* pImageInfo, int nTrack, int nQuarterTrack, LPBYTE pTrackImageBuffer, int* pNibbles)
 	{
-		ReadTrack(pImageInfo, nTrack, ms_pWorkBuffer, TRACK_DENIBBLIZED_SIZE);
-		*pNibbles = NibblizeTrack(pTrackImageBuffer, eProDOSOrder, nTrack);
+		*pNibbles = NibblizeTrackCached(pImageInfo, pTrackImageBuffer, eProDOSOrder, nTrack);
 		if (!Disk_GetEnhanceDisk())
 			SkewTrack(nTrack, *pNibbles, pTrackImageBuffer);
 	}
@@ -929,6 +1453,15 @@ private:
 
 //-------------------------------------
 
+// Load a program into 6502 memory as the current paging sees it (not into mem[], which may be a stale view: see MEM_NOCOPY_PAGING)
+static void CopyToMemory(const WORD address, const BYTE* pData, const UINT uLength)
+{
+	for (UINT i=0; i<uLength; i++)
+		WriteByteToMemory(address+i, pData[i]);
+}
+
+//-------------------------------------
+
 // RAW PROGRAM IMAGE (APL) FORMAT IMPLEMENTATION
 class CAplImage : public CImageBase
 {
@@ -951,10 +1484,9 @@ public:
 			return false;
 		}
 
-		ReadFile(ptr->hFile, mem+address, length, &bytesread, NULL);
-		int loop = 192;
-		while (loop--)
-			*(memdirty+loop) = 0xFF;
+		std::vector<BYTE> vData(length);
+		ReadFile(ptr->hFile, &vData[0], length, &bytesread, NULL);
+		CopyToMemory(address, &vData[0], length);
 
 		regs.pc = address;
 		return true;
@@ -1005,11 +1537,9 @@ public:
 		}
 
 		SetFilePointer(pImageInfo->hFile,128,NULL,FILE_BEGIN);
-		ReadFile(pImageInfo->hFile, mem+address, length, &bytesread, NULL);
-
-		int loop = 192;
-		while (loop--)
-			*(memdirty+loop) = 0xFF;
+		std::vector<BYTE> vData(length);
+		ReadFile(pImageInfo->hFile, &vData[0], length, &bytesread, NULL);
+		CopyToMemory(address, &vData[0], length);
 
 		regs.pc = address;
 		return true;
@@ -1188,7 +1718,12 @@ ImageError_e CImageHelperBase::CheckGZipFile(LPCTSTR pszImageFilename, ImageInfo
 
 	DWORD dwSize = nLen;
 	DWORD dwOffset = 0;
-	CImageBase* pImageType = Detect(pImageInfo->pImageBuffer, dwSize, szExt, dwOffset, &pImageInfo->bWriteProtected);
+	CImageBase* pImageType = DetectFromIndex(pszImageFilename, dwOffset, &pImageInfo->bWriteProtected);
+	if (!pImageType)
+	{
+		pImageType = Detect(pImageInfo->pImageBuffer, dwSize, szExt, dwOffset, &pImageInfo->bWriteProtected);
+		m_bDetected = true;
+	}
 
 	if (!pImageType)
 		return eIMAGE_ERROR_UNSUPPORTED;
@@ -1271,7 +1806,12 @@ ImageError_e CImageHelperBase::CheckZipFile(LPCTSTR pszImageFilename, ImageInfo*
 
 	DWORD dwSize = nLen;
 	DWORD dwOffset = 0;
-	CImageBase* pImageType = Detect(pImageInfo->pImageBuffer, dwSize, szExt, dwOffset, &pImageInfo->bWriteProtected);
+	CImageBase* pImageType = DetectFromIndex(pszImageFilename, dwOffset, &pImageInfo->bWriteProtected);
+	if (!pImageType)
+	{
+		pImageType = Detect(pImageInfo->pImageBuffer, dwSize, szExt, dwOffset, &pImageInfo->bWriteProtected);
+		m_bDetected = true;
+	}
 
 	if (!pImageType)
 	{
@@ -1361,22 +1901,33 @@ ImageError_e CImageHelperBase::CheckNormalFile(LPCTSTR pszImageFilename, ImageIn
 		bool bTempDetectBuffer;
 		const UINT uDetectSize = GetMinDetectSize(dwSize, &bTempDetectBuffer);
 
-		pImageInfo->pImageBuffer = new BYTE [dwSize];
+		pImageType = DetectFromIndex(pszImageFilename, dwOffset, &pImageInfo->bWriteProtected);
 
-		DWORD dwBytesRead;
-		BOOL bRes = ReadFile(hFile, pImageInfo->pImageBuffer, dwSize, &dwBytesRead, NULL);
-		if (!bRes || dwSize != dwBytesRead)
+		// A temp detect buffer is only needed by Detect(), so an indexed harddisk image isn't read at all
+		if (!pImageType || !bTempDetectBuffer)
 		{
-			delete [] pImageInfo->pImageBuffer;
-			pImageInfo->pImageBuffer = NULL;
-			return eIMAGE_ERROR_BAD_SIZE;
-		}
+			pImageInfo->pImageBuffer = new BYTE [dwSize];
 
-		pImageType = Detect(pImageInfo->pImageBuffer, dwSize, szExt, dwOffset, &pImageInfo->bWriteProtected);
-		if (bTempDetectBuffer)
-		{
-			delete [] pImageInfo->pImageBuffer;
-			pImageInfo->pImageBuffer = NULL;
+			DWORD dwBytesRead;
+			BOOL bRes = ReadFile(hFile, pImageInfo->pImageBuffer, dwSize, &dwBytesRead, NULL);
+			if (!bRes || dwSize != dwBytesRead)
+			{
+				delete [] pImageInfo->pImageBuffer;
+				pImageInfo->pImageBuffer = NULL;
+				return eIMAGE_ERROR_BAD_SIZE;
+			}
+
+			if (!pImageType)
+			{
+				pImageType = Detect(pImageInfo->pImageBuffer, dwSize, szExt, dwOffset, &pImageInfo->bWriteProtected);
+				m_bDetected = true;
+			}
+
+			if (bTempDetectBuffer)
+			{
+				delete [] pImageInfo->pImageBuffer;
+				pImageInfo->pImageBuffer = NULL;
+			}
 		}
 	}
 	else	// Create (or pre-existing zero-length file)
@@ -1435,13 +1986,11 @@ ImageError_e CImageHelperBase::CheckNormalFile(LPCTSTR pszImageFilename, ImageIn
 
 //-------------------------------------
 
-ImageError_e CImageHelperBase::Open(	LPCTSTR pszImageFilename,
-										ImageInfo* pImageInfo,
-										const bool bCreateIfNecessary,
-										std::string& strFilenameInZip)
+ImageError_e CImageHelperBase::CheckFile(	LPCTSTR pszImageFilename,
+											ImageInfo* pImageInfo,
+											const bool bCreateIfNecessary,
+											std::string& strFilenameInZip)
 {
-	pImageInfo->hFile = INVALID_HANDLE_VALUE;
-
 	ImageError_e Err;
     const size_t uStrLen = strlen(pszImageFilename);
 
@@ -1461,6 +2010,20 @@ ImageError_e CImageHelperBase::Open(	LPCTSTR pszImageFilename,
 	if (pImageInfo->pImageType == NULL && Err == eIMAGE_ERROR_NONE)
 		Err = eIMAGE_ERROR_UNSUPPORTED;
 
+	return Err;
+}
+
+//-------------------------------------
+
+ImageError_e CImageHelperBase::Open(	LPCTSTR pszImageFilename,
+										ImageInfo* pImageInfo,
+										const bool bCreateIfNecessary,
+										std::string& strFilenameInZip)
+{
+	pImageInfo->hFile = INVALID_HANDLE_VALUE;
+	m_bDetected = false;
+
+	ImageError_e Err = CheckFile(pszImageFilename, pImageInfo, bCreateIfNecessary, strFilenameInZip);
 	if (Err != eIMAGE_ERROR_NONE)
 		return Err;
 
@@ -1468,13 +2031,110 @@ ImageError_e CImageHelperBase::Open(	LPCTSTR pszImageFilename,
 	if (uNameLen == 0 || uNameLen >= MAX_PATH)
 		Err = eIMAGE_ERROR_FAILED_TO_GET_PATHNAME;
 
+	// Remember what Detect() found, so that the next open of this (unchanged) image can skip it
+	if (m_bUseIndex && m_bDetected)
+	{
+		ImageIndexEntry entry;
+		if (ImageIndexGetFileKey(pszImageFilename, entry.strPathname, entry.uFileSize, entry.uLastWriteTime))
+		{
+			GetIndexEntry(pszImageFilename, pImageInfo, eIMAGE_ERROR_NONE, entry);
+			ImageIndexUpdate(entry);
+		}
+	}
+
 	return eIMAGE_ERROR_NONE;
 }
 
 //-------------------------------------
 
+// Run the detectors over an image without keeping it open (see ImageIndexScan())
+// . Pre: entry's key (pathname, file size & last-write time) is already set
+ImageError_e CImageHelperBase::Identify(LPCTSTR pszImageFilename, ImageIndexEntry& entry)
+{
+	ImageInfo imageInfo;
+	ZeroMemory(&imageInfo, sizeof(imageInfo));
+	imageInfo.hFile = INVALID_HANDLE_VALUE;
+	imageInfo.bWriteProtected = true;	// Open read-only (so never create)
+
+	const bool bUseIndex = m_bUseIndex;
+	m_bUseIndex = false;
+	m_Result2IMG = eMismatch;
+
+	std::string strFilenameInZip;
+	const ImageError_e Err = CheckFile(pszImageFilename, &imageInfo, false, strFilenameInZip);
+	GetIndexEntry(pszImageFilename, &imageInfo, Err, entry);
+
+	m_bUseIndex = bUseIndex;
+
+	if (imageInfo.hFile != INVALID_HANDLE_VALUE)
+		CloseHandle(imageInfo.hFile);
+
+	delete [] imageInfo.pImageBuffer;
+
+	return Err;
+}
+
+// Replay the side-effects of a previous Detect() of this (unchanged) image
+CImageBase* CImageHelperBase::DetectFromIndex(LPCTSTR pszImageFilename, DWORD& dwOffset, bool* pWriteProtected_)
+{
+	ImageIndexEntry entry;
+	if (!m_bUseIndex || !ImageIndexLookup(pszImageFilename, m_bIsFloppy, entry) || entry.Error != eIMAGE_ERROR_NONE)
+		return NULL;
+
+	CImageBase* pImageType = GetImage(entry.ImageType);
+	if (!pImageType)
+		return NULL;
+
+	if (m_bIsFloppy)
+	{
+		pImageType->m_uNumTracksInImage = entry.uNumTracks;
+		pImageType->SetVolumeNumber(entry.uVolumeNumber);
+	}
+
+	if (entry.b2IMGLocked && !*pWriteProtected_)
+		*pWriteProtected_ = 1;
+
+	dwOffset = entry.uOffset;
+	return pImageType;
+}
+
+void CImageHelperBase::GetIndexEntry(LPCTSTR pszImageFilename, ImageInfo* pImageInfo, const ImageError_e Err, ImageIndexEntry& entry)
+{
+	entry.bFloppy = m_bIsFloppy;
+	entry.Error = Err;
+	if (Err != eIMAGE_ERROR_NONE)
+		return;
+
+	CImageBase* pImageType = pImageInfo->pImageType;
+	entry.ImageType = pImageType->GetType();
+	entry.FileType = pImageInfo->FileType;
+	entry.uImageSize = pImageInfo->uImageSize;
+	entry.uOffset = pImageInfo->uOffset;
+	entry.uNumTracks = pImageType->m_uNumTracksInImage;
+	entry.uVolumeNumber = pImageType->GetVolumeNumber();
+	entry.uNumEntriesInZip = pImageInfo->uNumEntriesInZip;
+
+	entry.b2IMG = (m_Result2IMG == eMatch);
+	if (entry.b2IMG)
+	{
+		entry.b2IMGLocked = m_2IMGHelper.IsLocked();
+		entry.u2IMGCreatorID = m_2IMGHelper.GetCreatorID();
+		entry.u2IMGFormat = m_2IMGHelper.GetImageFormat();
+		entry.u2IMGFlags = m_2IMGHelper.GetFlags();
+		entry.u2IMGNumBlocks = m_2IMGHelper.GetNumBlocks();
+	}
+
+	const DWORD dwAttributes = GetFileAttributes(pszImageFilename);
+	const bool bReadOnlyFile = (dwAttributes != INVALID_FILE_ATTRIBUTES) && (dwAttributes & FILE_ATTRIBUTE_READONLY);
+	entry.bWriteProtected = bReadOnlyFile || entry.b2IMGLocked || (pImageInfo->uNumEntriesInZip > 1);
+}
+
+//-------------------------------------
+
 void CImageHelperBase::Close(ImageInfo* pImageInfo, const bool bDeleteFile)
 {
+	CImageBase::ReleaseBlockAccess(pImageInfo);
+
 	if (pImageInfo->hFile != INVALID_HANDLE_VALUE)
 	{
 		CloseHandle(pImageInfo->hFile);
@@ -1490,6 +2150,9 @@ void CImageHelperBase::Close(ImageInfo* pImageInfo, const bool bDeleteFile)
 
 	delete [] pImageInfo->pImageBuffer;
 	pImageInfo->pImageBuffer = NULL;
+
+	delete [] pImageInfo->pTrackCache;
+	pImageInfo->pTrackCache = NULL;
 }
 
 //-----------------------------------------------------------------------------
@@ -15,6 +15,7 @@ enum eDetectResult {eMismatch, ePossibleMatch, eMatch};
 
 class CImageBase;
 class CImageHelperBase;
+struct ImageIndexEntry;
 
 enum FileType_e {eFileNormal, eFileGZip, eFileZip};
 
@@ -35,6 +36,23 @@ struct ImageInfo
 	BYTE			ValidTrack[TRACKS_MAX];
 	UINT			uNumTracks;
 	BYTE*			pImageBuffer;
+	// Floppy & gz/zip hard disk: write-back state (guarded by the write-back critical section)
+	BYTE			DirtyTrack[TRACKS_MAX];	// eFileNormal: track needs writing to hFile
+	UINT			uDirtyTrackSize;
+	bool			bDirtyImage;			// eFileGZip/eFileZip: whole image needs recompressing
+	bool			bWriteBackQueued;
+	DWORD			dwLastWriteTime;		// GetTickCount() of the most recent WriteTrack()
+	// Floppy only: cache of nibblized (unskewed) tracks for DO/PO images - see NibblizeTrackCached()
+	BYTE*			pTrackCache;			// TRACKS_MAX * NIBBLES_PER_TRACK, allocated on first use
+	WORD			TrackCacheNibbles[TRACKS_MAX];	// 0 = not cached
+	UINT			uTrackCacheHits;
+	UINT			uTrackCacheMisses;
+	// Hard disk only (eFileNormal): block access - see InitBlockAccess()
+	bool			bBlockAccessInit;
+	UINT			uFileSize;
+	HANDLE			hMapping;
+	BYTE*			pMappedImage;			// View of the whole file (so includes uOffset)
+	struct HDBlockCache* pBlockCache;		// Only if the file couldn't be mapped
 };
 
 //-------------------------------------
@@ -69,13 +87,17 @@ public:
 	virtual const char* GetRejectExtensions(void) = 0;
 
 	void SetVolumeNumber(const BYTE uVolumeNumber) { m_uVolumeNumber = uVolumeNumber; }
+	BYTE GetVolumeNumber(void) { return m_uVolumeNumber; }
+
+	bool ReadSector(ImageInfo* pImageInfo, const int nTrack, const int nPhysicalSector, LPBYTE pSectorBuffer);
+	bool WriteSector(ImageInfo* pImageInfo, const int nTrack, const int nPhysicalSector, LPBYTE pSectorBuffer);
 	bool IsValidImageSize(const DWORD uImageSize);
 
 	enum SectorOrder_e {eProDOSOrder, eDOSOrder, eSIMSYSTEMOrder, NUM_SECTOR_ORDERS};
 
 protected:
 	bool ReadTrack(ImageInfo* pImageInfo, const int nTrack, LPBYTE pTrackBuffer, const UINT uTrackSize);
-	bool WriteTrack(ImageInfo* pImageInfo, const int nTrack, LPBYTE pTrackBuffer, const UINT uTrackSize);
+	bool WriteTrack(ImageInfo* pImageInfo, const int nTrack, LPBYTE pTrackBuffer, const UINT uTrackSize);	// Async: see WriteBack*()
 	bool ReadBlock(ImageInfo* pImageInfo, const int nBlock, LPBYTE pBlockBuffer);
 	bool WriteBlock(ImageInfo* pImageInfo, const int nBlock, LPBYTE pBlockBuffer);
 
@@ -83,9 +105,15 @@ protected:
 	void Decode62(LPBYTE imageptr);
 	void DenibblizeTrack (LPBYTE trackimage, SectorOrder_e SectorOrder, int nibbles);
 	DWORD NibblizeTrack (LPBYTE trackimagebuffer, SectorOrder_e SectorOrder, int track);
+	DWORD NibblizeTrackCached (ImageInfo* pImageInfo, LPBYTE trackimagebuffer, SectorOrder_e SectorOrder, int track);
 	void SkewTrack (const int nTrack, const int nNumNibbles, const LPBYTE pTrackImageBuffer);
 
 public:
+	static void WriteBackInitialize(void);
+	static void WriteBackDestroy(void);
+	static void WriteBackFlush(ImageInfo* pImageInfo);
+	static void ReleaseBlockAccess(ImageInfo* pImageInfo);
+
 	static LPBYTE ms_pWorkBuffer;
 	UINT m_uNumTracksInImage;	// Init'd by CDiskImageHelper.Detect()/GetImageForCreation() & possibly updated by IsValidImageSize()
 
@@ -135,6 +163,10 @@ public:
 	bool IsLocked(void);
 	bool IsImageFormatDOS33(void) { return m_Hdr.ImageFormat == e2IMGFormatDOS33; }
 	bool IsImageFormatProDOS(void) { return m_Hdr.ImageFormat == e2IMGFormatProDOS; }
+	UINT32 GetCreatorID(void) { return m_Hdr.CreatorID; }
+	UINT32 GetImageFormat(void) { return m_Hdr.ImageFormatRaw; }
+	UINT32 GetFlags(void) { return m_Hdr.FlagsRaw; }
+	UINT32 GetNumBlocks(void) { return m_Hdr.NumBlocks; }
 
 private:
 	static const UINT32 FormatID_2IMG = 'GMI2';			// '2IMG'
@@ -190,7 +222,10 @@ class CImageHelperBase
 public:
 	CImageHelperBase(const bool bIsFloppy) :
 		m_2IMGHelper(bIsFloppy),
-		m_Result2IMG(eMismatch)
+		m_Result2IMG(eMismatch),
+		m_bIsFloppy(bIsFloppy),
+		m_bUseIndex(true),
+		m_bDetected(false)
 	{
 	}
 	virtual ~CImageHelperBase(void)
@@ -201,6 +236,7 @@ public:
 
 	ImageError_e Open(LPCTSTR pszImageFilename, ImageInfo* pImageInfo, const bool bCreateIfNecessary, std::string& strFilenameInZip);
 	void Close(ImageInfo* pImageInfo, const bool bDeleteFile);
+	ImageError_e Identify(LPCTSTR pszImageFilename, ImageIndexEntry& entry);
 
 	virtual CImageBase* Detect(LPBYTE pImage, DWORD dwSize, const TCHAR* pszExt, DWORD& dwOffset, bool* pWriteProtected_) = 0;
 	virtual CImageBase* GetImageForCreation(const TCHAR* pszExt, DWORD* pCreateImageSize) = 0;
@@ -208,9 +244,12 @@ public:
 	virtual UINT GetMinDetectSize(const UINT uImageSize, bool* pTempDetectBuffer) = 0;
 
 protected:
+	ImageError_e CheckFile(LPCTSTR pszImageFilename, ImageInfo* pImageInfo, const bool bCreateIfNecessary, std::string& strFilenameInZip);
 	ImageError_e CheckGZipFile(LPCTSTR pszImageFilename, ImageInfo* pImageInfo);
 	ImageError_e CheckZipFile(LPCTSTR pszImageFilename, ImageInfo* pImageInfo, std::string& strFilenameInZip);
 	ImageError_e CheckNormalFile(LPCTSTR pszImageFilename, ImageInfo* pImageInfo, const bool bCreateIfNecessary);
+	CImageBase* DetectFromIndex(LPCTSTR pszImageFilename, DWORD& dwOffset, bool* pWriteProtected_);
+	void GetIndexEntry(LPCTSTR pszImageFilename, ImageInfo* pImageInfo, const ImageError_e Err, ImageIndexEntry& entry);
 
 	UINT GetNumImages(void) { return m_vecImageTypes.size(); };
 	CImageBase* GetImage(UINT uIndex) { _ASSERT(uIndex<GetNumImages()); return m_vecImageTypes[uIndex]; }
@@ -233,6 +272,10 @@ protected:
 
 	C2IMGHelper m_2IMGHelper;
 	eDetectResult m_Result2IMG;
+
+	const bool m_bIsFloppy;
+	bool m_bUseIndex;	// Open() consults & updates the image index (see DiskImageIndex.cpp)
+	bool m_bDetected;	// Detect() was called (ie. not answered by the index)
 };
 
 //-------------------------------------
@@ -274,3 +317,7 @@ public:
 	virtual UINT GetMaxImageSize(void);
 	virtual UINT GetMinDetectSize(const UINT uImageSize, bool* pTempDetectBuffer);
 };
+
+//-------------------------------------
+
+void GetCharLowerExt(TCHAR* pszExt, LPCTSTR pszImageFilename, const UINT uExtSize);
@@ -0,0 +1,568 @@
+/*
+AppleWin : An Apple //e emulator for Windows
+
+Copyright (C) 1994-1996, Michael O'Brien
+Copyright (C) 1999-2001, Oliver Schmidt
+Copyright (C) 2002-2005, Tom Charlesworth
+Copyright (C) 2006-2019, Tom Charlesworth, Michael Pohoreski, Nick Westgate
+
+AppleWin is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+AppleWin is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with AppleWin; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+*/
+
+/* Description: Disk Image Index
+ *
+ * Persistent cache of image detection results, keyed by pathname, file size & last-write time.
+ * . Populated by ImageIndexScan() (a directory tree, on a pool of worker threads) and by ImageOpen()
+ *   - ImageIndexStartScan() runs the scan in the background, so Open() may see a partial index: a miss just runs Detect()
+ * . Consulted by CImageHelperBase::Open() so that an unchanged image skips Detect()
+ */
+
+#include "StdAfx.h"
+
+#include "Applewin.h"
+#include "DiskImageIndex.h"
+#include "Log.h"
+
+#define IMAGE_INDEX_FILENAME "DiskImageIndex.dat"
+#define IMAGE_INDEX_EXTENSIONS ".do;.dsk;.nib;.po;.2mg;.2img;.hdv;.iie;.apl;.prg;.gz;.zip"
+
+typedef std::map<std::string, ImageIndexEntry> IndexMap;	// Key: lowercase full pathname
+
+static CRITICAL_SECTION g_IndexCS;		// Guards g_Index[] & g_bIndexDirty (the scan's worker threads update the index)
+static bool g_bIndexInit = false;
+static IndexMap g_Index[2];				// [0]=floppy, [1]=harddisk
+static bool g_bIndexDirty = false;
+static std::string g_strIndexFilename;
+
+static HANDLE g_hIndexScanThread = NULL;		// Background scan (see ImageIndexStartScan())
+static std::string g_strIndexScanDirectory;
+static volatile LONG g_bIndexScanAbort = FALSE;	// Set on shutdown: the scan's worker threads stop after their current file
+
+//-----------------------------------------------------------------------------
+
+// On-disk format: IndexFileHeader, then NumEntries x (IndexFileRecord + pathname)
+
+#pragma pack(push)
+#pragma pack(1)
+
+struct IndexFileHeader
+{
+	UINT32	FormatID;
+	UINT32	Version;
+	UINT32	NumEntries;
+};
+
+struct IndexFileRecord
+{
+	UINT64	FileSize;
+	UINT64	LastWriteTime;
+	UINT32	ImageSize;
+	UINT32	Offset;
+	UINT32	CreatorID2IMG;
+	UINT32	Format2IMG;
+	UINT32	Flags2IMG;
+	UINT32	NumBlocks2IMG;
+	UINT32	NumEntriesInZip;
+	UINT16	PathnameLength;
+	BYTE	Floppy;
+	BYTE	Error;
+	BYTE	ImageType;
+	BYTE	FileType;
+	BYTE	NumTracks;
+	BYTE	VolumeNumber;
+	BYTE	Flags;
+};
+
+#pragma pack(pop)
+
+static const UINT32 kIndexFormatID = 'XIWA';	// 'AWIX'
+static const UINT32 kIndexVersion = 1;
+
+enum
+{
+	INDEX_FLAG_WRITEPROTECTED = 1<<0,
+	INDEX_FLAG_2IMG = 1<<1,
+	INDEX_FLAG_2IMG_LOCKED = 1<<2,
+};
+
+//===========================================================================
+
+static std::string GetIndexKey(const std::string& strPathname)
+{
+	std::string strKey(strPathname);
+	if (!strKey.empty())
+		CharLowerBuff(&strKey[0], strKey.length());
+	return strKey;
+}
+
+// Full pathname, file size & last-write time: an index entry is only used if all three still match
+bool ImageIndexGetFileKey(LPCTSTR pszImageFilename, std::string& strPathname, UINT64& uFileSize, UINT64& uLastWriteTime)
+{
+	TCHAR szPathname[MAX_PATH];
+	DWORD uNameLen = GetFullPathName(pszImageFilename, MAX_PATH, szPathname, NULL);
+	if (uNameLen == 0 || uNameLen >= MAX_PATH)
+		return false;
+
+	WIN32_FILE_ATTRIBUTE_DATA attr;
+	if (!GetFileAttributesEx(szPathname, GetFileExInfoStandard, &attr) || (attr.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY))
+		return false;
+
+	strPathname = szPathname;
+	uFileSize = ((UINT64)attr.nFileSizeHigh << 32) | attr.nFileSizeLow;
+	uLastWriteTime = ((UINT64)attr.ftLastWriteTime.dwHighDateTime << 32) | attr.ftLastWriteTime.dwLowDateTime;
+	return true;
+}
+
+//===========================================================================
+
+bool ImageIndexLookup(LPCTSTR pszImageFilename, const bool bFloppy, ImageIndexEntry& entry)
+{
+	if (!g_bIndexInit)
+		return false;
+
+	std::string strPathname;
+	UINT64 uFileSize, uLastWriteTime;
+	if (!ImageIndexGetFileKey(pszImageFilename, strPathname, uFileSize, uLastWriteTime))
+		return false;
+
+	const std::string strKey = GetIndexKey(strPathname);
+	bool bFound = false;
+
+	EnterCriticalSection(&g_IndexCS);
+	{
+		const IndexMap& index = g_Index[bFloppy ? 0 : 1];
+		IndexMap::const_iterator it = index.find(strKey);
+		if (it != index.end() && it->second.uFileSize == uFileSize && it->second.uLastWriteTime == uLastWriteTime)
+		{
+			entry = it->second;
+			bFound = true;
+		}
+	}
+	LeaveCriticalSection(&g_IndexCS);
+
+	return bFound;
+}
+
+void ImageIndexUpdate(const ImageIndexEntry& entry)
+{
+	if (!g_bIndexInit)
+		return;
+
+	const std::string strKey = GetIndexKey(entry.strPathname);
+
+	EnterCriticalSection(&g_IndexCS);
+	{
+		g_Index[entry.bFloppy ? 0 : 1][strKey] = entry;
+		g_bIndexDirty = true;
+	}
+	LeaveCriticalSection(&g_IndexCS);
+}
+
+// Catalog query: all successfully detected images under pszDirectory (or the whole index if NULL)
+// . Used by the debugger's DISK INDEX command
+UINT ImageIndexGetEntries(LPCTSTR pszDirectory, const bool bFloppy, std::vector<ImageIndexEntry>& vecEntries)
+{
+	if (!g_bIndexInit)
+		return 0;
+
+	std::string strPrefix;
+	if (pszDirectory)
+	{
+		TCHAR szDirectory[MAX_PATH];
+		DWORD uNameLen = GetFullPathName(pszDirectory, MAX_PATH, szDirectory, NULL);
+		if (uNameLen == 0 || uNameLen >= MAX_PATH)
+			return 0;
+		strPrefix = GetIndexKey(szDirectory);
+		if (strPrefix[strPrefix.length()-1] != '\\')
+			strPrefix += '\\';	// So that "dir" doesn't match "dir2\..."
+	}
+
+	const size_t uStart = vecEntries.size();
+
+	EnterCriticalSection(&g_IndexCS);
+	{
+		const IndexMap& index = g_Index[bFloppy ? 0 : 1];
+		for (IndexMap::const_iterator it = index.lower_bound(strPrefix); it != index.end(); ++it)
+		{
+			if (it->first.compare(0, strPrefix.length(), strPrefix) != 0)
+				break;	// Sorted by pathname, so past the end of the directory
+
+			if (it->second.Error == eIMAGE_ERROR_NONE)
+				vecEntries.push_back(it->second);
+		}
+	}
+	LeaveCriticalSection(&g_IndexCS);
+
+	return vecEntries.size() - uStart;
+}
+
+//===========================================================================
+
+bool ImageIndexLoad(LPCTSTR pszIndexFilename)
+{
+	FILE* hFile = fopen(pszIndexFilename, "rb");
+	if (hFile == NULL)
+		return false;
+
+	IndexMap index[2];
+	bool bRes = false;
+
+	IndexFileHeader hdr;
+	if (fread(&hdr, sizeof(hdr), 1, hFile) == 1 && hdr.FormatID == kIndexFormatID && hdr.Version == kIndexVersion)
+	{
+		UINT i;
+		for (i = 0; i < hdr.NumEntries; i++)
+		{
+			IndexFileRecord rec;
+			if (fread(&rec, sizeof(rec), 1, hFile) != 1 || rec.PathnameLength == 0 || rec.PathnameLength >= MAX_PATH)
+				break;
+
+			TCHAR szPathname[MAX_PATH];
+			if (fread(szPathname, rec.PathnameLength, 1, hFile) != 1)
+				break;
+			szPathname[rec.PathnameLength] = 0;
+
+			ImageIndexEntry entry;
+			entry.strPathname		= szPathname;
+			entry.bFloppy			= rec.Floppy != 0;
+			entry.uFileSize			= rec.FileSize;
+			entry.uLastWriteTime	= rec.LastWriteTime;
+			entry.Error				= (ImageError_e) rec.Error;
+			entry.ImageType			= (eImageType) rec.ImageType;
+			entry.FileType			= (FileType_e) rec.FileType;
+			entry.uImageSize		= rec.ImageSize;
+			entry.uOffset			= rec.Offset;
+			entry.uNumTracks		= rec.NumTracks;
+			entry.uVolumeNumber		= rec.VolumeNumber;
+			entry.bWriteProtected	= (rec.Flags & INDEX_FLAG_WRITEPROTECTED) != 0;
+			entry.b2IMG				= (rec.Flags & INDEX_FLAG_2IMG) != 0;
+			entry.b2IMGLocked		= (rec.Flags & INDEX_FLAG_2IMG_LOCKED) != 0;
+			entry.u2IMGCreatorID	= rec.CreatorID2IMG;
+			entry.u2IMGFormat		= rec.Format2IMG;
+			entry.u2IMGFlags		= rec.Flags2IMG;
+			entry.u2IMGNumBlocks	= rec.NumBlocks2IMG;
+			entry.uNumEntriesInZip	= rec.NumEntriesInZip;
+
+			if (entry.ImageType > eImagePRG || entry.FileType > eFileZip)
+				break;
+
+			index[entry.bFloppy ? 0 : 1][GetIndexKey(entry.strPathname)] = entry;
+		}
+
+		bRes = (i == hdr.NumEntries);
+	}
+
+	fclose(hFile);
+
+	if (!bRes)
+	{
+		LogFileOutput("ImageIndexLoad: corrupt index, ignoring: %s\n", pszIndexFilename);
+		return false;
+	}
+
+	EnterCriticalSection(&g_IndexCS);
+	{
+		g_Index[0].swap(index[0]);
+		g_Index[1].swap(index[1]);
+		g_bIndexDirty = false;
+	}
+	LeaveCriticalSection(&g_IndexCS);
+
+	return true;
+}
+
+bool ImageIndexSave(LPCTSTR pszIndexFilename)
+{
+	FILE* hFile = fopen(pszIndexFilename, "wb");
+	if (hFile == NULL)
+		return false;
+
+	bool bRes = true;
+
+	EnterCriticalSection(&g_IndexCS);
+	{
+		IndexFileHeader hdr;
+		hdr.FormatID = kIndexFormatID;
+		hdr.Version = kIndexVersion;
+		hdr.NumEntries = g_Index[0].size() + g_Index[1].size();
+		bRes = fwrite(&hdr, sizeof(hdr), 1, hFile) == 1;
+
+		for (UINT i = 0; i < 2 && bRes; i++)
+		{
+			for (IndexMap::const_iterator it = g_Index[i].begin(); it != g_Index[i].end() && bRes; ++it)
+			{
+				const ImageIndexEntry& entry = it->second;
+
+				IndexFileRecord rec;
+				rec.FileSize		= entry.uFileSize;
+				rec.LastWriteTime	= entry.uLastWriteTime;
+				rec.ImageSize		= entry.uImageSize;
+				rec.Offset			= entry.uOffset;
+				rec.CreatorID2IMG	= entry.u2IMGCreatorID;
+				rec.Format2IMG		= entry.u2IMGFormat;
+				rec.Flags2IMG		= entry.u2IMGFlags;
+				rec.NumBlocks2IMG	= entry.u2IMGNumBlocks;
+				rec.NumEntriesInZip	= entry.uNumEntriesInZip;
+				rec.PathnameLength	= (UINT16) entry.strPathname.length();
+				rec.Floppy			= entry.bFloppy ? 1 : 0;
+				rec.Error			= (BYTE) entry.Error;
+				rec.ImageType		= (BYTE) entry.ImageType;
+				rec.FileType		= (BYTE) entry.FileType;
+				rec.NumTracks		= (BYTE) entry.uNumTracks;
+				rec.VolumeNumber	= entry.uVolumeNumber;
+				rec.Flags			= (entry.bWriteProtected ? INDEX_FLAG_WRITEPROTECTED : 0)
+									| (entry.b2IMG ? INDEX_FLAG_2IMG : 0)
+									| (entry.b2IMGLocked ? INDEX_FLAG_2IMG_LOCKED : 0);
+
+				bRes = fwrite(&rec, sizeof(rec), 1, hFile) == 1 &&
+						fwrite(entry.strPathname.c_str(), rec.PathnameLength, 1, hFile) == 1;
+			}
+		}
+
+		if (bRes)
+			g_bIndexDirty = false;
+	}
+	LeaveCriticalSection(&g_IndexCS);
+
+	if (fclose(hFile) != 0)
+		bRes = false;
+
+	if (!bRes)
+		LogFileOutput("ImageIndexSave: failed to write: %s\n", pszIndexFilename);
+
+	return bRes;
+}
+
+//===========================================================================
+
+struct IndexScanJob
+{
+	std::vector<ImageIndexEntry> vecFiles;	// Keys only (pathname, size & last-write time)
+	volatile LONG nNext;
+};
+
+static void FindImageFiles(const std::string& strDirectory, std::vector<ImageIndexEntry>& vecFiles)
+{
+	WIN32_FIND_DATA findData;
+	HANDLE hFind = FindFirstFile((strDirectory + "*").c_str(), &findData);
+	if (hFind == INVALID_HANDLE_VALUE)
+		return;
+
+	do
+	{
+		if (strcmp(findData.cFileName, ".") == 0 || strcmp(findData.cFileName, "..") == 0)
+			continue;
+
+		const std::string strPathname = strDirectory + findData.cFileName;
+
+		if (findData.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY)
+		{
+			FindImageFiles(strPathname + "\\", vecFiles);
+			continue;
+		}
+
+		TCHAR szExt[_MAX_EXT] = "";
+		GetCharLowerExt(szExt, findData.cFileName, _MAX_EXT);
+		if (!*szExt || !_tcsstr(IMAGE_INDEX_EXTENSIONS, szExt))
+			continue;
+
+		ImageIndexEntry entry;
+		entry.strPathname = strPathname;
+		entry.uFileSize = ((UINT64)findData.nFileSizeHigh << 32) | findData.nFileSizeLow;
+		entry.uLastWriteTime = ((UINT64)findData.ftLastWriteTime.dwHighDateTime << 32) | findData.ftLastWriteTime.dwLowDateTime;
+		vecFiles.push_back(entry);
+	}
+	while (FindNextFile(hFind, &findData));
+
+	FindClose(hFind);
+}
+
+static bool IsIndexedAndCurrent(const ImageIndexEntry& file)
+{
+	bool bCurrent = false;
+
+	EnterCriticalSection(&g_IndexCS);
+	{
+		const IndexMap& index = g_Index[0];
+		IndexMap::const_iterator it = index.find(GetIndexKey(file.strPathname));
+		bCurrent = it != index.end() && it->second.uFileSize == file.uFileSize && it->second.uLastWriteTime == file.uLastWriteTime;
+	}
+	LeaveCriticalSection(&g_IndexCS);
+
+	return bCurrent;
+}
+
+static DWORD WINAPI IndexScanThread(LPVOID lpParameter)
+{
+	IndexScanJob* pJob = (IndexScanJob*) lpParameter;
+
+	// Per-thread helpers: Detect() keeps its results in the helper & its image types
+	CDiskImageHelper floppyHelper;
+	CHardDiskImageHelper hardDiskHelper;
+
+	while (!g_bIndexScanAbort)
+	{
+		const LONG n = InterlockedIncrement(&pJob->nNext) - 1;
+		if (n >= (LONG)pJob->vecFiles.size())
+			break;
+
+		const ImageIndexEntry& file = pJob->vecFiles[n];
+
+		ImageIndexEntry entry(file);
+		floppyHelper.Identify(file.strPathname.c_str(), entry);
+		ImageIndexUpdate(entry);
+
+		// A floppy helper can only identify a hard disk image as HDV (to reject it), so ask the hard disk helper too
+		if (entry.Error != eIMAGE_ERROR_NONE || entry.ImageType == eImageHDV)
+		{
+			ImageIndexEntry entryHD(file);
+			hardDiskHelper.Identify(file.strPathname.c_str(), entryHD);
+			ImageIndexUpdate(entryHD);
+		}
+	}
+
+	return 0;
+}
+
+// Detect every image file under pszDirectory (recursively) that isn't already in the index
+// . Returns the number of files that were (re-)detected
+UINT ImageIndexScan(LPCTSTR pszDirectory, UINT uNumThreads /*=0*/)
+{
+	if (!g_bIndexInit)
+		return 0;
+
+	const DWORD dwStartTime = GetTickCount();
+
+	TCHAR szDirectory[MAX_PATH];
+	DWORD uNameLen = GetFullPathName(pszDirectory, MAX_PATH, szDirectory, NULL);
+	if (uNameLen == 0 || uNameLen >= MAX_PATH)
+		return 0;
+
+	std::string strDirectory(szDirectory);
+	if (strDirectory[strDirectory.length()-1] != '\\')
+		strDirectory += '\\';
+
+	std::vector<ImageIndexEntry> vecFiles;
+	FindImageFiles(strDirectory, vecFiles);
+
+	IndexScanJob job;
+	job.nNext = 0;
+	for (UINT i = 0; i < vecFiles.size(); i++)
+	{
+		if (!IsIndexedAndCurrent(vecFiles[i]))
+			job.vecFiles.push_back(vecFiles[i]);
+	}
+
+	if (job.vecFiles.empty())
+		return 0;
+
+	if (uNumThreads == 0)
+	{
+		SYSTEM_INFO sysInfo;
+		GetSystemInfo(&sysInfo);
+		uNumThreads = sysInfo.dwNumberOfProcessors;
+	}
+	uNumThreads = MAX(1, MIN(uNumThreads, MIN((UINT)MAXIMUM_WAIT_OBJECTS, (UINT)job.vecFiles.size())));
+
+	std::vector<HANDLE> vecThreads;
+	for (UINT i = 0; i < uNumThreads; i++)
+	{
+		DWORD dwThreadId;
+		HANDLE hThread = CreateThread(NULL, 0, IndexScanThread, &job, 0, &dwThreadId);
+		if (hThread)
+		{
+			SetThreadPriority(hThread, THREAD_PRIORITY_BELOW_NORMAL);	// Don't compete with the emulation
+			vecThreads.push_back(hThread);
+		}
+	}
+
+	if (vecThreads.empty())
+		IndexScanThread(&job);	// Fall back to scanning on this thread
+	else
+		WaitForMultipleObjects(vecThreads.size(), &vecThreads[0], TRUE, INFINITE);
+
+	for (UINT i = 0; i < vecThreads.size(); i++)
+		CloseHandle(vecThreads[i]);
+
+	LogFileOutput("ImageIndexScan: %s: files=%d, detected=%d, threads=%d, time=%dms%s\n",
+		strDirectory.c_str(), vecFiles.size(), job.vecFiles.size(), vecThreads.size(), GetTickCount() - dwStartTime,
+		g_bIndexScanAbort ? " (aborted)" : "");
+
+	ImageIndexSave(g_strIndexFilename.c_str());	// Don't lose a long scan if we don't shut down cleanly
+
+	return job.vecFiles.size();
+}
+
+static DWORD WINAPI IndexScanBackgroundThread(LPVOID lpParameter)
+{
+	ImageIndexScan(g_strIndexScanDirectory.c_str());
+	return 0;
+}
+
+// Scan in the background, so that startup isn't blocked by a large directory tree
+// . Until the scan reaches an image, opening it just misses in the index (and runs Detect() as usual)
+bool ImageIndexStartScan(LPCTSTR pszDirectory)
+{
+	if (!g_bIndexInit || g_hIndexScanThread)
+		return false;
+
+	g_strIndexScanDirectory = pszDirectory;
+	InterlockedExchange(&g_bIndexScanAbort, FALSE);
+
+	DWORD dwThreadId;
+	g_hIndexScanThread = CreateThread(NULL,				// lpThreadAttributes
+										0,				// dwStackSize
+										IndexScanBackgroundThread,
+										NULL,			// lpParameter
+										0,				// dwCreationFlags : 0 = Run immediately
+										&dwThreadId);	// lpThreadId
+	LogFileOutput("ImageIndexStartScan: CreateThread(), g_hIndexScanThread=0x%08X\n", (UINT32)g_hIndexScanThread);
+
+	return g_hIndexScanThread != NULL;
+}
+
+//===========================================================================
+
+void ImageIndexInitialize(void)
+{
+	InitializeCriticalSection(&g_IndexCS);
+	g_bIndexInit = true;
+
+	g_strIndexFilename = std::string(g_sProgramDir) + IMAGE_INDEX_FILENAME;
+	ImageIndexLoad(g_strIndexFilename.c_str());
+}
+
+void ImageIndexDestroy(void)
+{
+	if (!g_bIndexInit)
+		return;
+
+	if (g_hIndexScanThread)
+	{
+		InterlockedExchange(&g_bIndexScanAbort, TRUE);
+		WaitForSingleObject(g_hIndexScanThread, INFINITE);
+		CloseHandle(g_hIndexScanThread);
+		g_hIndexScanThread = NULL;
+	}
+
+	if (g_bIndexDirty)
+		ImageIndexSave(g_strIndexFilename.c_str());
+
+	g_Index[0].clear();
+	g_Index[1].clear();
+
+	g_bIndexInit = false;
+	DeleteCriticalSection(&g_IndexCS);
+}
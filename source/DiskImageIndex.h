@@ -0,0 +1,85 @@
+#pragma once
+
+/*
+AppleWin : An Apple //e emulator for Windows
+
+Copyright (C) 1994-1996, Michael O'Brien
+Copyright (C) 1999-2001, Oliver Schmidt
+Copyright (C) 2002-2005, Tom Charlesworth
+Copyright (C) 2006-2019, Tom Charlesworth, Michael Pohoreski, Nick Westgate
+
+AppleWin is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+AppleWin is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with AppleWin; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+*/
+
+#include "DiskImage.h"			// ImageError_e
+#include "DiskImageHelper.h"	// eImageType, FileType_e
+
+// Result of running the image detectors over one file, as seen by either the floppy or the harddisk helper.
+// An entry is only valid while the file's size & last-write time still match.
+struct ImageIndexEntry
+{
+	ImageIndexEntry(void) :
+		bFloppy(true),
+		uFileSize(0),
+		uLastWriteTime(0),
+		Error(eIMAGE_ERROR_UNSUPPORTED),
+		ImageType(eImageUNKNOWN),
+		FileType(eFileNormal),
+		uImageSize(0),
+		uOffset(0),
+		uNumTracks(0),
+		uVolumeNumber(DEFAULT_VOLUME_NUMBER),
+		bWriteProtected(false),
+		b2IMG(false),
+		b2IMGLocked(false),
+		u2IMGCreatorID(0),
+		u2IMGFormat(0),
+		u2IMGFlags(0),
+		u2IMGNumBlocks(0),
+		uNumEntriesInZip(0)
+	{
+	}
+
+	std::string		strPathname;		// Key: full pathname
+	bool			bFloppy;			// Key: CDiskImageHelper or CHardDiskImageHelper
+	UINT64			uFileSize;			// Key: host file size
+	UINT64			uLastWriteTime;		// Key: host file FILETIME
+	ImageError_e	Error;
+	eImageType		ImageType;
+	FileType_e		FileType;
+	UINT			uImageSize;
+	DWORD			uOffset;			// MacBinary and/or 2IMG header size
+	UINT			uNumTracks;			// Floppy only
+	BYTE			uVolumeNumber;		// Floppy only
+	bool			bWriteProtected;	// Read-only file, locked 2IMG or multi-file zip
+	bool			b2IMG;
+	bool			b2IMGLocked;
+	UINT32			u2IMGCreatorID;
+	UINT32			u2IMGFormat;
+	UINT32			u2IMGFlags;
+	UINT32			u2IMGNumBlocks;
+	UINT			uNumEntriesInZip;
+};
+
+void ImageIndexInitialize(void);
+void ImageIndexDestroy(void);
+bool ImageIndexLoad(LPCTSTR pszIndexFilename);
+bool ImageIndexSave(LPCTSTR pszIndexFilename);
+UINT ImageIndexScan(LPCTSTR pszDirectory, UINT uNumThreads=0);
+bool ImageIndexStartScan(LPCTSTR pszDirectory);
+bool ImageIndexLookup(LPCTSTR pszImageFilename, const bool bFloppy, ImageIndexEntry& entry);
+void ImageIndexUpdate(const ImageIndexEntry& entry);
+UINT ImageIndexGetEntries(LPCTSTR pszDirectory, const bool bFloppy, std::vector<ImageIndexEntry>& vecEntries);
+bool ImageIndexGetFileKey(LPCTSTR pszImageFilename, std::string& strPathname, UINT64& uFileSize, UINT64& uLastWriteTime);
@@ -771,14 +771,14 @@ void FrameDrawDiskStatus( HDC passdc )
 	int nDisk2Track  = DiskGetTrack(1);
 	
 	// Probe known OS's for Track/Sector
-	int  isProDOS = mem[ 0xBF00 ] == 0x4C;
+	int  isProDOS = ReadByteFromMemory( 0xBF00 ) == 0x4C;
 	bool isValid  = true;
 
 	// Try DOS3.3 Sector
 	if ( !isProDOS )
 	{
-		int nDOS33track  = mem[ 0xB7EC ];
-		int nDOS33sector = mem[ 0xB7ED ];
+		int nDOS33track  = ReadByteFromMemory( 0xB7EC );
+		int nDOS33sector = ReadByteFromMemory( 0xB7ED );
 
 		if ((nDOS33track  >= 0 && nDOS33track  < 40)
 		&&  (nDOS33sector >= 0 && nDOS33sector < 16))
@@ -1118,8 +1118,9 @@ LRESULT CALLBACK FrameWndProc (
       DebugDestroy();
       if (!g_bRestart) {
         DiskDestroy();
-        ImageDestroy();
         HD_Destroy();
+        Liron_Destroy();
+        ImageDestroy();	// NB. After all images have been closed (and flushed), as this stops the write-back thread
       }
       PrintDestroy();
       sg_SSC.CommDestroy();
@@ -1192,7 +1193,6 @@ LRESULT CALLBACK FrameWndProc (
       break;
     }
 
-		Liron_Destroy();
     case WM_DISPLAYCHANGE:
       VideoReinitialize();
       break;
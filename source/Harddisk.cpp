@@ -545,28 +545,11 @@ static BYTE __stdcall HD_IO_EMUL(WORD pc, WORD addr, BYTE bWrite, BYTE d, ULONG
 #if HD_LED
 								pHDD->hd_status_next = DISK_STATUS_WRITE;
 #endif
-								bool bRes = true;
-								const bool bAppendBlocks = (pHDD->hd_diskblock * HD_BLOCK_SIZE) >= ImageGetImageSize(pHDD->imagehandle);
-
-								if (bAppendBlocks)
-								{
-									ZeroMemory(pHDD->hd_buf, HD_BLOCK_SIZE);
-
-									// Inefficient (especially for gzip/zip files!)
-									UINT uBlock = ImageGetImageSize(pHDD->imagehandle) / HD_BLOCK_SIZE;
-									while (uBlock < pHDD->hd_diskblock)
-									{
-										bRes = ImageWriteBlock(pHDD->imagehandle, uBlock++, pHDD->hd_buf);
-										_ASSERT(bRes);
-										if (!bRes)
-											break;
-									}
-								}
-
+								MemUpdateLinearImage();	// Only needed for MEM_NOCOPY_PAGING
 								MoveMemory(pHDD->hd_buf, mem+pHDD->hd_memblock, HD_BLOCK_SIZE);
 
-								if (bRes)
-									bRes = ImageWriteBlock(pHDD->imagehandle, pHDD->hd_diskblock, pHDD->hd_buf);
+								// NB. Writing past the end of the image extends it (zero-filled) in one go
+								bool bRes = ImageWriteBlock(pHDD->imagehandle, pHDD->hd_diskblock, pHDD->hd_buf);
 
 								if (bRes)
 								{
@@ -751,6 +734,13 @@ void HD_SaveSnapshot(YamlSaveHelper& yamlSaveHelper)
 
 	HD_SaveSnapshotHDDUnit(yamlSaveHelper, HARDDISK_1);
 	HD_SaveSnapshotHDDUnit(yamlSaveHelper, HARDDISK_2);
+
+	// Barrier: ensure the image files on the host are consistent with the save-state
+	for (UINT unit = HARDDISK_1; unit < NUM_HARDDISKS; unit++)
+	{
+		if (g_HardDisk[unit].imagehandle)
+			ImageFlush(g_HardDisk[unit].imagehandle);
+	}
 }
 
 static bool HD_LoadSnapshotHDDUnit(YamlLoadHelper& yamlLoadHelper, UINT unit)
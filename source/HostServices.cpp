@@ -0,0 +1,100 @@
+/*
+AppleWin : An Apple //e emulator for Windows
+
+Copyright (C) 1994-1996, Michael O'Brien
+Copyright (C) 1999-2001, Oliver Schmidt
+Copyright (C) 2002-2005, Tom Charlesworth
+Copyright (C) 2006-2019, Tom Charlesworth, Michael Pohoreski, Nick Westgate
+
+AppleWin is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+AppleWin is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with AppleWin; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+*/
+
+/* Description: Host platform services (timer, audio sink, frame sink, key input)
+ *
+ * Win32 implementations (see HostServicesNull.cpp for the null ones)
+ */
+
+#include "StdAfx.h"
+
+#include "HostServices.h"
+#include "SoundCore.h"
+#include "Speaker.h"
+#include "Video.h"
+
+//===========================================================================
+// Win32
+
+class CHostTimerWin32 : public IHostTimer
+{
+public:
+	void Start(unsigned int uUsecPeriod)	{ SysClk_StartTimerUsec(uUsecPeriod); }
+	void Stop(void)							{ SysClk_StopTimer(); }
+	void Wait(void)							{ SysClk_WaitTimer(); }
+};
+
+class CHostAudioSinkWin32 : public IHostAudioSink
+{
+public:
+	unsigned long SubmitSpeakerSamples(short* pSpeakerBuffer, unsigned long nNumSamples, bool bFullSpeed)
+	{
+		return Spkr_SubmitWaveBufferDS(pSpeakerBuffer, nNumSamples, bFullSpeed);
+	}
+};
+
+class CHostFrameSinkWin32 : public IHostFrameSink
+{
+public:
+	void BeginFullSpeed(void)
+	{
+		VideoRedrawScreenDuringFullSpeed(0, true);	// Init for full-speed mode
+	}
+
+	void EndFullSpeed(unsigned int uCyclesThisFrame)
+	{
+		VideoRedrawScreenAfterFullSpeed(uCyclesThisFrame);
+	}
+
+	void EndOfFrame(unsigned int uCyclesThisFrame, bool bFullSpeed)
+	{
+		if (bFullSpeed)
+			VideoRedrawScreenDuringFullSpeed(uCyclesThisFrame);
+		else
+			VideoRefreshScreen(); // Just copy the output of our Apple framebuffer to the system Back Buffer
+	}
+};
+
+class CHostKeyInputWin32 : public IHostKeyInput
+{
+public:
+	bool IsFullSpeedKeyDown(void)
+	{
+		return GetKeyState(VK_SCROLL) < 0;
+	}
+};
+
+//===========================================================================
+
+static CHostTimerWin32		g_HostTimerWin32;
+static CHostAudioSinkWin32	g_HostAudioSinkWin32;
+static CHostFrameSinkWin32	g_HostFrameSinkWin32;
+static CHostKeyInputWin32	g_HostKeyInputWin32;
+
+void HostServices_SetWin32(void)
+{
+	g_pHostTimer		= &g_HostTimerWin32;
+	g_pHostAudioSink	= &g_HostAudioSinkWin32;
+	g_pHostFrameSink	= &g_HostFrameSinkWin32;
+	g_pHostKeyInput		= &g_HostKeyInputWin32;
+}
@@ -0,0 +1,47 @@
+#pragma once
+
+// Platform services used by the emulation loop (ContinueExecution)
+// . The emulation loop's throttling, audio & video output and full-speed key go through these, so they can be swapped
+// . NB. Only these sinks are pluggable: the rest of the emulator still needs the Win32 frame window and DirectSound
+// . Only standard types here: the null implementations (HostServicesNull.cpp) don't depend on Win32
+// . The null implementations are the default (no throttling, no audio, no video); WinMain() installs the Win32 ones, unless "-null-sinks"
+
+class IHostTimer
+{
+public:
+	virtual ~IHostTimer() {}
+	virtual void Start(unsigned int uUsecPeriod) = 0;
+	virtual void Stop(void) = 0;
+	virtual void Wait(void) = 0;
+};
+
+class IHostAudioSink
+{
+public:
+	virtual ~IHostAudioSink() {}
+	// Returns the number of speaker samples consumed
+	virtual unsigned long SubmitSpeakerSamples(short* pSpeakerBuffer, unsigned long nNumSamples, bool bFullSpeed) = 0;
+};
+
+class IHostFrameSink
+{
+public:
+	virtual ~IHostFrameSink() {}
+	virtual void BeginFullSpeed(void) = 0;
+	virtual void EndFullSpeed(unsigned int uCyclesThisFrame) = 0;
+	virtual void EndOfFrame(unsigned int uCyclesThisFrame, bool bFullSpeed) = 0;
+};
+
+class IHostKeyInput
+{
+public:
+	virtual ~IHostKeyInput() {}
+	virtual bool IsFullSpeedKeyDown(void) = 0;	// eg. Scroll Lock
+};
+
+extern IHostTimer*		g_pHostTimer;
+extern IHostAudioSink*	g_pHostAudioSink;
+extern IHostFrameSink*	g_pHostFrameSink;
+extern IHostKeyInput*	g_pHostKeyInput;
+
+void HostServices_SetWin32(void);
@@ -0,0 +1,75 @@
+/*
+AppleWin : An Apple //e emulator for Windows
+
+Copyright (C) 1994-1996, Michael O'Brien
+Copyright (C) 1999-2001, Oliver Schmidt
+Copyright (C) 2002-2005, Tom Charlesworth
+Copyright (C) 2006-2019, Tom Charlesworth, Michael Pohoreski, Nick Westgate
+
+AppleWin is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+AppleWin is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with AppleWin; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+*/
+
+/* Description: Host platform services: null implementations
+ *
+ * Run as fast as possible, and discard audio & video.
+ * These are the defaults (see "-null-sinks"), and use no Win32 APIs.
+ */
+
+#include "StdAfx.h"
+
+#include "HostServices.h"
+
+class CHostTimerNull : public IHostTimer
+{
+public:
+	void Start(unsigned int uUsecPeriod)	{}
+	void Stop(void)							{}
+	void Wait(void)							{}
+};
+
+class CHostAudioSinkNull : public IHostAudioSink
+{
+public:
+	unsigned long SubmitSpeakerSamples(short* pSpeakerBuffer, unsigned long nNumSamples, bool bFullSpeed)
+	{
+		return nNumSamples;
+	}
+};
+
+class CHostFrameSinkNull : public IHostFrameSink
+{
+public:
+	void BeginFullSpeed(void)											{}
+	void EndFullSpeed(unsigned int uCyclesThisFrame)					{}
+	void EndOfFrame(unsigned int uCyclesThisFrame, bool bFullSpeed)	{}
+};
+
+class CHostKeyInputNull : public IHostKeyInput
+{
+public:
+	bool IsFullSpeedKeyDown(void)	{ return false; }
+};
+
+//===========================================================================
+
+static CHostTimerNull		g_HostTimerNull;
+static CHostAudioSinkNull	g_HostAudioSinkNull;
+static CHostFrameSinkNull	g_HostFrameSinkNull;
+static CHostKeyInputNull	g_HostKeyInputNull;
+
+IHostTimer*		g_pHostTimer		= &g_HostTimerNull;
+IHostAudioSink*	g_pHostAudioSink	= &g_HostAudioSinkNull;
+IHostFrameSink*	g_pHostFrameSink	= &g_HostFrameSinkNull;
+IHostKeyInput*	g_pHostKeyInput		= &g_HostKeyInputNull;
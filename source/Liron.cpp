@@ -471,7 +471,7 @@ void do_SmartPort(void)
 	byte	Unit;
 	unsigned int	status_ptr;
 	int	buf_ptr;
-	int	block;
+	unsigned int	block;
 	byte	status_code;
 	byte	ctl_code;
 	int	stat_val;
@@ -566,6 +566,23 @@ void do_SmartPort(void)
 			return;
 		}
 		return;
+	case 0x41:	/* Extended Read Block  */
+	case 0x42:	/* Extended Write Block  */
+		// Extended calls carry a 4-byte buffer pointer and a 4-byte block number;
+		// only the low 16 bits of the buffer are addressable on a //e
+		Unit = read_byte(cmd_list+1);
+		buf_ptr = (read_byte(cmd_list+3) << 8) + read_byte(cmd_list+2);
+		block = ((unsigned int)read_byte(cmd_list+9) << 24) + (read_byte(cmd_list+8) << 16) + (read_byte(cmd_list+7) << 8) + read_byte(cmd_list+6);
+		if(Unit < 1 || Unit > 4) {
+			g_A = BadUnit;
+			g_Flags = 0x31;
+			return;
+		}
+		g_A = (cmd == 0x41) ? do_read(Unit - 1, buf_ptr, block) : do_write(Unit - 1, buf_ptr, block);
+		g_X = 0;
+		g_Y = 2;
+		g_Flags = (g_A != 0) ? 0x31 : 0x30;
+		return;
 	case 0x01:	/* Read Block  */
 	case 0x02:	/* Write Block  */
 	case 0x03:	/* Format  */
@@ -655,7 +672,6 @@ void do_ProDOS(void)
 int do_read(int Unit, unsigned int buffer, unsigned int blk)
 {
 	byte	lBuffer[0x200];
-	int	i;
 
 	if(Unit < 0 || Unit > 3)
 	{
@@ -665,7 +681,7 @@ int do_read(int Unit, unsigned int buffer, unsigned int blk)
 	{
 		return OffLine;
 	}
-	if((blk * 0x200) >= ImageGetImageSize(g_LironUnit[Unit].hImage))
+	if(!Liron_IsBlockValid(ImageGetImageSize(g_LironUnit[Unit].hImage), blk))
 	{
 		return IOError;
 	}
@@ -673,18 +689,13 @@ int do_read(int Unit, unsigned int buffer, unsigned int blk)
 	{
 		return IOError;
 	}
-	for(i = 0; i < 0x200; i ++)
-	{
-		write_byte(buffer + i, lBuffer[i]);
-	}
+	Liron_CopyToMemory((WORD)buffer, lBuffer, 0x200);
 	return 0;
 }
 
-int do_write(int Unit, unsigned int buf, int blk)
+int do_write(int Unit, unsigned int buf, unsigned int blk)
 {
 	BYTE	lBuffer[0x200];
-	BYTE	*ptr;
-	int	i;
 
 	if(Unit < 0 || Unit > 3)
 	{
@@ -693,7 +704,7 @@ int do_write(int Unit, unsigned int buf, int blk)
 	if(!g_LironUnit[Unit].bImageLoaded) {
 		return NoDrive;
 	}
-	if((blk * 0x200) >= ImageGetImageSize(g_LironUnit[Unit].hImage))
+	if(!Liron_IsBlockValid(ImageGetImageSize(g_LironUnit[Unit].hImage), blk))
 	{
 		return IOError;
 	}
@@ -701,11 +712,7 @@ int do_write(int Unit, unsigned int buf, int blk)
 	{
 		return WriteProt;
 	}
-	ptr = &(lBuffer[0]);
-	for(i = 0; i < 0x200; i ++)
-	{
-		*ptr++ = read_byte(buf + i);
-	}
+	Liron_CopyFromMemory((WORD)buf, lBuffer, 0x200);
 	if(!ImageWriteBlock(g_LironUnit[Unit].hImage, blk, lBuffer))
 	{
 		return IOError;
@@ -748,20 +755,87 @@ int do_format(int Unit)
 
 BYTE read_byte(WORD addr)
 {
+#ifdef MEM_NOCOPY_PAGING
+	return (((addr & 0xF000) == 0xC000) ?
+		IORead[(addr >> 4) & 0xFF](0xC555, addr, 0, 0, 0) :
+		*(memread[addr >> 8] + (addr & 0xFF)));
+#else
 	return (((addr & 0xF000) == 0xC000) ?
 		IORead[(addr >> 4) & 0xFF](0xC555, addr, 0, 0, 0) :
 		*(mem + addr));
+#endif
 }
 
 void write_byte(WORD addr, BYTE data)
 {
-   memdirty[addr >> 8] = 0xFF;
+   memdirty[addr >> 8] = MEMDIRTY_CPU;
    LPBYTE page = memwrite[addr >> 8];
+   if (!page)
+     page = memtrapwrite[addr >> 8];	// Not a 6502 access, so bypass any page trap (see MemSetPageTraps())
    if (page)
      *(page+(addr & 0xFF)) = (BYTE)(data);
    else if ((addr & 0xF000) == 0xC000)
      IOWrite[(addr>>4) & 0xFF](0xC555,addr,1,(BYTE)(data),0);
 }
+
+// Bulk equivalents of write_byte()/read_byte(): each page is resolved once and copied
+// with memcpy, except $C0xx-$CFxx which still goes byte-by-byte through the I/O handlers.
+// The address wraps at $FFFF, as it would for a 6502 store loop.
+static void Liron_CopyToMemory(WORD addr, const BYTE* pData, UINT uLen)
+{
+	while (uLen)
+	{
+		const UINT uChunk = MIN(uLen, 0x100 - (addr & 0xFF));
+		LPBYTE page = memwrite[addr >> 8];
+		if (!page)
+			page = memtrapwrite[addr >> 8];	// Bypass any page trap (as write_byte())
+
+		if (page)
+		{
+			memdirty[addr >> 8] = MEMDIRTY_CPU;
+			memcpy(page + (addr & 0xFF), pData, uChunk);
+		}
+		else if ((addr & 0xF000) == 0xC000)
+		{
+			for (UINT i = 0; i < uChunk; i++)
+				write_byte(addr + i, pData[i]);
+		}
+		else
+		{
+			memdirty[addr >> 8] = MEMDIRTY_CPU;	// ROM: writes are ignored
+		}
+
+		addr += uChunk;
+		pData += uChunk;
+		uLen -= uChunk;
+	}
+}
+
+static void Liron_CopyFromMemory(WORD addr, BYTE* pData, UINT uLen)
+{
+	while (uLen)
+	{
+		const UINT uChunk = MIN(uLen, 0x100 - (addr & 0xFF));
+
+		if ((addr & 0xF000) == 0xC000)
+		{
+			for (UINT i = 0; i < uChunk; i++)
+				pData[i] = read_byte(addr + i);
+		}
+		else
+		{
+#ifdef MEM_NOCOPY_PAGING
+			memcpy(pData, memread[addr >> 8] + (addr & 0xFF), uChunk);
+#else
+			memcpy(pData, mem + addr, uChunk);
+#endif
+		}
+
+		addr += uChunk;
+		pData += uChunk;
+		uLen -= uChunk;
+	}
+}
 //===========================================================================
 
 #define SS_YAML_VALUE_CARD_LIRONDRIVE "Generic LironDrive"
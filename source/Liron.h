@@ -30,6 +30,13 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 #define NoError	0x00
 #define BadUnit 0x21 //???
 
+// Is block 'blk' wholly within an image of uImageSize bytes?
+// NB. Compare in blocks, not bytes, as an extended call's 32-bit block number overflows when multiplied by 0x200
+inline bool Liron_IsBlockValid(const UINT uImageSize, const UINT blk)
+{
+	return blk < uImageSize / 0x200;
+}
+
 enum LironUnit_e
 {
 	Liron_1 = 0,
@@ -63,7 +70,9 @@ static BYTE __stdcall Liron_IO_Handler(WORD pc, WORD addr, BYTE bWrite, BYTE d,
 void do_SmartPort(void);
 void do_ProDOS(void);
 int do_read(int Unit, unsigned int buffer, unsigned int blk);
-int do_write(int Unit, unsigned int buf, int blk);
+int do_write(int Unit, unsigned int buf, unsigned int blk);
 int do_format(int Unit);
 BYTE read_byte(WORD addr);
 void write_byte(WORD addr, BYTE data);
+static void Liron_CopyToMemory(WORD addr, const BYTE* pData, UINT uLen);
+static void Liron_CopyFromMemory(WORD addr, BYTE* pData, UINT uLen);
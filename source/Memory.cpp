@@ -158,9 +158,32 @@ SOFT SWITCH STATUS FLAGS
 //			. memshadow[0] = &memaux[0x0000]
 //			. memshadow[1] = &memaux[0x0100]
 //
+// MEM_NOCOPY_PAGING
+// - the 6502 reads via memread[] & writes via memwrite[], which point directly into memmain, memaux, memrom, etc
+//		. so UpdatePaging() just updates the tables, and doesn't copy any pages into or out of mem
+// - mem is then just a linear view for code that needs one (eg. debugger), and is only kept up-to-date lazily:
+//		. MemUpdateLinearImage() re-copies pages that have been written by the 6502 or have had their paging changed
+//		. MemFlushLinearImage() copies back pages written directly to mem (memdirty bit0 set, cf. MEMDIRTY_CPU)
+//		. so memdirty bit0 = page written via mem, and bit1 = page written by the 6502
+// - except $C000..$CFFF, which are still copied into mem by UpdatePaging() & IO_Cxxx(), as IO_Cxxx() reads from mem
+//
+// memtrap, memtrapwrite
+// - page traps, for the debugger's memory breakpoints (see MemSetPageTraps())
+// - a write-trapped page has its memwrite[] entry swapped to NULL (and the real one kept in memtrapwrite[])
+//		. so the 6502's WRITE takes its slow path, which sends the write via CpuWriteTrap()
+// - a read-trapped page is only flagged in memtrap[] (the CPU's READ checks this when running to a breakpoint)
+// - pages without a trap keep the direct pointers, so cost nothing extra
+//
 
 static LPBYTE  memshadow[0x100];
 LPBYTE         memwrite[0x100];
+#ifdef MEM_NOCOPY_PAGING
+LPBYTE         memread[0x100];
+static LPBYTE  memviewshadow[0x100];	// what each page of the 'mem' view was last copied from
+#endif
+
+BYTE           memtrap[0x100];
+LPBYTE         memtrapwrite[0x100];
 
 iofunction		IORead[256];
 iofunction		IOWrite[256];
@@ -820,6 +843,9 @@ static bool IsCardInSlot(const UINT uSlot)
 
 static void BackMainImage(void)
 {
+#ifdef MEM_NOCOPY_PAGING
+	MemFlushLinearImage();
+#else
 	for (UINT loop = 0; loop < 256; loop++)
 	{
 		if (memshadow[loop] && ((*(memdirty+loop) & 1) || (loop <= 1)))
@@ -827,6 +853,103 @@ static void BackMainImage(void)
 
 		*(memdirty+loop) &= ~1;
 	}
+#endif
+}
+
+//===========================================================================
+
+// Read a byte as currently paged-in for the 6502 (but without any I/O side-effects)
+static __forceinline BYTE ReadNoIO(const WORD addr)
+{
+#ifdef MEM_NOCOPY_PAGING
+	return *(memread[addr >> 8] + (addr & 0xFF));
+#else
+	return mem[addr];
+#endif
+}
+
+static __forceinline DWORD ReadNoIO32(const WORD addr)
+{
+#ifdef MEM_NOCOPY_PAGING
+	return ReadNoIO(addr) | (ReadNoIO(addr+1) << 8) | (ReadNoIO(addr+2) << 16) | ((DWORD)ReadNoIO(addr+3) << 24);
+#else
+	return *(LPDWORD)(mem+addr);
+#endif
+}
+
+// For code outside the CPU that needs to see memory as the 6502 does (for MEM_NOCOPY_PAGING, 'mem' may be a stale view)
+BYTE ReadByteFromMemory(const WORD addr)
+{
+	return ReadNoIO(addr);
+}
+
+// Write a byte as the 6502 would (but without any I/O side-effects, and bypassing any page trap)
+// . NB. Writes to ROM are ignored
+void WriteByteToMemory(const WORD addr, const BYTE data)
+{
+	memdirty[addr >> 8] = MEMDIRTY_CPU;
+	LPBYTE page = memwrite[addr >> 8];
+	if (!page)
+		page = memtrapwrite[addr >> 8];	// Not a 6502 access (see MemSetPageTraps())
+	if (page)
+		*(page+(addr & 0xFF)) = data;
+}
+
+// The page that the 6502 currently reads 'addr' from
+// . NB. For $Cxxx, this is always the 'mem' view (see UpdatePaging())
+LPBYTE MemGetReadPtr(const WORD addr)
+{
+#ifdef MEM_NOCOPY_PAGING
+	if (memread[addr >> 8])	// NULL before the first UpdatePaging()
+		return memread[addr >> 8] + (addr & 0xFF);
+#endif
+	return mem + addr;
+}
+
+//===========================================================================
+
+// Copy back any pages that have been written directly to the 'mem' view (eg. by the debugger or a boot loader)
+// . Only needed for MEM_NOCOPY_PAGING, since otherwise 'mem' is what the 6502 reads & writes
+void MemFlushLinearImage(void)
+{
+#ifdef MEM_NOCOPY_PAGING
+	for (UINT loop = 0; loop < 256; loop++)
+	{
+		if (loop >= 0xC0 && loop < 0xD0)	// $Cxxx pages are always current in 'mem'
+			continue;
+
+		if (memshadow[loop] && (*(memdirty+loop) & 1))
+			CopyMemory(memshadow[loop], memimage+(loop << 8), 256);
+
+		*(memdirty+loop) &= ~1;
+	}
+#endif
+}
+
+// Bring the 'mem' view up-to-date with what the 6502 currently sees
+// . Only pages that the 6502 has written (or whose paging has changed) since the last call are copied
+// . NB. Page0 (ZP) & Page1 (stack) are always copied, as PUSH doesn't set memdirty
+void MemUpdateLinearImage(void)
+{
+#ifdef MEM_NOCOPY_PAGING
+	MemFlushLinearImage();
+
+	for (UINT loop = 0; loop < 256; loop++)
+	{
+		if (loop >= 0xC0 && loop < 0xD0)	// $Cxxx pages are always current in 'mem'
+			continue;
+
+		if (!memshadow[loop])
+			continue;
+
+		if ((memviewshadow[loop] != memshadow[loop]) || (*(memdirty+loop) & 2) || (loop <= 1))
+		{
+			CopyMemory(memimage+(loop << 8), memshadow[loop], 256);
+			memviewshadow[loop] = memshadow[loop];
+			*(memdirty+loop) &= ~2;
+		}
+	}
+#endif
 }
 
 //===========================================================================
@@ -892,12 +1015,61 @@ void MemUpdatePaging(BOOL initialize)
 	UpdatePaging(initialize);
 }
 
+// Memory has changed without any 6502 writes, so NTSC_VideoRedrawDirtyScanlines() mustn't skip any scanlines
+static void SetVideoPagesDirty(void)
+{
+	for (UINT loop = 0; loop < 0x100; loop++)
+		memdirty[loop] |= MEMDIRTY_VIDEO;
+}
+
+// Swap memwrite[] to NULL for the write-trapped pages
+static void ApplyPageTraps(void)
+{
+	for (UINT loop = 0x00; loop < 0x100; loop++)
+	{
+		if (!(memtrap[loop] & MEMTRAP_WRITE))
+			continue;
+
+#ifdef MEM_NOCOPY_PAGING
+		if (loop == 0x01)
+			continue;	// PUSH writes via memwrite[0x01] without checking for NULL
+#endif
+
+		memtrapwrite[loop] = memwrite[loop];
+		memwrite[loop] = NULL;
+	}
+}
+
+static void RemovePageTraps(void)
+{
+	for (UINT loop = 0x00; loop < 0x100; loop++)
+	{
+		if (!(memtrap[loop] & MEMTRAP_WRITE))
+			continue;
+
+#ifdef MEM_NOCOPY_PAGING
+		if (loop == 0x01)
+			continue;
+#endif
+
+		memwrite[loop] = memtrapwrite[loop];
+		memtrapwrite[loop] = NULL;
+	}
+}
+
 static void UpdatePaging(BOOL initialize)
 {
+	if (initialize)
+		SetVideoPagesDirty();
+
+	RemovePageTraps();	// Some memwrite[] entries are only set when initializing, so restore them
+
+#ifndef MEM_NOCOPY_PAGING
 	// SAVE THE CURRENT PAGING SHADOW TABLE
 	LPBYTE oldshadow[256];
 	if (!initialize)
 		CopyMemory(oldshadow,memshadow,256*sizeof(LPBYTE));
+#endif
 
 	// UPDATE THE PAGING TABLES BASED ON THE NEW PAGING SWITCH VALUES
 	UINT loop;
@@ -989,6 +1161,45 @@ static void UpdatePaging(BOOL initialize)
 		}
 	}
 
+#ifdef MEM_NOCOPY_PAGING
+	// NO COPYING: READ & WRITE DIRECTLY VIA THE SHADOW TABLE
+	// . mem+(loop << 8) in memwrite[] above means 'write to the same page as is read'
+	// . $Cxxx pages are the exception, as IO_Cxxx() returns data from mem[]
+
+	for (loop = 0x00; loop < 0x100; loop++)
+	{
+		if (memwrite[loop] == mem+(loop << 8) || loop < 0x02)
+			memwrite[loop] = memshadow[loop];
+
+		if (loop >= 0xC0 && loop < 0xD0)
+		{
+			memread[loop] = mem+(loop << 8);
+			if (initialize || (memviewshadow[loop] != memshadow[loop]))
+			{
+				CopyMemory(mem+(loop << 8),memshadow[loop],256);
+				memviewshadow[loop] = memshadow[loop];
+			}
+		}
+		else
+		{
+			memread[loop] = memshadow[loop];
+		}
+	}
+
+	if (initialize)
+	{
+		// Discard the old view (nothing is copied back from it)
+		for (loop = 0x00; loop < 0x100; loop++)
+		{
+			if (loop >= 0xC0 && loop < 0xD0)
+				continue;
+			memviewshadow[loop] = NULL;
+			*(memdirty+loop) &= ~1;
+		}
+
+		MemUpdateLinearImage();
+	}
+#else
 	// MOVE MEMORY BACK AND FORTH AS NECESSARY BETWEEN THE SHADOW AREAS AND
 	// THE MAIN RAM IMAGE TO KEEP BOTH SETS OF MEMORY CONSISTENT WITH THE NEW
 	// PAGING SHADOW TABLE
@@ -1011,6 +1222,25 @@ static void UpdatePaging(BOOL initialize)
 			CopyMemory(mem+(loop << 8),memshadow[loop],256);
 		}
 	}
+#endif
+
+	ApplyPageTraps();
+}
+
+//===========================================================================
+
+// Trap 6502 accesses to these pages (pPageTraps: MEMTRAP_* flags for each of the 256 pages; or NULL for none)
+// . the traps stay in place across paging changes, until this is called with NULL
+void MemSetPageTraps(const BYTE* pPageTraps)
+{
+	RemovePageTraps();
+
+	if (pPageTraps)
+		memcpy(memtrap, pPageTraps, sizeof(memtrap));
+	else
+		ZeroMemory(memtrap, sizeof(memtrap));
+
+	ApplyPageTraps();
 }
 
 //
@@ -1055,6 +1285,12 @@ void MemDestroy()
 
 	ZeroMemory(memwrite, sizeof(memwrite));
 	ZeroMemory(memshadow,sizeof(memshadow));
+	ZeroMemory(memtrap, sizeof(memtrap));
+	ZeroMemory(memtrapwrite, sizeof(memtrapwrite));
+#ifdef MEM_NOCOPY_PAGING
+	ZeroMemory(memread, sizeof(memread));
+	ZeroMemory(memviewshadow, sizeof(memviewshadow));
+#endif
 }
 
 //===========================================================================
@@ -1076,11 +1312,15 @@ static LPBYTE MemGetPtrBANK1(const WORD offset, const LPBYTE pMemBase)
 	if ((offset & 0xF000) != 0xC000)	// Requesting RAM at physical addr $Cxxx (ie. 4K RAM BANK1)
 		return NULL;
 
+#ifdef MEM_NOCOPY_PAGING
+	return pMemBase+offset;				// 4K RAM BANK1 is never copied to 'mem'
+#else
 	// NB. This works for memaux when set to any RWpages[] value, ie. RamWork III "just works"
 	const BYTE bank1page = (offset >> 8) & 0xF;
 	return (memshadow[0xD0+bank1page] == pMemBase+(0xC0+bank1page)*256)
 		? mem+offset+0x1000				// Return ptr to $Dxxx address - 'mem' has (a potentially dirty) 4K RAM BANK1 mapped in at $D000
 		: pMemBase+offset;				// Else return ptr to $Cxxx address
+#endif
 }
 
 //-------------------------------------
@@ -1091,9 +1331,13 @@ LPBYTE MemGetAuxPtr(const WORD offset)
 	if (lpMem)
 		return lpMem;
 
+#ifdef MEM_NOCOPY_PAGING
+	lpMem = memaux+offset;				// Never a 'mem' copy
+#else
 	lpMem = (memshadow[(offset >> 8)] == (memaux+(offset & 0xFF00)))
 			? mem+offset				// Return 'mem' copy if possible, as page could be dirty
 			: memaux+offset;
+#endif
 
 #ifdef RAMWORKS
 	if ( ((SW_PAGE2 && SW_80STORE) || VideoGetSW80COL()) &&
@@ -1101,9 +1345,13 @@ LPBYTE MemGetAuxPtr(const WORD offset)
 		((offset & 0xFF00)<=0x0700) ) ||
 		( SW_HIRES && ((offset & 0xFF00)>=0x2000) &&
 		((offset & 0xFF00)<=0x3F00) ) ) ) {
+#ifdef MEM_NOCOPY_PAGING
+		lpMem = RWpages[0]+offset;
+#else
 		lpMem = (memshadow[(offset >> 8)] == (RWpages[0]+(offset & 0xFF00)))
 			? mem+offset
 			: RWpages[0]+offset;
+#endif
 	}
 #endif
 
@@ -1118,9 +1366,13 @@ LPBYTE MemGetMainPtr(const WORD offset)
 	if (lpMem)
 		return lpMem;
 
+#ifdef MEM_NOCOPY_PAGING
+	return memmain+offset;				// Never a 'mem' copy
+#else
 	return (memshadow[(offset >> 8)] == (memmain+(offset & 0xFF00)))
 			? mem+offset				// Return 'mem' copy if possible, as page could be dirty
 			: memmain+offset;
+#endif
 }
 
 //===========================================================================
@@ -1472,6 +1724,10 @@ void MemReset()
 	// INITIALIZE THE PAGING TABLES
 	ZeroMemory(memshadow,256*sizeof(LPBYTE));
 	ZeroMemory(memwrite ,256*sizeof(LPBYTE));
+	ZeroMemory(memtrapwrite ,256*sizeof(LPBYTE));
+#ifdef MEM_NOCOPY_PAGING
+	ZeroMemory(memread ,256*sizeof(LPBYTE));
+#endif
 
 	// INITIALIZE THE RAM IMAGES
 	ZeroMemory(memaux ,0x10000);
@@ -1624,7 +1880,7 @@ void MemReset()
 BYTE MemReadFloatingBus(const ULONG uExecutedCycles)
 {
 //	return mem[ VideoGetScannerAddress(NULL, uExecutedCycles) ];	// NG: ANSI STORY (End Credits) - repro by running from "Turn the disk over"
-	return mem[ NTSC_VideoGetScannerAddress(uExecutedCycles) ];		// OK: This does the 2-cycle adjust for ANSI STORY (End Credits)
+	return ReadNoIO( NTSC_VideoGetScannerAddress(uExecutedCycles) );	// OK: This does the 2-cycle adjust for ANSI STORY (End Credits)
 }
 
 //===========================================================================
@@ -1772,6 +2028,7 @@ BYTE __stdcall MemSetPaging(WORD programcounter, WORD address, BYTE write, BYTE
 					g_uActiveBank = value;
 					memaux = RWpages[g_uActiveBank];
 					UpdatePaging(0);	// Initialize=0
+					SetVideoPagesDirty();
 				}
 				break;
 #endif
@@ -1789,13 +2046,13 @@ _done_saturn:
 	// NB. A 6502 interrupt occurring between these memory write & read updates could lead to incorrect behaviour.
 	// - although any date-race is probably a bug in the 6502 code too.
 	if ((address >= 4) && (address <= 5) &&
-		((*(LPDWORD)(mem+programcounter) & 0x00FFFEFF) == 0x00C0028D)) {
+		((ReadNoIO32(programcounter) & 0x00FFFEFF) == 0x00C0028D)) {
 			modechanging = 1;
 			return write ? 0 : MemReadFloatingBus(1, nExecutedCycles);
 	}
 	if ((address >= 0x80) && (address <= 0x8F) && (programcounter < 0xC000) &&
-		(((*(LPDWORD)(mem+programcounter) & 0x00FFFEFF) == 0x00C0048D) ||
-		 ((*(LPDWORD)(mem+programcounter) & 0x00FFFEFF) == 0x00C0028D))) {
+		(((ReadNoIO32(programcounter) & 0x00FFFEFF) == 0x00C0048D) ||
+		 ((ReadNoIO32(programcounter) & 0x00FFFEFF) == 0x00C0028D))) {
 			modechanging = 1;
 			return write ? 0 : MemReadFloatingBus(1, nExecutedCycles);
 	}
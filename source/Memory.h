@@ -54,9 +54,23 @@ extern MemoryType_e	g_eMemType;
 extern iofunction IORead[256];
 extern iofunction IOWrite[256];
 extern LPBYTE     memwrite[0x100];
+extern BYTE       memtrap[0x100];
+extern LPBYTE     memtrapwrite[0x100];
 extern LPBYTE     mem;
 extern LPBYTE     memdirty;
 
+#ifdef MEM_NOCOPY_PAGING
+extern LPBYTE     memread[0x100];
+const BYTE MEMDIRTY_CPU = 0xFE;		// NB. bit0 is reserved for direct writes to the mem[] view (see MemFlushLinearImage())
+#else
+const BYTE MEMDIRTY_CPU = 0xFF;
+#endif
+const BYTE MEMDIRTY_VIDEO = 0x08;	// Set by 6502 writes (part of MEMDIRTY_CPU), cleared by NTSC_VideoRedrawDirtyScanlines()
+
+// Page traps (memtrap[])
+const BYTE MEMTRAP_READ = 1<<0;
+const BYTE MEMTRAP_WRITE = 1<<1;		// memwrite[] is NULL, and memtrapwrite[] has the page to write to
+
 #ifdef RAMWORKS
 const UINT kMaxExMemoryBanks = 127;	// 127 * aux mem(64K) + main mem(64K) = 8MB
 extern UINT       g_uMaxExPages;	// user requested ram pages (from cmd line)
@@ -77,6 +91,7 @@ LPBYTE  MemGetAuxPtr(const WORD);
 LPBYTE  MemGetMainPtr(const WORD);
 LPBYTE  MemGetBankPtr(const UINT nBank);
 LPBYTE  MemGetCxRomPeripheral();
+LPBYTE  MemGetReadPtr(const WORD addr);
 DWORD   GetMemMode(void);
 bool    MemIsAddrCodeMemory(const USHORT addr);
 void    MemInitialize ();
@@ -89,6 +104,11 @@ BYTE    MemReadFloatingBus(const BYTE highbit, const ULONG uExecutedCycles);
 void    MemReset ();
 void    MemResetPaging ();
 void    MemUpdatePaging(BOOL initialize);
+void    MemSetPageTraps(const BYTE* pPageTraps);
+void    MemFlushLinearImage(void);
+void    MemUpdateLinearImage(void);
+BYTE    ReadByteFromMemory(const WORD addr);
+void    WriteByteToMemory(const WORD addr, const BYTE data);
 LPVOID	MemGetSlotParameters (UINT uSlot);
 void    MemSetSnapshot_v1(const DWORD MemMode, const BOOL LastWriteRam, const BYTE* const pMemMain, const BYTE* const pMemAux);
 std::string MemGetSnapshotUnitAuxSlotName(void);
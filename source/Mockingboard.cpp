@@ -80,10 +80,12 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 #include "SaveState_Structs_v1.h"
 
 #include "Applewin.h"
+#include "AudioThread.h"
 #include "CPU.h"
 #include "Log.h"
 #include "Memory.h"
 #include "Mockingboard.h"
+#include "MockingboardMixer.h"
 #include "SoundCore.h"
 #include "YamlHelper.h"
 
@@ -191,9 +193,6 @@ static const unsigned short g_nMB_NumChannels = 2;
 
 static const DWORD g_dwDSBufferSize = MAX_SAMPLES * sizeof(short) * g_nMB_NumChannels;
 
-static const SHORT nWaveDataMin = (SHORT)0x8000;
-static const SHORT nWaveDataMax = (SHORT)0x7FFF;
-
 static short g_nMixBuffer[g_dwDSBufferSize / sizeof(short)];
 
 
@@ -219,6 +218,52 @@ static double MB_GetFramePeriod(void);
 
 //---------------------------------------------------------------------------
 
+// Cycles until MB_UpdateCycles() would see this counter underflow (ie. bit15: 0->1)
+// . Counters with bit15 already set first need an update once they've decremented to 0x7FFF
+static UINT GetCyclesUntilUnderflow(const USHORT nCounter)
+{
+	return (nCounter & 0x8000) ? (UINT)nCounter - 0x7FFF : (UINT)nCounter + 1;
+}
+
+static void MB_TimerSyncEvent(ULONG uExecutedCycles)
+{
+	MB_UpdateCycles(uExecutedCycles);
+}
+
+// Call whenever any 6522's timer counters are updated or a timer is started/stopped
+// . The 6522 counters are up-to-date as of g_uLastCumulativeCycles
+// . All TIMER1 counters are included (active or not): see Willy Byte fix in MB_UpdateCycles()
+static void SetTimerSyncEvent(void)
+{
+	if (g_SoundcardType == CT_Empty)
+	{
+		CpuSyncEventCancel(SYNCEVENT_6522_TIMER);
+		return;
+	}
+
+	UINT uCycles = 0x8000;	// Max from GetCyclesUntilUnderflow()
+
+	for (UINT i=0; i<NUM_SY6522; i++)
+	{
+		const SY6522_AY8910* pMB = &g_MB[i];
+
+		const UINT uCyclesTimer1 = GetCyclesUntilUnderflow(pMB->sy6522.TIMER1_COUNTER.w);
+		if (uCyclesTimer1 < uCycles)
+			uCycles = uCyclesTimer1;
+
+		if (pMB->bTimer2Active)
+		{
+			const UINT uCyclesTimer2 = GetCyclesUntilUnderflow(pMB->sy6522.TIMER2_COUNTER.w);
+			if (uCyclesTimer2 < uCycles)
+				uCycles = uCyclesTimer2;
+		}
+	}
+
+	CpuSyncEventSet(SYNCEVENT_6522_TIMER, g_uLastCumulativeCycles + uCycles, MB_TimerSyncEvent);
+}
+
+//---------------------------------------------------------------------------
+
 static void StartTimer1(SY6522_AY8910* pMB)
 {
 	pMB->bTimer1Active = true;
@@ -491,6 +536,8 @@ static void SY6522_Write(BYTE nDevice, BYTE nReg, BYTE nValue)
 		case 0x0f:	// ORA_NO_HS
 			break;
 	}
+
+	SetTimerSyncEvent();	// Timer counters or active state may have changed
 }
 
 //-----------------------------------------------------------------------------
@@ -812,8 +859,8 @@ static void MB_Update()
 
 	//
 
-	static DWORD dwByteOffset = (DWORD)-1;
-	static int nNumSamplesError = 0;
+	// The queued samples are written to DirectSound by the audio thread
+	const int nNumSamplesError = AudioThread_GetSamplesError(AUDIO_SINK_MOCKINGBOARD);
 
 	const double n6522TimerPeriod = MB_GetFramePeriod();
 
@@ -825,131 +872,21 @@ static void MB_Update()
 	if(nNumSamples > 2*nNumSamplesPerPeriod)
 		nNumSamples = 2*nNumSamplesPerPeriod;
 
-	if(nNumSamples)
-		for(int nChip=0; nChip<NUM_AY8910; nChip++)
-			AY8910Update(nChip, &ppAYVoiceBuffer[nChip*NUM_VOICES_PER_AY8910], nNumSamples);
-
-	//
-
-	DWORD dwDSLockedBufferSize0, dwDSLockedBufferSize1;
-	SHORT *pDSLockedBuffer0, *pDSLockedBuffer1;
-
-	DWORD dwCurrentPlayCursor, dwCurrentWriteCursor;
-	HRESULT hr = MockingboardVoice.lpDSBvoice->GetCurrentPosition(&dwCurrentPlayCursor, &dwCurrentWriteCursor);
-	if(FAILED(hr))
-		return;
-
-	if(dwByteOffset == (DWORD)-1)
-	{
-		// First time in this func
-
-		dwByteOffset = dwCurrentWriteCursor;
-	}
-	else
-	{
-		// Check that our offset isn't between Play & Write positions
-
-		if(dwCurrentWriteCursor > dwCurrentPlayCursor)
-		{
-			// |-----PxxxxxW-----|
-			if((dwByteOffset > dwCurrentPlayCursor) && (dwByteOffset < dwCurrentWriteCursor))
-			{
-				double fTicksSecs = (double)GetTickCount() / 1000.0;
-				//sprintf(szDbg, "%010.3f: [MBUpdt]    PC=%08X, WC=%08X, Diff=%08X, Off=%08X, NS=%08X xxx\n", fTicksSecs, dwCurrentPlayCursor, dwCurrentWriteCursor, dwCurrentWriteCursor-dwCurrentPlayCursor, dwByteOffset, nNumSamples);
-				//OutputDebugString(szDbg);
-				//if (g_fh) fprintf(g_fh, "%s", szDbg);
-
-				dwByteOffset = dwCurrentWriteCursor;
-			}
-		}
-		else
-		{
-			// |xxW----------Pxxx|
-			if((dwByteOffset > dwCurrentPlayCursor) || (dwByteOffset < dwCurrentWriteCursor))
-			{
-				double fTicksSecs = (double)GetTickCount() / 1000.0;
-				//sprintf(szDbg, "%010.3f: [MBUpdt]    PC=%08X, WC=%08X, Diff=%08X, Off=%08X, NS=%08X XXX\n", fTicksSecs, dwCurrentPlayCursor, dwCurrentWriteCursor, dwCurrentWriteCursor-dwCurrentPlayCursor, dwByteOffset, nNumSamples);
-				//OutputDebugString(szDbg);
-				//if (g_fh) fprintf(g_fh, "%s", szDbg);
-
-				dwByteOffset = dwCurrentWriteCursor;
-			}
-		}
-	}
-
-	int nBytesRemaining = dwByteOffset - dwCurrentPlayCursor;
-	if(nBytesRemaining < 0)
-		nBytesRemaining += g_dwDSBufferSize;
-
-	// Calc correction factor so that play-buffer doesn't under/overflow
-	const int nErrorInc = SoundCore_GetErrorInc();
-	if(nBytesRemaining < g_dwDSBufferSize / 4)
-		nNumSamplesError += nErrorInc;				// < 0.25 of buffer remaining
-	else if(nBytesRemaining > g_dwDSBufferSize / 2)
-		nNumSamplesError -= nErrorInc;				// > 0.50 of buffer remaining
-	else
-		nNumSamplesError = 0;						// Acceptable amount of data in buffer
-
 	if(nNumSamples == 0)
 		return;
 
-	//
-
-	const double fAttenuation = g_bPhasorEnable ? 2.0/3.0 : 1.0;
-
-	for(int i=0; i<nNumSamples; i++)
-	{
-		// Mockingboard stereo (all voices on an AY8910 wire-or'ed together)
-		// L = Address.b7=0, R = Address.b7=1
-		int nDataL = 0, nDataR = 0;
-
-		for(UINT j=0; j<NUM_VOICES_PER_AY8910; j++)
-		{
-			// Slot4
-			nDataL += (int) ((double)ppAYVoiceBuffer[0*NUM_VOICES_PER_AY8910+j][i] * fAttenuation);
-			nDataR += (int) ((double)ppAYVoiceBuffer[1*NUM_VOICES_PER_AY8910+j][i] * fAttenuation);
-
-			// Slot5
-			nDataL += (int) ((double)ppAYVoiceBuffer[2*NUM_VOICES_PER_AY8910+j][i] * fAttenuation);
-			nDataR += (int) ((double)ppAYVoiceBuffer[3*NUM_VOICES_PER_AY8910+j][i] * fAttenuation);
-		}
-
-		// Cap the superpositioned output
-		if(nDataL < nWaveDataMin)
-			nDataL = nWaveDataMin;
-		else if(nDataL > nWaveDataMax)
-			nDataL = nWaveDataMax;
-
-		if(nDataR < nWaveDataMin)
-			nDataR = nWaveDataMin;
-		else if(nDataR > nWaveDataMax)
-			nDataR = nWaveDataMax;
-
-		g_nMixBuffer[i*g_nMB_NumChannels+0] = (short)nDataL;	// L
-		g_nMixBuffer[i*g_nMB_NumChannels+1] = (short)nDataR;	// R
-	}
+	for(int nChip=0; nChip<NUM_AY8910; nChip++)
+		AY8910Update(nChip, &ppAYVoiceBuffer[nChip*NUM_VOICES_PER_AY8910], nNumSamples);
 
 	//
 
-	if(!DSGetLock(MockingboardVoice.lpDSBvoice,
-						dwByteOffset, (DWORD)nNumSamples*sizeof(short)*g_nMB_NumChannels,
-						&pDSLockedBuffer0, &dwDSLockedBufferSize0,
-						&pDSLockedBuffer1, &dwDSLockedBufferSize1))
-		return;
-
-	memcpy(pDSLockedBuffer0, &g_nMixBuffer[0], dwDSLockedBufferSize0);
-	if(pDSLockedBuffer1)
-		memcpy(pDSLockedBuffer1, &g_nMixBuffer[dwDSLockedBufferSize0/sizeof(short)], dwDSLockedBufferSize1);
-
-	// Commit sound buffer
-	hr = MockingboardVoice.lpDSBvoice->Unlock((void*)pDSLockedBuffer0, dwDSLockedBufferSize0,
-											  (void*)pDSLockedBuffer1, dwDSLockedBufferSize1);
+	const double fAttenuation = g_bPhasorEnable ? 2.0/3.0 : 1.0;
 
-	dwByteOffset = (dwByteOffset + (DWORD)nNumSamples*sizeof(short)*g_nMB_NumChannels) % g_dwDSBufferSize;
+	// Mockingboard stereo (all voices on an AY8910 wire-or'ed together)
+	// L = Address.b7=0, R = Address.b7=1
+	MB_MixVoices(g_nMixBuffer, ppAYVoiceBuffer, NUM_AY8910, NUM_VOICES_PER_AY8910, nNumSamples, fAttenuation);
 
-#ifdef RIFF_MB
-	RiffPutSamples(&g_nMixBuffer[0], nNumSamples);
-#endif
+	AudioThread_Push(AUDIO_SINK_MOCKINGBOARD, g_nMixBuffer, nNumSamples);
 }
 
 //-----------------------------------------------------------------------------
@@ -1169,6 +1106,8 @@ static bool MB_DSInit()
 	hr = MockingboardVoice.lpDSBvoice->SetVolume(MockingboardVoice.nVolume);
 	LogFileOutput("MB_DSInit: SetVolume(), hr=0x%08X\n", hr);
 
+	AudioThread_SetVoice(AUDIO_SINK_MOCKINGBOARD, &MockingboardVoice, g_dwDSBufferSize, SAMPLE_RATE, g_nMB_NumChannels);
+
 	//---------------------------------
 
 	//
@@ -1330,6 +1269,8 @@ static void MB_DSUninit()
 
 	//
 
+	AudioThread_RemoveVoice(AUDIO_SINK_MOCKINGBOARD);
+
 	if(MockingboardVoice.lpDSBvoice && MockingboardVoice.bActive)
 	{
 		MockingboardVoice.lpDSBvoice->Stop();
@@ -1484,7 +1425,7 @@ static BYTE __stdcall MB_Read(WORD PC, WORD nAddr, BYTE bWrite, BYTE nValue, ULO
 	if(!IS_APPLE2 && MemCheckINTCXROM())
 	{
 		_ASSERT(0);	// Card ROM disabled, so IO_Cxxx() returns the internal ROM
-		return mem[nAddr];
+		return ReadByteFromMemory(nAddr);
 	}
 
 	if(g_SoundcardType == CT_Empty)
@@ -1676,6 +1617,7 @@ void MB_Demute()
 void MB_StartOfCpuExecute()
 {
 	g_uLastCumulativeCycles = g_nCumulativeCycles;
+	SetTimerSyncEvent();	// NB. g_nCumulativeCycles may have jumped (eg. save-state loaded)
 }
 
 // Called by ContinueExecution() at the end of every video frame
@@ -1692,7 +1634,7 @@ void MB_EndOfVideoFrame()
 
 // Called by:
 // . CpuExecute() every ~1000 @ 1MHz
-// . CheckInterruptSources() every 128 cycles
+// . CheckInterruptSources() when SYNCEVENT_6522_TIMER is due (ie. on a timer underflow)
 // . MB_Read() / MB_Write()
 void MB_UpdateCycles(ULONG uExecutedCycles)
 {
@@ -1769,6 +1711,8 @@ void MB_UpdateCycles(ULONG uExecutedCycles)
 			}
 		}
 	}
+
+	SetTimerSyncEvent();
 }
 
 //-----------------------------------------------------------------------------
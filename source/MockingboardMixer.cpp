@@ -0,0 +1,170 @@
+/*
+AppleWin : An Apple //e emulator for Windows
+
+Copyright (C) 1994-1996, Michael O'Brien
+Copyright (C) 1999-2001, Oliver Schmidt
+Copyright (C) 2002-2005, Tom Charlesworth
+Copyright (C) 2006-2019, Tom Charlesworth, Michael Pohoreski, Nick Westgate
+
+AppleWin is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+AppleWin is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with AppleWin; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+*/
+
+/* Description: Mockingboard/Phasor voice mixer
+ *
+ * Fixed-point replacement for MB_Update()'s per-sample double arithmetic:
+ * . each voice is scaled by a 0.16 gain: sign(v) * ((|v| * gain) >> 16)
+ *   - this is bit-identical to (int)((double)v * fAttenuation) for the attenuations in use (1 and 2/3)
+ * . voices are summed at 32 bits, then saturated to 16 bits (so no per-sample clamp branches)
+ * . SSE2 does 8 samples at a time (selected at runtime, see g_bMixerSIMD); the scalar loop is the fallback
+ */
+
+#include "StdAfx.h"
+
+#include "Common.h"
+#include "MockingboardMixer.h"
+
+#if defined(_M_IX86) || defined(_M_X64) || defined(__SSE2__)
+	#define MB_MIXER_SSE2 1
+	#include <emmintrin.h>
+#else
+	#define MB_MIXER_SSE2 0
+#endif
+
+static bool g_bMixerSIMD = false;	// CPU has SSE2 (and not disabled via MB_MixerSetSIMD())
+static bool g_bMixerSIMDInit = false;
+
+static const int nWaveDataMin = (SHORT)0x8000;
+static const int nWaveDataMax = (SHORT)0x7FFF;
+
+//===========================================================================
+
+static UINT GetGain(const double fAttenuation)
+{
+	// 0.16 fixed-point (so 1.0 == 0x10000)
+	if (fAttenuation >= 1.0)
+		return 0x10000;
+	if (fAttenuation <= 0.0)
+		return 0;
+	return (UINT) (fAttenuation * 0x10000 + 0.5);
+}
+
+// sign(v) * ((|v| * gain) >> 16), without branches: bias negative products by 0xFFFF so the shift truncates towards zero
+// . NB. -32768 * 0x10000 is exactly INT_MIN, so the product can't overflow
+static inline int ScaleVoice(const int nData, const UINT uGain)
+{
+	const int nProduct = nData * (int)uGain;
+	return (nProduct + ((nProduct >> 31) & 0xFFFF)) >> 16;
+}
+
+static void MixVoicesScalar(short* pMixBuffer, short* const* ppAYVoiceBuffer, const UINT uNumAY8910, const UINT uNumVoicesPerAY8910, const UINT uFirstSample, const UINT uNumSamples, const UINT uGain)
+{
+	for (UINT i=uFirstSample; i<uNumSamples; i++)
+	{
+		int nDataL = 0, nDataR = 0;
+
+		for (UINT uChip=0; uChip+1<uNumAY8910; uChip+=2)
+		{
+			short* const* ppVoiceL = &ppAYVoiceBuffer[(uChip+0)*uNumVoicesPerAY8910];
+			short* const* ppVoiceR = &ppAYVoiceBuffer[(uChip+1)*uNumVoicesPerAY8910];
+			for (UINT j=0; j<uNumVoicesPerAY8910; j++)
+			{
+				nDataL += ScaleVoice(ppVoiceL[j][i], uGain);
+				nDataR += ScaleVoice(ppVoiceR[j][i], uGain);
+			}
+		}
+
+		pMixBuffer[i*2+0] = (short) MIN(MAX(nDataL, nWaveDataMin), nWaveDataMax);	// L
+		pMixBuffer[i*2+1] = (short) MIN(MAX(nDataR, nWaveDataMin), nWaveDataMax);	// R
+	}
+}
+
+#if MB_MIXER_SSE2
+// 8 samples at a time. Returns the number of samples mixed (the remainder is left for the scalar loop)
+static UINT MixVoicesSSE2(short* pMixBuffer, short* const* ppAYVoiceBuffer, const UINT uNumAY8910, const UINT uNumVoicesPerAY8910, const UINT uNumSamples, const UINT uGain)
+{
+	const bool bUnity = (uGain == 0x10000);
+	const __m128i gain = _mm_set1_epi16( (short)(bUnity ? 0 : uGain) );
+
+	UINT i = 0;
+	for (; i + 8 <= uNumSamples; i += 8)
+	{
+		__m128i sumLo[2] = { _mm_setzero_si128(), _mm_setzero_si128() };	// L,R: samples 0-3
+		__m128i sumHi[2] = { _mm_setzero_si128(), _mm_setzero_si128() };	// L,R: samples 4-7
+
+		for (UINT uChip=0; uChip<uNumAY8910; uChip++)
+		{
+			short* const* ppVoice = &ppAYVoiceBuffer[uChip*uNumVoicesPerAY8910];
+			for (UINT j=0; j<uNumVoicesPerAY8910; j++)
+			{
+				__m128i v = _mm_loadu_si128( (const __m128i*) &ppVoice[j][i] );
+
+				if (!bUnity)
+				{
+					// sign(v) * ((|v| * gain) >> 16): |-32768| is 0x8000 as unsigned, which pmulhuw handles
+					const __m128i sign = _mm_srai_epi16( v, 15 );
+					const __m128i mag = _mm_sub_epi16( _mm_xor_si128( v, sign ), sign );
+					v = _mm_mulhi_epu16( mag, gain );
+					v = _mm_sub_epi16( _mm_xor_si128( v, sign ), sign );
+				}
+
+				// Sign-extend to 32 bits
+				sumLo[uChip & 1] = _mm_add_epi32( sumLo[uChip & 1], _mm_srai_epi32( _mm_unpacklo_epi16( v, v ), 16 ) );
+				sumHi[uChip & 1] = _mm_add_epi32( sumHi[uChip & 1], _mm_srai_epi32( _mm_unpackhi_epi16( v, v ), 16 ) );
+			}
+		}
+
+		// Saturate to 16 bits & interleave L,R
+		const __m128i l = _mm_packs_epi32( sumLo[0], sumHi[0] );
+		const __m128i r = _mm_packs_epi32( sumLo[1], sumHi[1] );
+		_mm_storeu_si128( (__m128i*) &pMixBuffer[i*2+0], _mm_unpacklo_epi16( l, r ) );
+		_mm_storeu_si128( (__m128i*) &pMixBuffer[i*2+8], _mm_unpackhi_epi16( l, r ) );
+	}
+
+	return i;
+}
+#endif
+
+//===========================================================================
+
+void MB_MixVoices(short* pMixBuffer, short* const* ppAYVoiceBuffer, const UINT uNumAY8910, const UINT uNumVoicesPerAY8910, const UINT uNumSamples, const double fAttenuation)
+{
+	_ASSERT((uNumAY8910 & 1) == 0);	// L,R pairs
+
+	if (!g_bMixerSIMDInit)
+		MB_MixerSetSIMD(true);
+
+	const UINT uGain = GetGain(fAttenuation);
+	UINT i = 0;
+
+#if MB_MIXER_SSE2
+	if (g_bMixerSIMD)
+		i = MixVoicesSSE2(pMixBuffer, ppAYVoiceBuffer, uNumAY8910, uNumVoicesPerAY8910, uNumSamples, uGain);
+#endif
+
+	MixVoicesScalar(pMixBuffer, ppAYVoiceBuffer, uNumAY8910, uNumVoicesPerAY8910, i, uNumSamples, uGain);
+}
+
+// Returns true if SIMD is now in use
+bool MB_MixerSetSIMD(bool bEnable)
+{
+#if MB_MIXER_SSE2
+	g_bMixerSIMD = bEnable && IsProcessorFeaturePresent(PF_XMMI64_INSTRUCTIONS_AVAILABLE);
+#else
+	g_bMixerSIMD = false;
+#endif
+	g_bMixerSIMDInit = true;
+
+	return g_bMixerSIMD;
+}
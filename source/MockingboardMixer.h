@@ -0,0 +1,7 @@
+#pragma once
+
+// Mix the AY8910 voice buffers to saturated 16-bit stereo (interleaved L,R)
+// . AY8910s are paired per card: even = L (Address.b7=0), odd = R (Address.b7=1), so uNumAY8910 must be even (any number of cards)
+// . Each voice is scaled by fAttenuation (truncated towards zero) before being summed, as the original double-precision mix did
+void MB_MixVoices(short* pMixBuffer, short* const* ppAYVoiceBuffer, const UINT uNumAY8910, const UINT uNumVoicesPerAY8910, const UINT uNumSamples, const double fAttenuation);
+bool MB_MixerSetSIMD(bool bEnable);
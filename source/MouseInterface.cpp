@@ -230,8 +230,8 @@ void CMouseInterface::SetSlotRom()
 
 	UINT uOffset = (m_by6821B << 7) & 0x0700;
 	memcpy(pCxRomPeripheral+m_uSlot*256, m_pSlotRom+uOffset, 256);
-	if (mem)
-		memcpy(mem+0xC000+m_uSlot*256, m_pSlotRom+uOffset, 256);
+	if (mem && !MemCheckINTCXROM())	// else the internal ROM is paged in, and UpdatePaging() copies this page back in when it's paged out
+		memcpy(MemGetReadPtr(0xC000+m_uSlot*256), m_pSlotRom+uOffset, 256);
 }
 
 //===========================================================================
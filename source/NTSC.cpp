@@ -41,6 +41,14 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 	#include "ntsc_rgb.h"
 #endif
 
+// SSE2 interpolated scanline blend (selected at runtime, see g_bVideoSIMD)
+#if defined(_M_IX86) || defined(_M_X64) || defined(__SSE2__)
+	#define NTSC_SSE2 1
+	#include <emmintrin.h>
+#else
+	#define NTSC_SSE2 0
+#endif
+
 	//LPBYTE  MemGetMainPtr(const WORD);
 	//LPBYTE  MemGetBankPtr(const UINT nBank);
 
@@ -106,6 +114,19 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 		};
 	};
 
+	// What a displayed scanline was last drawn from, so that an unchanged scanline can be skipped (see NTSC_VideoRedrawDirtyScanlines())
+	struct ScanlineState_t
+	{
+		bool     bValid;
+		uint32_t uVideoMode;        // NTSC_SetVideoMode() flags
+		int      nVideoCharSet;
+		int      nColorBurstBeg;    // g_nColorBurstPixels at start of scanline
+		int      nColorBurstEnd;    // g_nColorBurstPixels at end of scanline
+		uint16_t nTextFlashMask;    // only compared for text scanlines
+		uint32_t uSerial;           // new value each time this scanline is drawn
+		uint32_t uPrevSerial;       // previous scanline's uSerial when this one was drawn (Color TV blends with the previous scanline)
+	};
+
 
 // Globals (Public) ___________________________________________________
 	uint16_t g_nVideoClockVert = 0; // 9-bit: VC VB VA V5 V4 V3 V2 V1 V0 = 0 .. 262
@@ -144,9 +165,17 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 	static UpdateScreenFunc_t g_pFuncUpdateGraphicsScreen = 0; // updateScreenText40;
 	static UpdateScreenFunc_t g_pFuncModeSwitchDelayed = 0;
 
-	typedef void (*UpdatePixelFunc_t)(uint16_t);
-	static UpdatePixelFunc_t g_pFuncUpdateBnWPixel = 0; //updatePixelBnWMonitorSingleScanline;
-	static UpdatePixelFunc_t g_pFuncUpdateHuePixel = 0; //updatePixelHueMonitorSingleScanline;
+	// Monitor type, scanline mode and colour/mono are resolved once in NTSC_SetVideoStyle() to a kernel that draws a whole byte (14 pixels)
+	typedef void (*UpdatePixelsFunc_t)(uint16_t);
+	static UpdatePixelsFunc_t g_pFuncUpdateBnWPixels    = 0; // updatePixelsKernel<KERNEL_MONITOR_SINGLE, false, NTSC_PIXELS_PER_BYTE, true>
+	static UpdatePixelsFunc_t g_pFuncUpdateHuePixels    = 0; // updatePixelsKernel<KERNEL_MONITOR_SINGLE, true , NTSC_PIXELS_PER_BYTE, true>
+	static UpdatePixelsFunc_t g_pFuncUpdateBnWPixelsEOL = 0; // updatePixelsKernel<KERNEL_MONITOR_SINGLE, false, NTSC_PIXELS_PER_EOL , true>
+	static UpdatePixelsFunc_t g_pFuncUpdateHuePixelsEOL = 0; // updatePixelsKernel<KERNEL_MONITOR_SINGLE, true , NTSC_PIXELS_PER_EOL , true>
+
+	#define NTSC_PIXELS_PER_BYTE 14 // 7 Apple pixels, each doubled to 560 wide
+	#define NTSC_PIXELS_PER_EOL   4 // last column pixel + 3 trailing black
+
+	static bool g_bVideoSIMD = false; // CPU has SSE2 (and not disabled via NTSC_VideoSetSIMD())
 
 	static uint8_t  g_nTextFlashCounter = 0;
 	static uint16_t g_nTextFlashMask    = 0;
@@ -157,6 +186,12 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 	static int g_nLastColumnPixelNTSC;
 	static int g_nColorBurstPixels;
 
+	static uint32_t        g_uVideoModeNTSC = 0; // last NTSC_SetVideoMode() flags
+	static ScanlineState_t g_aScanlineState[VIDEO_SCANNER_Y_DISPLAY];
+	static bool            g_bScanlineStateValid = false; // false after any cycle-accurate drawing or video style change
+	static uint32_t        g_uScanlineSerial = 0;
+	static bool            g_aVideoPageDirty[0x60];       // text/lores pages $04-$0B, hires pages $20-$5F
+
 	#define INITIAL_COLOR_PHASE 0
 	static int g_nColorPhaseNTSC = INITIAL_COLOR_PHASE;
 	static int g_nSignalBitsNTSC = 0;
@@ -397,17 +432,14 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 	INLINE float     clampZeroOne( const float & x );
 	INLINE uint8_t   getCharSetBits( const int iChar );
 	INLINE uint16_t  getLoResBits( uint8_t iByte );
-	INLINE uint32_t  getScanlineColor( const uint16_t signal, const bgra_t *pTable );
 	INLINE uint32_t* getScanlineNext1Address();
 	INLINE uint32_t* getScanlinePrev1Address();
 	INLINE uint32_t* getScanlinePrev2Address();
 	INLINE uint32_t* getScanlineThis0Address();
-	INLINE void      updateColorPhase();
 	INLINE void      updateFlashRate();
-	INLINE void      updateFramebufferColorTVSingleScanline( uint16_t signal, bgra_t *pTable );
-	INLINE void      updateFramebufferColorTVDoubleScanline( uint16_t signal, bgra_t *pTable );
-	INLINE void      updateFramebufferMonitorSingleScanline( uint16_t signal, bgra_t *pTable );
-	INLINE void      updateFramebufferMonitorDoubleScanline( uint16_t signal, bgra_t *pTable );
+	INLINE uint32_t  updateFramebufferColorTVSingleScanline( const uint32_t color0, const uint32_t color2 );
+	INLINE uint32_t  updateFramebufferColorTVDoubleScanline( const uint32_t color0, const uint32_t color2 );
+	INLINE uint32_t  updateFramebufferMonitorSingleScanline( const uint32_t color0 );
 	INLINE void      updatePixels( uint16_t bits );
 	INLINE void      updateVideoScannerHorzEOL();
 	INLINE void      updateVideoScannerAddress();
@@ -422,14 +454,17 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 	static void initPixelDoubleMasks(void);
 	static void updateMonochromeTables( uint16_t r, uint16_t g, uint16_t b );
 
-	static void updatePixelBnWColorTVSingleScanline( uint16_t compositeSignal );
-	static void updatePixelBnWColorTVDoubleScanline( uint16_t compositeSignal );
-	static void updatePixelBnWMonitorSingleScanline( uint16_t compositeSignal );
-	static void updatePixelBnWMonitorDoubleScanline( uint16_t compositeSignal );
-	static void updatePixelHueColorTVSingleScanline( uint16_t compositeSignal );
-	static void updatePixelHueColorTVDoubleScanline( uint16_t compositeSignal );
-	static void updatePixelHueMonitorSingleScanline( uint16_t compositeSignal );
-	static void updatePixelHueMonitorDoubleScanline( uint16_t compositeSignal );
+	enum PixelsKernel_e
+	{
+		KERNEL_COLORTV_SINGLE,
+		KERNEL_COLORTV_DOUBLE,
+		KERNEL_MONITOR_SINGLE,
+		KERNEL_MONITOR_DOUBLE
+	};
+
+	template <int KERNEL, bool bHue, int nPixels, bool bSIMD> static void updatePixelsKernel( uint16_t bits );
+	template <int KERNEL, bool bHue, bool bSIMD> static void setPixelsKernelsSIMD();
+	template <int KERNEL, bool bHue> static void setPixelsKernels();
 
 	static void updateScreenDoubleHires40( long cycles6502 );
 	static void updateScreenDoubleHires80( long cycles6502 );
@@ -478,13 +513,6 @@ inline uint16_t getLoResBits( uint8_t iByte )
 	return g_aPixelMaskGR[ (iByte >> (g_nVideoClockVert & 4)) & 0xF ]; 
 }
 
-//===========================================================================
-inline uint32_t getScanlineColor( const uint16_t signal, const bgra_t *pTable )
-{
-	g_nSignalBitsNTSC = ((g_nSignalBitsNTSC << 1) | signal) & 0xFFF; // 12-bit
-	return *(uint32_t*) &pTable[ g_nSignalBitsNTSC ];
-}
-
 //===========================================================================
 inline uint32_t* getScanlineNext1Address()
 {
@@ -509,13 +537,6 @@ inline uint32_t* getScanlineThis0Address()
 	return (uint32_t*) g_pVideoAddress;
 }
 
-//===========================================================================
-inline void updateColorPhase()
-{
-	g_nColorPhaseNTSC++;
-	g_nColorPhaseNTSC &= 3;
-}
-
 //===========================================================================
 inline void updateFlashRate() // TODO: Flash rate should be constant (regardless of CPU speed)
 {
@@ -589,71 +610,29 @@ inline void updateFlashRate() // TODO: Flash rate should be constant (regardless
 #else
 
 //===========================================================================
-inline void updateFramebufferColorTVSingleScanline( uint16_t signal, bgra_t *pTable )
+inline uint32_t updateFramebufferColorTVSingleScanline( const uint32_t color0, const uint32_t color2 )
 {
-	/* */ uint32_t *pLine0Address = getScanlineThis0Address();
-	/* */ uint32_t *pLine1Address = getScanlinePrev1Address();
-	/* */ uint32_t *pLine2Address = getScanlinePrev2Address();
-
-	const uint32_t color0 = getScanlineColor( signal, pTable );
-	const uint32_t color2 = *pLine2Address;
 //	const uint32_t color1 = color0 - ((color2 & 0x00fcfcfc) >> 2); // BUG? color0 - color0? not color0-color2?
 	// TC: The above operation "color0 - ((color2 & 0x00fcfcfc) >> 2)" causes underflow, so I've recoded to clamp on underflow:
-	uint32_t color1;
-	{
-		int r=(color0>>16)&0xff, g=(color0>>8)&0xff, b=color0&0xff;
-		uint32_t color2_prime = (color2 & 0x00fcfcfc) >> 2;
-		r -= (color2_prime>>16)&0xff; if (r<0) r=0;	// clamp to 0 on underflow
-		g -= (color2_prime>>8)&0xff;  if (g<0) g=0;	// clamp to 0 on underflow
-		b -= (color2_prime)&0xff;     if (b<0) b=0;	// clamp to 0 on underflow
-		color1 = (r<<16)|(g<<8)|(b);
-	}
-
-	/* */  *pLine1Address = color1 | ALPHA32_MASK;
-	/* */  *pLine0Address = color0;
-	/* */ g_pVideoAddress++;
+	int r=(color0>>16)&0xff, g=(color0>>8)&0xff, b=color0&0xff;
+	uint32_t color2_prime = (color2 & 0x00fcfcfc) >> 2;
+	r -= (color2_prime>>16)&0xff; if (r<0) r=0;	// clamp to 0 on underflow
+	g -= (color2_prime>>8)&0xff;  if (g<0) g=0;	// clamp to 0 on underflow
+	b -= (color2_prime)&0xff;     if (b<0) b=0;	// clamp to 0 on underflow
+	return (r<<16)|(g<<8)|(b);
 }
 
 //===========================================================================
-inline void updateFramebufferColorTVDoubleScanline( uint16_t signal, bgra_t *pTable )
+inline uint32_t updateFramebufferColorTVDoubleScanline( const uint32_t color0, const uint32_t color2 )
 {
-	/* */ uint32_t *pLine0Address = getScanlineThis0Address();
-	/* */ uint32_t *pLine1Address = getScanlinePrev1Address();
-	const uint32_t *pLine2Address = getScanlinePrev2Address();
-
-	const uint32_t color0 = getScanlineColor( signal, pTable );
-	const uint32_t color2 = *pLine2Address;
-	const uint32_t color1 = ((color0 & 0x00fefefe) >> 1) + ((color2 & 0x00fefefe) >> 1); // 50% Blend
-
-	/* */  *pLine1Address = color1 | ALPHA32_MASK;
-	/* */  *pLine0Address = color0;
-	/* */ g_pVideoAddress++;
+	return ((color0 & 0x00fefefe) >> 1) + ((color2 & 0x00fefefe) >> 1); // 50% Blend
 }
 
 //===========================================================================
-inline void updateFramebufferMonitorSingleScanline( uint16_t signal, bgra_t *pTable )
+inline uint32_t updateFramebufferMonitorSingleScanline( const uint32_t color0 )
 {
-	/* */ uint32_t *pLine0Address = getScanlineThis0Address();
-	/* */ uint32_t *pLine1Address = getScanlineNext1Address();
-	const uint32_t color0 = getScanlineColor( signal, pTable );
-	const uint32_t color1 = ((color0 & 0x00fcfcfc) >> 2); // 25% Blend (original)
-//	const uint32_t color1 = ((color0 & 0x00fefefe) >> 1); // 50% Blend -- looks OK most of the time; Archon looks poor
-
-	/* */  *pLine1Address = color1 | ALPHA32_MASK;
-	/* */  *pLine0Address = color0;
-	/* */ g_pVideoAddress++;
-}
-
-//===========================================================================
-inline void updateFramebufferMonitorDoubleScanline( uint16_t signal, bgra_t *pTable )
-{
-	/* */ uint32_t *pLine0Address = getScanlineThis0Address();
-	/* */ uint32_t *pLine1Address = getScanlineNext1Address();
-	const uint32_t color0 = getScanlineColor( signal, pTable );
-
-	/* */  *pLine1Address = color0;
-	/* */  *pLine0Address = color0;
-	/* */ g_pVideoAddress++;
+	return ((color0 & 0x00fcfcfc) >> 2); // 25% Blend (original)
+//	return ((color0 & 0x00fefefe) >> 1); // 50% Blend -- looks OK most of the time; Archon looks poor
 }
 #endif
 
@@ -664,55 +643,11 @@ inline void updateFramebufferMonitorDoubleScanline( uint16_t signal, bgra_t *pTa
 inline void updatePixels( uint16_t bits )
 {
 	if (g_nColorBurstPixels < 2)
-	{ 
-		/* #1 of 7 */
-		g_pFuncUpdateBnWPixel(bits & 1); bits >>= 1;
-		g_pFuncUpdateBnWPixel(bits & 1); bits >>= 1;
-		/* #2 of 7 */
-		g_pFuncUpdateBnWPixel(bits & 1); bits >>= 1;
-		g_pFuncUpdateBnWPixel(bits & 1); bits >>= 1;
-		/* #3 of 7 */
-		g_pFuncUpdateBnWPixel(bits & 1); bits >>= 1;
-		g_pFuncUpdateBnWPixel(bits & 1); bits >>= 1;
-		/* #4 of 7 */
-		g_pFuncUpdateBnWPixel(bits & 1); bits >>= 1;
-		g_pFuncUpdateBnWPixel(bits & 1); bits >>= 1;
-		/* #5 of 7 */
-		g_pFuncUpdateBnWPixel(bits & 1); bits >>= 1;
-		g_pFuncUpdateBnWPixel(bits & 1); bits >>= 1;
-		/* #6 of 7 */
-		g_pFuncUpdateBnWPixel(bits & 1); bits >>= 1;
-		g_pFuncUpdateBnWPixel(bits & 1); bits >>= 1;
-		/* #7 of 7 */
-		g_pFuncUpdateBnWPixel(bits & 1); bits >>= 1;
-		g_pFuncUpdateBnWPixel(bits & 1);
-        g_nLastColumnPixelNTSC = bits & 1;
-	}
+		g_pFuncUpdateBnWPixels(bits);
 	else
-	{
-		/* #1 of 7 */                                // abcd efgh ijkl mnop
-		g_pFuncUpdateHuePixel(bits & 1); bits >>= 1; // 0abc defg hijk lmno
-		g_pFuncUpdateHuePixel(bits & 1); bits >>= 1; // 00ab cdef ghi jklmn
-		/* #2 of 7 */
-		g_pFuncUpdateHuePixel(bits & 1); bits >>= 1; // 000a bcde fghi jklm
-		g_pFuncUpdateHuePixel(bits & 1); bits >>= 1; // 0000 abcd efgh ijkl
-		/* #3 of 7 */
-		g_pFuncUpdateHuePixel(bits & 1); bits >>= 1; // 0000 0abc defg hijk
-		g_pFuncUpdateHuePixel(bits & 1); bits >>= 1; // 0000 00ab cdef ghij
-		/* #4 of 7 */
-		g_pFuncUpdateHuePixel(bits & 1); bits >>= 1; // 0000 000a bcde fghi
-		g_pFuncUpdateHuePixel(bits & 1); bits >>= 1; // 0000 0000 abcd efgh
-		/* #5 of 7 */
-		g_pFuncUpdateHuePixel(bits & 1); bits >>= 1; // 0000 0000 0abc defg
-		g_pFuncUpdateHuePixel(bits & 1); bits >>= 1; // 0000 0000 00ab cdef
-		/* #6 of 7 */
-		g_pFuncUpdateHuePixel(bits & 1); bits >>= 1; // 0000 0000 000a bcde
-		g_pFuncUpdateHuePixel(bits & 1); bits >>= 1; // 0000 0000 0000 abcd
-		/* #7 of 7 */
-		g_pFuncUpdateHuePixel(bits & 1); bits >>= 1; // 0000 0000 0000 0abc
-		g_pFuncUpdateHuePixel(bits & 1);           
-        g_nLastColumnPixelNTSC = bits & 1;
-	}
+		g_pFuncUpdateHuePixels(bits);
+
+	g_nLastColumnPixelNTSC = (bits >> 13) & 1;
 }
 
 //===========================================================================
@@ -723,22 +658,11 @@ inline void updateVideoScannerHorzEOL()
 		if (g_nVideoClockVert < VIDEO_SCANNER_Y_DISPLAY)
 		{
 			//VIDEO_DRAW_ENDLINE();
+			// NOTE: This writes out-of-bounds for a 560x384 framebuffer
 			if (g_nColorBurstPixels < 2)
-			{
-				// NOTE: This writes out-of-bounds for a 560x384 framebuffer
-				g_pFuncUpdateBnWPixel(g_nLastColumnPixelNTSC);
-				g_pFuncUpdateBnWPixel(0);
-				g_pFuncUpdateBnWPixel(0);
-				g_pFuncUpdateBnWPixel(0);
-			}
+				g_pFuncUpdateBnWPixelsEOL(g_nLastColumnPixelNTSC);
 			else
-			{
-				// NOTE: This writes out-of-bounds for a 560x384 framebuffer
-				g_pFuncUpdateHuePixel(g_nLastColumnPixelNTSC);
-				g_pFuncUpdateHuePixel(0);
-				g_pFuncUpdateHuePixel(0);
-				g_pFuncUpdateHuePixel(0);
-			}
+				g_pFuncUpdateHuePixelsEOL(g_nLastColumnPixelNTSC);
 		}
 
 		g_nVideoClockHorz = 0;
@@ -1037,7 +961,7 @@ static void initPixelDoubleMasks (void)
 {
 	/*
 		Convert 7-bit monochrome luminance to 14-bit double pixel luminance
-		Chroma will be applied later based on the color phase in updatePixelHueMonitorDoubleScanline( luminanceBit )
+		Chroma will be applied later based on the color phase in updatePixelsKernel<KERNEL_MONITOR_DOUBLE, true>( bits )
 			0x001 -> 0x0003
 			0x002 -> 0x000C
 			0x004 -> 0x0030
@@ -1072,55 +996,134 @@ void updateMonochromeTables( uint16_t r, uint16_t g, uint16_t b )
 }
 
 //===========================================================================
-static void updatePixelBnWMonitorSingleScanline (uint16_t compositeSignal)
-{
-	updateFramebufferMonitorSingleScanline(compositeSignal, g_aBnWMonitorCustom);
-}
 
-//===========================================================================
-static void updatePixelBnWMonitorDoubleScanline (uint16_t compositeSignal)
+#if NTSC_SSE2
+// Blend this scanline (already drawn) with the previous scanline into the interpolated scanline, 4 pixels at a time.
+// NB. Must be bit-identical to the scalar updateFramebuffer*() helpers:
+// . ColorTV single: per-channel clamp-subtract == unsigned saturated subtract
+// . ColorTV double: (a>>1)+(b>>1) per channel, so not _mm_avg_epu8() which rounds up
+template <int KERNEL>
+static void updateFramebufferScanlineSSE2( uint32_t *pLine1Address, const uint32_t *pLine0Address, const uint32_t *pLine2Address, const int nPixels )
 {
-	updateFramebufferMonitorDoubleScanline(compositeSignal, g_aBnWMonitorCustom);
-}
+	const __m128i mask25 = _mm_set1_epi32( 0x00fcfcfc );
+	const __m128i mask50 = _mm_set1_epi32( 0x00fefefe );
+	const __m128i alpha  = _mm_set1_epi32( (int)ALPHA32_MASK );
 
-//===========================================================================
-static void updatePixelBnWColorTVSingleScanline (uint16_t compositeSignal)
-{
-	updateFramebufferColorTVSingleScanline(compositeSignal, g_aBnWColorTVCustom);
-}
+	int x = 0;
+	for (; x + 4 <= nPixels; x += 4)
+	{
+		const __m128i color0 = _mm_loadu_si128( (const __m128i*) &pLine0Address[x] );
+		__m128i color1;
 
-//===========================================================================
-static void updatePixelBnWColorTVDoubleScanline (uint16_t compositeSignal)
-{
-	updateFramebufferColorTVDoubleScanline(compositeSignal, g_aBnWColorTVCustom);
-}
+		switch (KERNEL)
+		{
+		case KERNEL_COLORTV_SINGLE:
+			color1 = _mm_srli_epi32( _mm_and_si128( _mm_loadu_si128( (const __m128i*) &pLine2Address[x] ), mask25 ), 2 );
+			color1 = _mm_subs_epu8( color0, color1 );
+			break;
+		case KERNEL_COLORTV_DOUBLE:
+			color1 = _mm_srli_epi32( _mm_and_si128( _mm_loadu_si128( (const __m128i*) &pLine2Address[x] ), mask50 ), 1 );
+			color1 = _mm_add_epi32( _mm_srli_epi32( _mm_and_si128( color0, mask50 ), 1 ), color1 );
+			break;
+		default: // KERNEL_MONITOR_SINGLE
+			color1 = _mm_srli_epi32( _mm_and_si128( color0, mask25 ), 2 );
+			break;
+		}
 
-//===========================================================================
-static void updatePixelHueColorTVSingleScanline (uint16_t compositeSignal)
-{
-	updateFramebufferColorTVSingleScanline(compositeSignal, g_aHueColorTV[g_nColorPhaseNTSC]);
-	updateColorPhase();
+		_mm_storeu_si128( (__m128i*) &pLine1Address[x], _mm_or_si128( color1, alpha ) );
+	}
+
+	for (; x < nPixels; x++)
+	{
+		switch (KERNEL)
+		{
+		case KERNEL_COLORTV_SINGLE: pLine1Address[x] = updateFramebufferColorTVSingleScanline( pLine0Address[x], pLine2Address[x] ) | ALPHA32_MASK; break;
+		case KERNEL_COLORTV_DOUBLE: pLine1Address[x] = updateFramebufferColorTVDoubleScanline( pLine0Address[x], pLine2Address[x] ) | ALPHA32_MASK; break;
+		default:                    pLine1Address[x] = updateFramebufferMonitorSingleScanline( pLine0Address[x] ) | ALPHA32_MASK; break;
+		}
+	}
 }
+#endif
 
 //===========================================================================
-static void updatePixelHueColorTVDoubleScanline (uint16_t compositeSignal)
+
+// Draw nPixels of composite signal (LSB first) to this scanline and the interpolated scanline.
+// All choices (table, blend, colour phase) are template parameters, so each kernel is a straight loop.
+// bSIMD: draw this scanline first, then blend the interpolated scanline with SSE2.
+template <int KERNEL, bool bHue, int nPixels, bool bSIMD>
+static void updatePixelsKernel( uint16_t bits )
 {
-	updateFramebufferColorTVDoubleScanline(compositeSignal, g_aHueColorTV[g_nColorPhaseNTSC]);
-	updateColorPhase();
+	const bool bColorTV = (KERNEL == KERNEL_COLORTV_SINGLE) || (KERNEL == KERNEL_COLORTV_DOUBLE);
+	const bool bBlendSIMD = NTSC_SSE2 && bSIMD && (KERNEL != KERNEL_MONITOR_DOUBLE);
+
+	/* */ uint32_t *pLine0Address = getScanlineThis0Address();
+	/* */ uint32_t *pLine1Address = bColorTV ? getScanlinePrev1Address() : getScanlineNext1Address();
+	const uint32_t *pLine2Address = getScanlinePrev2Address();	// ColorTV only
+
+	const bgra_t (*pHueTable)[NTSC_NUM_SEQUENCES] = bColorTV ? g_aHueColorTV       : g_aHueMonitor;
+	const bgra_t  *pBnWTable                      = bColorTV ? g_aBnWColorTVCustom : g_aBnWMonitorCustom;
+
+	int signalBits = g_nSignalBitsNTSC;
+	int colorPhase = g_nColorPhaseNTSC;
+
+	for (int x = 0; x < nPixels; x++)
+	{
+		signalBits = ((signalBits << 1) | (bits & 1)) & 0xFFF; // 12-bit
+		bits >>= 1;
+
+		const bgra_t *pTable = bHue ? pHueTable[colorPhase] : pBnWTable;
+		const uint32_t color0 = *(uint32_t*) &pTable[signalBits];
+
+		if (!bBlendSIMD)
+		{
+			uint32_t color1;
+
+			switch (KERNEL)
+			{
+			case KERNEL_COLORTV_SINGLE: color1 = updateFramebufferColorTVSingleScanline( color0, pLine2Address[x] ) | ALPHA32_MASK; break;
+			case KERNEL_COLORTV_DOUBLE: color1 = updateFramebufferColorTVDoubleScanline( color0, pLine2Address[x] ) | ALPHA32_MASK; break;
+			case KERNEL_MONITOR_SINGLE: color1 = updateFramebufferMonitorSingleScanline( color0 ) | ALPHA32_MASK; break;
+			default:                    color1 = color0; break;	// KERNEL_MONITOR_DOUBLE
+			}
+
+			pLine1Address[x] = color1;
+		}
+
+		pLine0Address[x] = color0;
+
+		if (bHue)
+			colorPhase = (colorPhase + 1) & 3;
+	}
+
+#if NTSC_SSE2
+	if (bBlendSIMD)
+		updateFramebufferScanlineSSE2<KERNEL>( pLine1Address, pLine0Address, pLine2Address, nPixels );
+#endif
+
+	g_nSignalBitsNTSC = signalBits;
+	g_nColorPhaseNTSC = colorPhase;
+	g_pVideoAddress  += nPixels;
 }
 
 //===========================================================================
-static void updatePixelHueMonitorSingleScanline (uint16_t compositeSignal)
+
+// NB. Monochrome video types use the BnW kernel for both (ie. bHue=false), so the colour phase is not advanced
+template <int KERNEL, bool bHue, bool bSIMD>
+static void setPixelsKernelsSIMD()
 {
-	updateFramebufferMonitorSingleScanline(compositeSignal, g_aHueMonitor[g_nColorPhaseNTSC]);
-	updateColorPhase();
+	g_pFuncUpdateBnWPixels    = updatePixelsKernel<KERNEL, false, NTSC_PIXELS_PER_BYTE, bSIMD>;
+	g_pFuncUpdateBnWPixelsEOL = updatePixelsKernel<KERNEL, false, NTSC_PIXELS_PER_EOL , bSIMD>;
+	g_pFuncUpdateHuePixels    = updatePixelsKernel<KERNEL, bHue , NTSC_PIXELS_PER_BYTE, bSIMD>;
+	g_pFuncUpdateHuePixelsEOL = updatePixelsKernel<KERNEL, bHue , NTSC_PIXELS_PER_EOL , bSIMD>;
 }
 
-//===========================================================================
-static void updatePixelHueMonitorDoubleScanline (uint16_t compositeSignal)
+template <int KERNEL, bool bHue>
+static void setPixelsKernels()
 {
-	updateFramebufferMonitorDoubleScanline(compositeSignal, g_aHueMonitor[g_nColorPhaseNTSC]);
-	updateColorPhase();
+	if (g_bVideoSIMD)
+		setPixelsKernelsSIMD<KERNEL, bHue, true>();
+	else
+		setPixelsKernelsSIMD<KERNEL, bHue, false>();
 }
 
 //===========================================================================
@@ -1491,6 +1494,7 @@ void NTSC_SetVideoTextMode( int cols )
 //===========================================================================
 void NTSC_SetVideoMode( uint32_t uVideoModeFlags )
 {
+	g_uVideoModeNTSC = uVideoModeFlags;
 	g_nVideoMixed   = uVideoModeFlags & VF_MIXED;
 	g_nVideoCharSet = VideoGetSWAltCharSet() ? 1 : 0;
 
@@ -1537,6 +1541,8 @@ void NTSC_SetVideoStyle() // (int v, int s)
     int half = g_uHalfScanLines;
 	uint8_t r, g, b;
 
+	g_bScanlineStateValid = false;
+
 	switch ( g_eVideoType )
 	{
 		case VT_COLOR_TV:
@@ -1546,12 +1552,10 @@ void NTSC_SetVideoStyle() // (int v, int s)
 			updateMonochromeTables( r, g, b );
 			if (half)
 			{
-				g_pFuncUpdateBnWPixel = updatePixelBnWColorTVSingleScanline;
-				g_pFuncUpdateHuePixel = updatePixelHueColorTVSingleScanline;
+				setPixelsKernels<KERNEL_COLORTV_SINGLE, true>();
 			}
 			else {
-				g_pFuncUpdateBnWPixel = updatePixelBnWColorTVDoubleScanline;
-				g_pFuncUpdateHuePixel = updatePixelHueColorTVDoubleScanline;
+				setPixelsKernels<KERNEL_COLORTV_DOUBLE, true>();
 			}
 			break;
 
@@ -1563,12 +1567,10 @@ void NTSC_SetVideoStyle() // (int v, int s)
 			updateMonochromeTables( r, g, b );
 			if (half)
 			{
-				g_pFuncUpdateBnWPixel = updatePixelBnWMonitorSingleScanline;
-				g_pFuncUpdateHuePixel = updatePixelHueMonitorSingleScanline;
+				setPixelsKernels<KERNEL_MONITOR_SINGLE, true>();
 			}
 			else {
-				g_pFuncUpdateBnWPixel = updatePixelBnWMonitorDoubleScanline;
-				g_pFuncUpdateHuePixel = updatePixelHueMonitorDoubleScanline;
+				setPixelsKernels<KERNEL_MONITOR_DOUBLE, true>();
 			}
 			break;
 
@@ -1579,10 +1581,10 @@ void NTSC_SetVideoStyle() // (int v, int s)
 			updateMonochromeTables( r, g, b ); // Custom Monochrome color
 			if (half)
 			{
-				g_pFuncUpdateBnWPixel = g_pFuncUpdateHuePixel = updatePixelBnWColorTVSingleScanline;
+				setPixelsKernels<KERNEL_COLORTV_SINGLE, false>();
 			}
 			else {
-				g_pFuncUpdateBnWPixel = g_pFuncUpdateHuePixel = updatePixelBnWColorTVDoubleScanline;
+				setPixelsKernels<KERNEL_COLORTV_DOUBLE, false>();
 			}
 			break;
 
@@ -1618,11 +1620,11 @@ _mono:
 			updateMonochromeTables( r, g, b ); // Custom Monochrome color
 			if (half)
 			{
-				g_pFuncUpdateBnWPixel = g_pFuncUpdateHuePixel = updatePixelBnWMonitorSingleScanline;
+				setPixelsKernels<KERNEL_MONITOR_SINGLE, false>();
 			}
 			else
 			{
-				g_pFuncUpdateBnWPixel = g_pFuncUpdateHuePixel = updatePixelBnWMonitorDoubleScanline;
+				setPixelsKernels<KERNEL_MONITOR_DOUBLE, false>();
 			}
 			break;
 		}
@@ -1631,6 +1633,8 @@ _mono:
 //===========================================================================
 void NTSC_VideoInit( uint8_t* pFramebuffer ) // wsVideoInit
 {
+	NTSC_VideoSetSIMD( true );	// NB. Before VideoReinitialize() which selects the pixel kernels
+
 	make_csbits();
 	initPixelDoubleMasks();
 	initChromaPhaseTables();
@@ -1648,7 +1652,7 @@ void NTSC_VideoInit( uint8_t* pFramebuffer ) // wsVideoInit
 	g_pFuncUpdateTextScreen     = updateScreenText40;
 	g_pFuncUpdateGraphicsScreen = updateScreenText40;
 
-	VideoReinitialize(); // Setup g_pFunc_ntsc*Pixel()
+	VideoReinitialize(); // Setup g_pFuncUpdate*Pixels()
 
 #if HGR_TEST_PATTERN
 // Init HGR to almost all-possible-combinations
@@ -1729,12 +1733,32 @@ void NTSC_VideoInitAppleType ()
 		g_pHorzClockOffset = APPLE_IIP_HORZ_CLOCK_OFFSET;
 
 	set_csbits();
+	g_bScanlineStateValid = false;
+}
+
+//===========================================================================
+
+// Enable the SSE2 scanline blend if the CPU supports it (else use the scalar kernels)
+// Returns true if SIMD is now in use
+bool NTSC_VideoSetSIMD( bool bEnable )
+{
+#if NTSC_SSE2
+	g_bVideoSIMD = bEnable && IsProcessorFeaturePresent(PF_XMMI64_INSTRUCTIONS_AVAILABLE);
+#else
+	g_bVideoSIMD = false;
+#endif
+
+	if (g_pFuncUpdateBnWPixels)	// Already init'ed, so reselect the pixel kernels
+		NTSC_SetVideoStyle();
+
+	return g_bVideoSIMD;
 }
 
 //===========================================================================
 void NTSC_VideoInitChroma()
 {
 	initChromaPhaseTables();
+	g_bScanlineStateValid = false;
 }
 
 //===========================================================================
@@ -1793,11 +1817,115 @@ void NTSC_VideoUpdateCycles( long cycles6502 )
 {
 	_ASSERT(cycles6502 < VIDEO_SCANNER_6502_CYCLES);	// Use NTSC_VideoRedrawWholeScreen() instead
 
+	g_bScanlineStateValid = false;	// Cycle-accurate drawing: mode & memory can change mid-frame
 	VideoUpdateCycles(cycles6502);
 }
 
+//===========================================================================
+
+// Gather (and clear) the 6502 writes to the text/lores & hires pages (main or aux) since the last redraw
+static void updateVideoPagesDirty( void )
+{
+	for (UINT page = 0x04; page < 0x60; page++)
+	{
+		if (page == 0x0C)
+			page = 0x20;
+
+		g_aVideoPageDirty[page] = (memdirty[page] & MEMDIRTY_VIDEO) != 0;
+		memdirty[page] &= ~MEMDIRTY_VIDEO;
+	}
+}
+
+//===========================================================================
+
+// Pre: g_nVideoClockHorz == 0 && nVert < VIDEO_SCANNER_Y_DISPLAY
+static bool isScanlineClean( const uint16_t nVert )
+{
+	const ScanlineState_t& state = g_aScanlineState[ nVert ];
+
+	if (!state.bValid
+		|| state.uVideoMode     != g_uVideoModeNTSC
+		|| state.nVideoCharSet  != g_nVideoCharSet
+		|| state.nColorBurstBeg != g_nColorBurstPixels)
+		return false;
+
+	if (nVert && state.uPrevSerial != g_aScanlineState[ nVert-1 ].uSerial)
+		return false;
+
+	const bool bText = (g_uVideoModeNTSC & VF_TEXT) || (g_nVideoMixed && nVert >= VIDEO_SCANNER_Y_MIXED);
+	if (bText && state.nTextFlashMask != g_nTextFlashMask)
+		return false;
+
+	// NB. A scanline's 40 bytes are all in the same page (for both main & aux)
+	const uint16_t addrTXT = g_aClockVertOffsetsTXT[nVert/8] + g_pHorzClockOffset[nVert/64][VIDEO_SCANNER_HORZ_START] + (g_nTextPage * 0x400);
+	const uint16_t addrHGR = g_aClockVertOffsetsHGR[nVert] + APPLE_IIE_HORZ_CLOCK_OFFSET[nVert/64][VIDEO_SCANNER_HORZ_START] + (g_nHiresPage * 0x2000);
+
+	return !g_aVideoPageDirty[addrTXT >> 8] && !g_aVideoPageDirty[addrHGR >> 8];
+}
+
+//===========================================================================
+
+// Draw all 262 scanlines, starting at H-pos=0 of the current V-pos
+static void VideoRedrawScanlines( const bool bSkipCleanScanlines )
+{
+	const bool bSkip = bSkipCleanScanlines && g_bScanlineStateValid;
+	if (!g_bScanlineStateValid)
+	{
+		for (int y = 0; y < VIDEO_SCANNER_Y_DISPLAY; y++)
+			g_aScanlineState[y].bValid = false;
+	}
+
+	updateVideoPagesDirty();
+
+	for (int line = 0; line < VIDEO_SCANNER_MAX_VERT; line++)
+	{
+		const uint16_t nVert = g_nVideoClockVert;
+
+		if (nVert >= VIDEO_SCANNER_Y_DISPLAY)
+		{
+			g_pFuncUpdateGraphicsScreen(VIDEO_SCANNER_MAX_HORZ);	// Nothing drawn, but colour-burst & flash state are updated
+			continue;
+		}
+
+		ScanlineState_t& state = g_aScanlineState[ nVert ];
+
+		if (bSkip && isScanlineClean(nVert))
+		{
+			// As updateVideoScannerHorzEOL(), but without drawing
+			g_nVideoClockHorz = 0;
+			if (++g_nVideoClockVert < VIDEO_SCANNER_Y_DISPLAY)
+				updateVideoScannerAddress();
+			g_nColorBurstPixels = state.nColorBurstEnd;
+			continue;
+		}
+
+		state.bValid         = true;
+		state.uVideoMode     = g_uVideoModeNTSC;
+		state.nVideoCharSet  = g_nVideoCharSet;
+		state.nColorBurstBeg = g_nColorBurstPixels;
+		state.nTextFlashMask = g_nTextFlashMask;
+		state.uSerial        = ++g_uScanlineSerial;
+		state.uPrevSerial    = nVert ? g_aScanlineState[ nVert-1 ].uSerial : 0;
+
+		g_pFuncUpdateGraphicsScreen(VIDEO_SCANNER_MAX_HORZ);
+
+		state.nColorBurstEnd = g_nColorBurstPixels;
+	}
+
+	g_bScanlineStateValid = true;
+}
+
 //===========================================================================
 void NTSC_VideoRedrawWholeScreen( void )
+{
+	NTSC_VideoRedrawDirtyScanlines( false );
+}
+
+//===========================================================================
+
+// bSkipCleanScanlines: only draw the displayed scanlines whose memory, video mode, colour-burst or flash state have changed since last drawn
+// . the framebuffer ends up the same as from NTSC_VideoRedrawWholeScreen()
+void NTSC_VideoRedrawDirtyScanlines( bool bSkipCleanScanlines )
 {
 #ifdef _DEBUG
 	const uint16_t currVideoClockVert = g_nVideoClockVert;
@@ -1811,10 +1939,17 @@ void NTSC_VideoRedrawWholeScreen( void )
 	g_nVideoClockHorz = 0;
 	updateVideoScannerAddress();
 
-	VideoUpdateCycles(VIDEO_SCANNER_6502_CYCLES);
+	VideoRedrawScanlines(bSkipCleanScanlines);
 
 	VideoUpdateCycles(horz);	// Finally update to get to correct H-pos
 
+	// This scanline has been partially redrawn from the end-of-frame state, so draw it all next time
+	if (horz && g_nVideoClockVert < VIDEO_SCANNER_Y_DISPLAY)
+	{
+		g_aScanlineState[ g_nVideoClockVert ].bValid  = false;
+		g_aScanlineState[ g_nVideoClockVert ].uSerial = ++g_uScanlineSerial;
+	}
+
 #ifdef _DEBUG
 	_ASSERT(currVideoClockVert == g_nVideoClockVert);
 	_ASSERT(currVideoClockHorz == g_nVideoClockHorz);
@@ -17,6 +17,8 @@
 	extern void     NTSC_VideoReinitialize( DWORD cyclesThisFrame );
 	extern void     NTSC_VideoInitAppleType();
 	extern void     NTSC_VideoInitChroma();
+	extern bool     NTSC_VideoSetSIMD( bool bEnable );
 	extern void     NTSC_VideoUpdateCycles( long cycles6502 );
 	extern void     NTSC_VideoRedrawWholeScreen( void );
+	extern void     NTSC_VideoRedrawDirtyScanlines( bool bSkipCleanScanlines );
 	extern bool     NTSC_GetColorBurst( void );
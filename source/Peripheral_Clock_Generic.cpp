@@ -29,6 +29,8 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 // #include "resource.h" // BUG -- wrong resource!!!
 #include <time.h>
 
+#include "Memory.h"
+
 /*
 
 Old:
@@ -117,5 +119,13 @@ void Clock_Util_ConvertTimeToProdos( tm *pTime, unsigned char *pProDosBytes4_ )
 void Clock_Generic_UpdateProDos()
 {
 	tm* pTime = Clock_Util_GetTime();
-	Clock_Util_ConvertTimeToProdos( pTime, &mem[ 0xBF90 ] ); // ProDos date/time buffer
+	if( !pTime )
+		return;
+
+	BYTE aProDosTime[4];
+	Clock_Util_ConvertTimeToProdos( pTime, aProDosTime );
+
+	// Write to the ProDos date/time buffer as the 6502 would (not to mem[], which may be a stale view: see MEM_NOCOPY_PAGING)
+	for( WORD addr = 0xBF90; addr < 0xBF90 + sizeof(aProDosTime); addr++ )
+		WriteByteToMemory( addr, aProDosTime[ addr - 0xBF90 ] );
 }
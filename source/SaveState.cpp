@@ -53,6 +53,7 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 
 
 #define DEFAULT_SNAPSHOT_NAME "SaveState.aws.yaml"
+#define BINARY_SNAPSHOT_EXT ".aws.bin"		// Same YAML, but memory is stored as compressed binary (see YamlHelper.h)
 
 bool g_bSaveStateOnExit = false;
 
@@ -569,11 +570,18 @@ void Snapshot_LoadState()
 // todo:
 // . Uthernet card
 
+static bool IsBinarySnapshot(void)
+{
+	const std::string ext_bin = (BINARY_SNAPSHOT_EXT);
+	return g_strSaveStatePathname.size() >= ext_bin.size()
+		&& g_strSaveStatePathname.compare(g_strSaveStatePathname.size() - ext_bin.size(), ext_bin.size(), ext_bin) == 0;
+}
+
 void Snapshot_SaveState(void)
 {
 	try
 	{
-		YamlSaveHelper yamlSaveHelper(g_strSaveStatePathname);
+		YamlSaveHelper yamlSaveHelper(g_strSaveStatePathname, IsBinarySnapshot());
 		yamlSaveHelper.FileHdr(SS_FILE_VER);
 
 		// Unit: Apple2
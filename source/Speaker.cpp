@@ -29,12 +29,15 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 #include "StdAfx.h"
 
 #include "Applewin.h"
+#include "AudioThread.h"
 #include "CPU.h"
 #include "Frame.h"
+#include "HostServices.h"
 #include "Log.h"
 #include "Memory.h"
 #include "SoundCore.h"
 #include "Speaker.h"
+#include "SpeakerBLEP.h"
 #include "Video.h"	// VideoRedrawScreen()
 #include "YamlHelper.h"
 
@@ -66,10 +69,6 @@ const short		SPKR_DATA_INIT = (short)0x8000;
 short		g_nSpeakerData	= SPKR_DATA_INIT;
 static UINT		g_nBufferIdx	= 0;
 
-static short*	g_pRemainderBuffer = NULL;
-static UINT		g_nRemainderBufferSize;		// Setup in SpkrInitialize()
-static UINT		g_nRemainderBufferIdx;		// Setup in SpkrInitialize()
-
 // Application-wide globals:
 SoundType_e		soundtype		= SOUND_WAVE;
 double		    g_fClksPerSpkrSample;		// Setup in SetClksPerSpkrSample()
@@ -82,6 +81,7 @@ static DWORD	lastcyclenum	= 0;
 static DWORD	toggles			= 0;
 static unsigned __int64	g_nSpkrQuietCycleCount = 0;
 static unsigned __int64 g_nSpkrLastCycle = 0;
+static unsigned __int64 g_nSpkrLastToggleCycle = 0;
 static bool g_bSpkrToggleFlag = false;
 static VOICE SpeakerVoice = {0};
 static bool g_bSpkrAvailable = false;
@@ -89,8 +89,6 @@ static bool g_bSpkrAvailable = false;
 //-----------------------------------------------------------------------------
 
 // Forward refs:
-ULONG   Spkr_SubmitWaveBuffer_FullSpeed(short* pSpeakerBuffer, ULONG nNumSamples);
-ULONG   Spkr_SubmitWaveBuffer(short* pSpeakerBuffer, ULONG nNumSamples);
 void    Spkr_SetActive(bool bActive);
 
 //=============================================================================
@@ -122,7 +120,7 @@ static void DisplayBenchmarkResults ()
 //
 // The approach works as follows:
 // - SpkrToggle() is called when the speaker state is flipped by accessing $C030
-// - This brings audio up to date then calls ResetDCFilter()
+// - This records the toggle, and ResetDCFilter() is called when its step is output
 // - ResetDCFilter() sets a counter to a high value
 // - every audio sample is processed by DCFilter() as follows:
 //   - if the counter is >= 32768, the speaker has been recently toggled
@@ -147,6 +145,13 @@ static void DisplayBenchmarkResults ()
 
 static UINT g_uDCFilterState = 0;
 
+// Samples are rendered in batches (see UpdateSpkr()), so the toggles' ResetDCFilter() is deferred to the sample where each step is output.
+// Only the first & last toggle of a batch matter, since toggles within a batch are always < 10000 samples apart.
+// (Sample indices are absolute: see SpkrBLEP_GetSampleCount())
+static const unsigned __int64 DCFILTER_NO_RESET = (unsigned __int64)-1;
+static unsigned __int64 g_uDCFilterResetFirst = DCFILTER_NO_RESET;
+static unsigned __int64 g_uDCFilterResetLast = DCFILTER_NO_RESET;
+
 inline void ResetDCFilter(void)
 {
 	// reset the attenuator with an additional 250ms of full gain
@@ -182,20 +187,13 @@ static void SetClksPerSpkrSample()
 
 //=============================================================================
 
-static void InitRemainderBuffer()
+static void InitBLEP()
 {
-	delete [] g_pRemainderBuffer;
-
 	SetClksPerSpkrSample();
+	SpkrBLEP_Reset(g_nCumulativeCycles, g_fClksPerSpkrSample, g_nSpeakerData);
 
-	g_nRemainderBufferSize = (UINT) g_fClksPerSpkrSample;
-	if ((double)g_nRemainderBufferSize < g_fClksPerSpkrSample)
-		g_nRemainderBufferSize++;
-
-	g_pRemainderBuffer = new short [g_nRemainderBufferSize];
-	memset(g_pRemainderBuffer, 0, g_nRemainderBufferSize);
-
-	g_nRemainderBufferIdx = 0;
+	g_nSpkrLastToggleCycle = g_nCumulativeCycles;
+	g_uDCFilterResetFirst = g_uDCFilterResetLast = DCFILTER_NO_RESET;
 }
 
 //
@@ -213,10 +211,7 @@ void SpkrDestroy ()
 	if(soundtype == SOUND_WAVE)
 	{
 		delete [] g_pSpeakerBuffer;
-		delete [] g_pRemainderBuffer;
-		
 		g_pSpeakerBuffer = NULL;
-		g_pRemainderBuffer = NULL;
 	}
 }
 
@@ -248,9 +243,12 @@ void SpkrInitialize ()
 
 	if (soundtype == SOUND_WAVE)
 	{
-		InitRemainderBuffer();
+		InitBLEP();
 
 		g_pSpeakerBuffer = new short [SPKR_SAMPLE_RATE];	// Buffer can hold a max of 1 seconds worth of samples
+
+		if (!g_bSpkrAvailable)
+			AudioThread_SetVoice(AUDIO_SINK_SPEAKER, NULL, g_dwDSSpkrBufferSize, SPKR_SAMPLE_RATE, g_nSPKR_NumChannels);	// Null sink
 	}
 }
 
@@ -261,7 +259,7 @@ void SpkrReinitialize ()
 {
 	if (soundtype == SOUND_WAVE)
 	{
-		InitRemainderBuffer();
+		InitBLEP();
 	}
 }
 
@@ -273,8 +271,8 @@ void SpkrReset()
 	g_nSpkrQuietCycleCount = 0;
 	g_bSpkrToggleFlag = false;
 
-	InitRemainderBuffer();
-	Spkr_SubmitWaveBuffer(NULL, 0);
+	InitBLEP();
+	AudioThread_Flush(AUDIO_SINK_SPEAKER);
 	Spkr_SetActive(false);
 	Spkr_Demute();
 }
@@ -311,58 +309,49 @@ BOOL SpkrSetEmulationType (HWND window, SoundType_e newtype)
 
 //=============================================================================
 
-static void ReinitRemainderBuffer(UINT nCyclesRemaining)
+// Add a step for any level change not made by SpkrToggle() (ie. SAM's DAC writes g_nSpeakerData directly)
+static void SyncSpkrLevel()
 {
-	if(nCyclesRemaining == 0)
-		return;
-
-	for(g_nRemainderBufferIdx=0; g_nRemainderBufferIdx<nCyclesRemaining; g_nRemainderBufferIdx++)
-		g_pRemainderBuffer[g_nRemainderBufferIdx] = g_nSpeakerData;
-
-	_ASSERT(g_nRemainderBufferIdx < g_nRemainderBufferSize);
+	if (g_nSpeakerData != SpkrBLEP_GetLevel())
+		SpkrBLEP_AddStep(g_nSpkrLastToggleCycle, g_nSpeakerData);
 }
 
-static void UpdateRemainderBuffer(ULONG* pnCycleDiff)
+static void ApplyDCFilter(short* pBuffer, const UINT nNumSamples, const unsigned __int64 uFirstSample)
 {
-	if(g_nRemainderBufferIdx)
+	for (UINT i=0; i<nNumSamples; i++)
 	{
-		while((g_nRemainderBufferIdx < g_nRemainderBufferSize) && *pnCycleDiff)
-		{
-			g_pRemainderBuffer[g_nRemainderBufferIdx] = g_nSpeakerData;
-			g_nRemainderBufferIdx++;
-			(*pnCycleDiff)--;
-		}
+		if (uFirstSample+i == g_uDCFilterResetFirst || uFirstSample+i == g_uDCFilterResetLast)
+			ResetDCFilter();
 
-		if(g_nRemainderBufferIdx == g_nRemainderBufferSize)
-		{
-			g_nRemainderBufferIdx = 0;
-			signed long nSampleMean = 0;
-			for(UINT i=0; i<g_nRemainderBufferSize; i++)
-				nSampleMean += (signed long) g_pRemainderBuffer[i];
-			nSampleMean /= (signed long) g_nRemainderBufferSize;
-
-			if(g_nBufferIdx < SPKR_SAMPLE_RATE-1)
-				g_pSpeakerBuffer[g_nBufferIdx++] = DCFilter( (short)nSampleMean );
-		}
+		pBuffer[i] = DCFilter(pBuffer[i]);
 	}
+
+	// Keep any resets that are beyond this batch for the next
+	const unsigned __int64 uNextSample = SpkrBLEP_GetSampleCount();
+	if (g_uDCFilterResetLast == DCFILTER_NO_RESET || g_uDCFilterResetLast < uNextSample)
+		g_uDCFilterResetFirst = g_uDCFilterResetLast = DCFILTER_NO_RESET;
+	else if (g_uDCFilterResetFirst < uNextSample)
+		g_uDCFilterResetFirst = g_uDCFilterResetLast;
 }
 
 static void UpdateSpkr()
 {
   if(!g_bFullSpeed || SoundCore_GetTimerState())
   {
-	  ULONG nCycleDiff = (ULONG) (g_nCumulativeCycles - g_nSpkrLastCycle);
-
-	  UpdateRemainderBuffer(&nCycleDiff);
-
-	  ULONG nNumSamples = (ULONG) ((double)nCycleDiff / g_fClksPerSpkrSample);
-
-	  ULONG nCyclesRemaining = (ULONG) ((double)nCycleDiff - (double)nNumSamples * g_fClksPerSpkrSample);
+	  SyncSpkrLevel();
 
-	  while((nNumSamples--) && (g_nBufferIdx < SPKR_SAMPLE_RATE-1))
-		g_pSpeakerBuffer[g_nBufferIdx++] = DCFilter(g_nSpeakerData);
+	  const UINT nMaxSamples = (g_nBufferIdx < SPKR_SAMPLE_RATE-1) ? (SPKR_SAMPLE_RATE-1) - g_nBufferIdx : 0;
+	  const unsigned __int64 uFirstSample = SpkrBLEP_GetSampleCount();
+	  const UINT nNumSamples = SpkrBLEP_Render(&g_pSpeakerBuffer[g_nBufferIdx], nMaxSamples, g_nCumulativeCycles);
 
-	  ReinitRemainderBuffer(nCyclesRemaining);	// Partially fill 1Mhz sample buffer
+	  ApplyDCFilter(&g_pSpeakerBuffer[g_nBufferIdx], nNumSamples, uFirstSample);
+	  g_nBufferIdx += nNumSamples;
+  }
+  else
+  {
+	  // Not generating sound: discard any pending steps
+	  SpkrBLEP_Reset(g_nCumulativeCycles, g_fClksPerSpkrSample, g_nSpeakerData);
+	  g_uDCFilterResetFirst = g_uDCFilterResetLast = DCFILTER_NO_RESET;
   }
 
   g_nSpkrLastCycle = g_nCumulativeCycles;
@@ -393,18 +382,28 @@ BYTE __stdcall SpkrToggle (WORD, WORD, BYTE, BYTE, ULONG nExecutedCycles)
   {
 	  CpuCalcCycles(nExecutedCycles);
 
-	  UpdateSpkr();
+	  SyncSpkrLevel();
 
       short speakerDriveLevel = SPKR_DATA_INIT;
       if (g_bQuieterSpeaker)	// quieten the speaker if 8 bit DAC in use
         speakerDriveLevel /= 4;	// NB. Don't shift -ve number right: undefined behaviour (MSDN says: implementation-dependent)
 
-      ResetDCFilter();
+      const short newSpeakerData = (g_nSpeakerData == speakerDriveLevel) ? ~speakerDriveLevel : speakerDriveLevel;
+
+	  // Just record the toggle as a band-limited step: samples are rendered in one pass by UpdateSpkr()
+	  if (!SpkrBLEP_AddStep(g_nCumulativeCycles, newSpeakerData))
+	  {
+		  UpdateSpkr();	// too far ahead of the last render
+		  SpkrBLEP_AddStep(g_nCumulativeCycles, newSpeakerData);
+	  }
+
+	  // ResetDCFilter() when this step is output
+	  g_uDCFilterResetLast = SpkrBLEP_GetStepSample(g_nCumulativeCycles);
+	  if (g_uDCFilterResetFirst == DCFILTER_NO_RESET)
+		  g_uDCFilterResetFirst = g_uDCFilterResetLast;
 
-      if (g_nSpeakerData == speakerDriveLevel)
-        g_nSpeakerData = ~speakerDriveLevel;
-      else
-        g_nSpeakerData = speakerDriveLevel;
+	  g_nSpeakerData = newSpeakerData;
+	  g_nSpkrLastToggleCycle = g_nCumulativeCycles;
   }
 
   return MemReadFloatingBus(nExecutedCycles);
@@ -441,10 +440,7 @@ void SpkrUpdate (DWORD totalcycles)
 	  UpdateSpkr();
 	  ULONG nSamplesUsed;
 
-	  if(g_bFullSpeed)
-		  nSamplesUsed = Spkr_SubmitWaveBuffer_FullSpeed(g_pSpeakerBuffer, g_nBufferIdx);
-	  else
-		  nSamplesUsed = Spkr_SubmitWaveBuffer(g_pSpeakerBuffer, g_nBufferIdx);
+	  nSamplesUsed = g_pHostAudioSink->SubmitSpeakerSamples(g_pSpeakerBuffer, g_nBufferIdx, g_bFullSpeed);
 
 	  _ASSERT(nSamplesUsed <= g_nBufferIdx);
 	  memmove(g_pSpeakerBuffer, &g_pSpeakerBuffer[nSamplesUsed], g_nBufferIdx-nSamplesUsed);	// FIXME-TC: _Size * 2
@@ -460,7 +456,7 @@ void SpkrUpdate_Timer()
 		UpdateSpkr();
 		ULONG nSamplesUsed;
 
-		nSamplesUsed = Spkr_SubmitWaveBuffer_FullSpeed(g_pSpeakerBuffer, g_nBufferIdx);
+		nSamplesUsed = g_pHostAudioSink->SubmitSpeakerSamples(g_pSpeakerBuffer, g_nBufferIdx, true);
 
 		_ASSERT(nSamplesUsed <=	g_nBufferIdx);
 		memmove(g_pSpeakerBuffer, &g_pSpeakerBuffer[nSamplesUsed], g_nBufferIdx-nSamplesUsed);	// FIXME-TC: _Size * 2 (GH#213?)
@@ -468,340 +464,19 @@ void SpkrUpdate_Timer()
 	}
 }
 
-//=============================================================================
-
-static DWORD dwByteOffset = (DWORD)-1;
-static int nNumSamplesError = 0;
-static int nDbgSpkrCnt = 0;
-
-// FullSpeed g_nAppMode, 2 cases:
-// i) Short burst of full-speed, so PlayCursor doesn't complete sound from previous fixed-speed session.
-// ii) Long burst of full-speed, so PlayCursor completes sound from previous fixed-speed session.
-
-// Try to:
-// 1) Output remaining samples from SpeakerBuffer (from previous fixed-speed session)
-// 2) Output pad samples to keep the VoiceBuffer topped-up
-
-// If nNumSamples>0 then these are from previous fixed-speed session.
-// - Output these before outputting zero-pad samples.
-
-static ULONG Spkr_SubmitWaveBuffer_FullSpeed(short* pSpeakerBuffer, ULONG nNumSamples)
+// Called by the Win32 host audio sink
+// . the samples are only queued: the audio thread writes them to DirectSound (and pads any underrun, eg. in full-speed mode)
+ULONG Spkr_SubmitWaveBufferDS(short* pSpeakerBuffer, ULONG nNumSamples, bool bFullSpeed)
 {
-	//char szDbg[200];
-	nDbgSpkrCnt++;
-
-	if(!SpeakerVoice.bActive)
-		return nNumSamples;
-
-	// pSpeakerBuffer can't be NULL, as reset clears g_bFullSpeed, so 1st SpkrUpdate() never calls here
-	_ASSERT(pSpeakerBuffer != NULL);
-
-	//
-
-	DWORD dwDSLockedBufferSize0, dwDSLockedBufferSize1;
-	SHORT *pDSLockedBuffer0, *pDSLockedBuffer1;
-	//bool bBufferError = false;
-
-	DWORD dwCurrentPlayCursor, dwCurrentWriteCursor;
-	HRESULT hr = SpeakerVoice.lpDSBvoice->GetCurrentPosition(&dwCurrentPlayCursor, &dwCurrentWriteCursor);
-	if(FAILED(hr))
-		return nNumSamples;
-
-	if(dwByteOffset == (DWORD)-1)
+	if (!bFullSpeed)
 	{
-		// First time in this func (probably after re-init (Spkr_SubmitWaveBuffer()))
-
-		dwByteOffset = dwCurrentPlayCursor + (g_dwDSSpkrBufferSize/8)*3;	// Ideal: 0.375 is between 0.25 & 0.50 full
-		dwByteOffset %= g_dwDSSpkrBufferSize;
-		//sprintf(szDbg, "[Submit_FS] PC=%08X, WC=%08X, Diff=%08X, Off=%08X, NS=%08X [REINIT]\n", dwCurrentPlayCursor, dwCurrentWriteCursor, dwCurrentWriteCursor-dwCurrentPlayCursor, dwByteOffset, nNumSamples); OutputDebugString(szDbg);
-	}
-	else
-	{
-		// Check that our offset isn't between Play & Write positions
-
-		if(dwCurrentWriteCursor > dwCurrentPlayCursor)
-		{
-			// |-----PxxxxxW-----|
-			if((dwByteOffset > dwCurrentPlayCursor) && (dwByteOffset < dwCurrentWriteCursor))
-			{
-				//sprintf(szDbg, "[Submit_FS] PC=%08X, WC=%08X, Diff=%08X, Off=%08X, NS=%08X xxx\n", dwCurrentPlayCursor, dwCurrentWriteCursor, dwCurrentWriteCursor-dwCurrentPlayCursor, dwByteOffset, nNumSamples); OutputDebugString(szDbg);
-				dwByteOffset = dwCurrentWriteCursor;
-			}
-		}
-		else
-		{
-			// |xxW----------Pxxx|
-			if((dwByteOffset > dwCurrentPlayCursor) || (dwByteOffset < dwCurrentWriteCursor))
-			{
-				//sprintf(szDbg, "[Submit_FS] PC=%08X, WC=%08X, Diff=%08X, Off=%08X, NS=%08X XXX\n", dwCurrentPlayCursor, dwCurrentWriteCursor, dwCurrentWriteCursor-dwCurrentPlayCursor, dwByteOffset, nNumSamples); OutputDebugString(szDbg);
-				dwByteOffset = dwCurrentWriteCursor;
-			}
-		}
+		const int nNumSamplesError = AudioThread_GetSamplesError(AUDIO_SINK_SPEAKER);
+		g_nCpuCyclesFeedback = (int) ((double)nNumSamplesError * g_fClksPerSpkrSample);
 	}
 
-	// Calc bytes remaining to be played
-	int nBytesRemaining = dwByteOffset - dwCurrentPlayCursor;
-	if(nBytesRemaining < 0)
-		nBytesRemaining += g_dwDSSpkrBufferSize;
-	if((nBytesRemaining == 0) && (dwCurrentPlayCursor != dwCurrentWriteCursor))
-		nBytesRemaining = g_dwDSSpkrBufferSize;		// Case when complete buffer is to be played
-
-	//
-
-	UINT nNumPadSamples = 0;
-
-	if(nBytesRemaining < g_dwDSSpkrBufferSize / 4)
-	{
-		// < 1/4 of play-buffer remaining (need *more* data)
-		nNumPadSamples = ((g_dwDSSpkrBufferSize / 4) - nBytesRemaining) / sizeof(short);
-
-		if(nNumPadSamples > nNumSamples)
-			nNumPadSamples -= nNumSamples;
-		else
-			nNumPadSamples = 0;
-
-		// NB. If nNumPadSamples>0 then all nNumSamples are to be used
-	}
-
-	//
-
-	UINT nBytesFree = g_dwDSSpkrBufferSize - nBytesRemaining;	// Calc free buffer space
-	ULONG nNumSamplesToUse = nNumSamples + nNumPadSamples;
-
-	if(nNumSamplesToUse * sizeof(short) > nBytesFree)
-		nNumSamplesToUse = nBytesFree / sizeof(short);
-
-	//
-
-	if(nNumSamplesToUse >= 128)	// Limit the buffer unlock/locking to a minimum
-	{
-		if(!DSGetLock(SpeakerVoice.lpDSBvoice,
-							dwByteOffset, (DWORD)nNumSamplesToUse*sizeof(short),
-							&pDSLockedBuffer0, &dwDSLockedBufferSize0,
-							&pDSLockedBuffer1, &dwDSLockedBufferSize1))
-			return nNumSamples;
-
-		//
-
-		DWORD dwBufferSize0 = 0;
-		DWORD dwBufferSize1 = 0;
-
-		if(nNumSamples)
-		{
-			//sprintf(szDbg, "[Submit_FS] C=%08X, PC=%08X, WC=%08X, Diff=%08X, Off=%08X, NS=%08X ***\n", nDbgSpkrCnt, dwCurrentPlayCursor, dwCurrentWriteCursor, dwCurrentWriteCursor-dwCurrentPlayCursor, dwByteOffset, nNumSamples); OutputDebugString(szDbg);
-
-			if(nNumSamples*sizeof(short) <= dwDSLockedBufferSize0)
-			{
-				dwBufferSize0 = nNumSamples*sizeof(short);
-				dwBufferSize1 = 0;
-			}
-			else
-			{
-				dwBufferSize0 = dwDSLockedBufferSize0;
-				dwBufferSize1 = nNumSamples*sizeof(short) - dwDSLockedBufferSize0;
-
-				if(dwBufferSize1 > dwDSLockedBufferSize1)
-					dwBufferSize1 = dwDSLockedBufferSize1;
-			}
-			
-			memcpy(pDSLockedBuffer0, &pSpeakerBuffer[0], dwBufferSize0);
-#ifdef RIFF_SPKR
-			RiffPutSamples(pDSLockedBuffer0, dwBufferSize0/sizeof(short));
-#endif
-			nNumSamples = dwBufferSize0/sizeof(short);
-
-			if(pDSLockedBuffer1 && dwBufferSize1)
-			{
-				memcpy(pDSLockedBuffer1, &pSpeakerBuffer[dwDSLockedBufferSize0/sizeof(short)], dwBufferSize1);
-#ifdef RIFF_SPKR
-				RiffPutSamples(pDSLockedBuffer1, dwBufferSize1/sizeof(short));
-#endif
-				nNumSamples += dwBufferSize1/sizeof(short);
-			}
-		}
-
-		if(nNumPadSamples)
-		{
-			//sprintf(szDbg, "[Submit_FS] C=%08X, PC=%08X, WC=%08X, Diff=%08X, Off=%08X, PS=%08X, Data=%04X\n", nDbgSpkrCnt, dwCurrentPlayCursor, dwCurrentWriteCursor, dwCurrentWriteCursor-dwCurrentPlayCursor, dwByteOffset, nNumPadSamples, g_nSpeakerData); OutputDebugString(szDbg);
-
-			dwBufferSize0 = dwDSLockedBufferSize0 - dwBufferSize0;
-			dwBufferSize1 = dwDSLockedBufferSize1 - dwBufferSize1;
-
-			if(dwBufferSize0)
-			{
-				wmemset((wchar_t*)pDSLockedBuffer0, (wchar_t)DCFilter(g_nSpeakerData), dwBufferSize0/sizeof(wchar_t));
-#ifdef RIFF_SPKR
-				RiffPutSamples(pDSLockedBuffer0, dwBufferSize0/sizeof(short));
-#endif
-			}
-
-			if(pDSLockedBuffer1)
-			{
-				wmemset((wchar_t*)pDSLockedBuffer1, (wchar_t)DCFilter(g_nSpeakerData), dwBufferSize1/sizeof(wchar_t));
-#ifdef RIFF_SPKR
-				RiffPutSamples(pDSLockedBuffer1, dwBufferSize1/sizeof(short));
-#endif
-			}
-		}
-
-		// Commit sound buffer
-		hr = SpeakerVoice.lpDSBvoice->Unlock((void*)pDSLockedBuffer0, dwDSLockedBufferSize0,
-											(void*)pDSLockedBuffer1, dwDSLockedBufferSize1);
-		if(FAILED(hr))
-			return nNumSamples;
-
-		dwByteOffset = (dwByteOffset + (DWORD)nNumSamplesToUse*sizeof(short)*g_nSPKR_NumChannels) % g_dwDSSpkrBufferSize;
-	}
-
-	return nNumSamples;
+	return AudioThread_Push(AUDIO_SINK_SPEAKER, pSpeakerBuffer, nNumSamples);
 }
 
-//-----------------------------------------------------------------------------
-
-static ULONG Spkr_SubmitWaveBuffer(short* pSpeakerBuffer, ULONG nNumSamples)
-{
-	//char szDbg[200];
-	nDbgSpkrCnt++;
-
-	if(!SpeakerVoice.bActive)
-		return nNumSamples;
-
-	if(pSpeakerBuffer == NULL)
-	{
-		// Re-init from SpkrReset()
-		dwByteOffset = (DWORD)-1;
-		nNumSamplesError = 0;
-
-		// Don't call DSZeroVoiceBuffer() - get noise with "VIA AC'97 Enhanced Audio Controller"
-		// . I guess SpeakerVoice.Stop() isn't really working and the new zero buffer causes noise corruption when submitted.
-		DSZeroVoiceWritableBuffer(&SpeakerVoice, "Spkr", g_dwDSSpkrBufferSize);
-
-		return 0;
-	}
-
-	//
-
-	DWORD dwDSLockedBufferSize0, dwDSLockedBufferSize1;
-	SHORT *pDSLockedBuffer0, *pDSLockedBuffer1;
-	bool bBufferError = false;
-
-	DWORD dwCurrentPlayCursor, dwCurrentWriteCursor;
-	HRESULT hr = SpeakerVoice.lpDSBvoice->GetCurrentPosition(&dwCurrentPlayCursor, &dwCurrentWriteCursor);
-	if(FAILED(hr))
-		return nNumSamples;
-
-	if(dwByteOffset == (DWORD)-1)
-	{
-		// First time in this func (probably after re-init (above))
-
-		dwByteOffset = dwCurrentPlayCursor + (g_dwDSSpkrBufferSize/8)*3;	// Ideal: 0.375 is between 0.25 & 0.50 full
-		dwByteOffset %= g_dwDSSpkrBufferSize;
-		//sprintf(szDbg, "[Submit]   PC=%08X, WC=%08X, Diff=%08X, Off=%08X [REINIT]\n", dwCurrentPlayCursor, dwCurrentWriteCursor, dwCurrentWriteCursor-dwCurrentPlayCursor, dwByteOffset); OutputDebugString(szDbg);
-	}
-	else
-	{
-		// Check that our offset isn't between Play & Write positions
-
-		if(dwCurrentWriteCursor > dwCurrentPlayCursor)
-		{
-			// |-----PxxxxxW-----|
-			if((dwByteOffset > dwCurrentPlayCursor) && (dwByteOffset < dwCurrentWriteCursor))
-			{
-				double fTicksSecs = (double)GetTickCount() / 1000.0;
-				//sprintf(szDbg, "%010.3f: [Submit]    PC=%08X, WC=%08X, Diff=%08X, Off=%08X, NS=%08X xxx\n", fTicksSecs, dwCurrentPlayCursor, dwCurrentWriteCursor, dwCurrentWriteCursor-dwCurrentPlayCursor, dwByteOffset, nNumSamples);
-				//OutputDebugString(szDbg);
-				//if (g_fh) fprintf(g_fh, szDbg);
-
-				dwByteOffset = dwCurrentWriteCursor;
-				nNumSamplesError = 0;
-				bBufferError = true;
-			}
-		}
-		else
-		{
-			// |xxW----------Pxxx|
-			if((dwByteOffset > dwCurrentPlayCursor) || (dwByteOffset < dwCurrentWriteCursor))
-			{
-				double fTicksSecs = (double)GetTickCount() / 1000.0;
-				//sprintf(szDbg, "%010.3f: [Submit]    PC=%08X, WC=%08X, Diff=%08X, Off=%08X, NS=%08X XXX\n", fTicksSecs, dwCurrentPlayCursor, dwCurrentWriteCursor, dwCurrentWriteCursor-dwCurrentPlayCursor, dwByteOffset, nNumSamples);
-				//OutputDebugString(szDbg);
-				//if (g_fh) fprintf(g_fh, "%s", szDbg);
-
-				dwByteOffset = dwCurrentWriteCursor;
-				nNumSamplesError = 0;
-				bBufferError = true;
-			}
-		}
-	}
-
-	// Calc bytes remaining to be played
-	int nBytesRemaining = dwByteOffset - dwCurrentPlayCursor;
-	if(nBytesRemaining < 0)
-		nBytesRemaining += g_dwDSSpkrBufferSize;
-	if((nBytesRemaining == 0) && (dwCurrentPlayCursor != dwCurrentWriteCursor))
-		nBytesRemaining = g_dwDSSpkrBufferSize;		// Case when complete buffer is to be played
-
-	// Calc correction factor so that play-buffer doesn't under/overflow
-	const int nErrorInc = SoundCore_GetErrorInc();
-	if(nBytesRemaining < g_dwDSSpkrBufferSize / 4)
-		nNumSamplesError += nErrorInc;				// < 1/4 of play-buffer remaining (need *more* data)
-	else if(nBytesRemaining > g_dwDSSpkrBufferSize / 2)
-		nNumSamplesError -= nErrorInc;				// > 1/2 of play-buffer remaining (need *less* data)
-	else
-		nNumSamplesError = 0;						// Acceptable amount of data in buffer
-
-	const int nErrorMax = SoundCore_GetErrorMax();				// Cap feedback to +/-nMaxError units
-	if(nNumSamplesError < -nErrorMax) nNumSamplesError = -nErrorMax;
-	if(nNumSamplesError >  nErrorMax) nNumSamplesError =  nErrorMax;
-	g_nCpuCyclesFeedback = (int) ((double)nNumSamplesError * g_fClksPerSpkrSample);
-
-	//
-
-	UINT nBytesFree = g_dwDSSpkrBufferSize - nBytesRemaining;	// Calc free buffer space
-	ULONG nNumSamplesToUse = nNumSamples;
-
-	if(nNumSamplesToUse * sizeof(short) > nBytesFree)
-		nNumSamplesToUse = nBytesFree / sizeof(short);
-
-	if(bBufferError)
-		pSpeakerBuffer = &pSpeakerBuffer[nNumSamples - nNumSamplesToUse];
-
-	//
-
-	if(nNumSamplesToUse)
-	{
-		//sprintf(szDbg, "[Submit]    C=%08X, PC=%08X, WC=%08X, Diff=%08X, Off=%08X, NS=%08X +++\n", nDbgSpkrCnt, dwCurrentPlayCursor, dwCurrentWriteCursor, dwCurrentWriteCursor-dwCurrentPlayCursor, dwByteOffset, nNumSamplesToUse); OutputDebugString(szDbg);
-
-		if(!DSGetLock(SpeakerVoice.lpDSBvoice,
-							dwByteOffset, (DWORD)nNumSamplesToUse*sizeof(short),
-							&pDSLockedBuffer0, &dwDSLockedBufferSize0,
-							&pDSLockedBuffer1, &dwDSLockedBufferSize1))
-			return nNumSamples;
-
-		memcpy(pDSLockedBuffer0, &pSpeakerBuffer[0], dwDSLockedBufferSize0);
-#ifdef RIFF_SPKR
-		RiffPutSamples(pDSLockedBuffer0, dwDSLockedBufferSize0/sizeof(short));
-#endif
-
-		if(pDSLockedBuffer1)
-		{
-			memcpy(pDSLockedBuffer1, &pSpeakerBuffer[dwDSLockedBufferSize0/sizeof(short)], dwDSLockedBufferSize1);
-#ifdef RIFF_SPKR
-			RiffPutSamples(pDSLockedBuffer1, dwDSLockedBufferSize1/sizeof(short));
-#endif
-		}
-
-		// Commit sound buffer
-		hr = SpeakerVoice.lpDSBvoice->Unlock((void*)pDSLockedBuffer0, dwDSLockedBufferSize0,
-											(void*)pDSLockedBuffer1, dwDSLockedBufferSize1);
-		if(FAILED(hr))
-			return nNumSamples;
-
-		dwByteOffset = (dwByteOffset + (DWORD)nNumSamplesToUse*sizeof(short)*g_nSPKR_NumChannels) % g_dwDSSpkrBufferSize;
-	}
-
-	return bBufferError ? nNumSamples : nNumSamplesToUse;
-}
 
 //-----------------------------------------------------------------------------
 
@@ -915,11 +590,15 @@ bool Spkr_DSInit()
 		sprintf(szDbg, "[DSInit] PC=%08X, WC=%08X, Diff=%08X\n", dwCurrentPlayCursor, dwCurrentWriteCursor, dwCurrentWriteCursor-dwCurrentPlayCursor); OutputDebugString(szDbg);
 	}
 
+	AudioThread_SetVoice(AUDIO_SINK_SPEAKER, &SpeakerVoice, g_dwDSSpkrBufferSize, SPKR_SAMPLE_RATE, g_nSPKR_NumChannels);
+
 	return true;
 }
 
 void Spkr_DSUninit()
 {
+	AudioThread_RemoveVoice(AUDIO_SINK_SPEAKER);
+
 	if(SpeakerVoice.lpDSBvoice && SpeakerVoice.bActive)
 	{
 		SpeakerVoice.lpDSBvoice->Stop();
@@ -934,6 +613,7 @@ void Spkr_DSUninit()
 void SpkrSetSnapshot_v1(const unsigned __int64 SpkrLastCycle)
 {
 	g_nSpkrLastCycle = SpkrLastCycle;
+	SpkrBLEP_Reset(g_nSpkrLastCycle, g_fClksPerSpkrSample, g_nSpeakerData);
 }
 
 //
@@ -958,6 +638,7 @@ void SpkrLoadSnapshot(YamlLoadHelper& yamlLoadHelper)
 		return;
 
 	g_nSpkrLastCycle = yamlLoadHelper.LoadUint64(SS_YAML_KEY_LASTCYCLE);
+	SpkrBLEP_Reset(g_nSpkrLastCycle, g_fClksPerSpkrSample, g_nSpeakerData);
 
 	yamlLoadHelper.PopMap();
 }
@@ -33,6 +33,7 @@ void    Spkr_Demute();
 bool    Spkr_IsActive();
 bool    Spkr_DSInit();
 void    Spkr_DSUninit();
+ULONG   Spkr_SubmitWaveBufferDS(short* pSpeakerBuffer, ULONG nNumSamples, bool bFullSpeed);
 void    SpkrSetSnapshot_v1(const unsigned __int64 SpkrLastCycle);
 void    SpkrSaveSnapshot(class YamlSaveHelper& yamlSaveHelper);
 void    SpkrLoadSnapshot(class YamlLoadHelper& yamlLoadHelper);
@@ -0,0 +1,237 @@
+/*
+AppleWin : An Apple //e emulator for Windows
+
+Copyright (C) 1994-1996, Michael O'Brien
+Copyright (C) 1999-2001, Oliver Schmidt
+Copyright (C) 2002-2005, Tom Charlesworth
+Copyright (C) 2006-2019, Tom Charlesworth, Michael Pohoreski, Nick Westgate
+
+AppleWin is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+AppleWin is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with AppleWin; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+*/
+
+/* Description: Band-limited step synthesis for the speaker
+ *
+ * The speaker (and SAM's DAC) output is a sequence of level changes at 6502 cycle resolution.
+ * Rather than averaging a 1MHz buffer down to 44.1KHz (which aliases, and costs per cycle),
+ * each level change adds a pre-computed band-limited step to a delta buffer.
+ * Rendering then just integrates the delta buffer, once per SpkrUpdate().
+ *
+ * . the step kernel is a Blackman-windowed sinc (cut-off 0.45*fs), integrated, over kTaps samples
+ *   and tabulated at kPhases sub-sample positions
+ * . each step is centred kTaps/2 samples after its position, so the output is delayed by ~0.2ms
+ */
+
+#include "StdAfx.h"
+
+#include "SpeakerBLEP.h"
+
+static const UINT kTaps = 16;
+static const UINT kPhases = 32;
+static const int kKernelBits = 14;					// each phase's taps sum to 1<<kKernelBits
+static const UINT kMaxPendingSamples = 4096;		// ~93ms @ 44.1KHz: steps can be added this far ahead of the last render
+
+// The accumulator is biased so that it stays positive (even with the kernel's overshoot), so can be shifted right
+static const int kAccumBias = 65536;
+
+static int g_aKernel[kPhases][kTaps];
+static bool g_bKernelInit = false;
+
+static int g_aDelta[kMaxPendingSamples + kTaps];
+static UINT g_uDeltaEnd = 0;						// g_aDelta[] is zero from here
+
+static int g_nAccum = 0;							// (level + kAccumBias) << kKernelBits
+static short g_nLevel = 0;							// level after the last step
+
+static unsigned __int64 g_uBaseCycle = 0;			// cycle of the 1st sample still to be rendered...
+static double g_fBaseFrac = 0.0;					// ...plus this fraction of a sample
+static double g_fClksPerSample = 1.0;
+
+static unsigned __int64 g_uSampleCount = 0;			// samples rendered (including any discarded)
+
+//===========================================================================
+
+static void InitKernel(void)
+{
+	const double kPi = 3.14159265358979323846;
+	const double fCutOff = 0.45;					// as a fraction of the sample rate
+	const UINT kSubSteps = 64;						// numerical integration steps per sample
+	const double fHalfWidth = kTaps / 2.0;
+
+	for (UINT p=0; p<kPhases; p++)
+	{
+		// Integrate the windowed sinc over each output sample period
+		// . for phase p the step is at (kTaps/2 + p/kPhases) samples
+		double fTap[kTaps];
+		double fSum = 0.0;
+
+		for (UINT k=0; k<kTaps; k++)
+		{
+			double fArea = 0.0;
+			for (UINT s=0; s<kSubSteps; s++)
+			{
+				const double t = (double)k - 1.0 + ((double)s + 0.5) / kSubSteps - fHalfWidth - (double)p / kPhases;
+				if (t <= -fHalfWidth || t >= fHalfWidth)
+					continue;
+
+				const double x = 2.0 * fCutOff * t;
+				const double fSinc = (x == 0.0) ? 1.0 : sin(kPi * x) / (kPi * x);
+				const double w = (t + fHalfWidth) / (2.0 * fHalfWidth);
+				const double fWindow = 0.42 - 0.5 * cos(2.0 * kPi * w) + 0.08 * cos(4.0 * kPi * w);
+				fArea += 2.0 * fCutOff * fSinc * fWindow / kSubSteps;
+			}
+			fTap[k] = fArea;
+			fSum += fArea;
+		}
+
+		// Quantise so the taps sum to exactly 1<<kKernelBits (so a step always settles at the new level)
+		int nSum = 0;
+		UINT uPeak = 0;
+		for (UINT k=0; k<kTaps; k++)
+		{
+			g_aKernel[p][k] = (int) floor(fTap[k] / fSum * (1 << kKernelBits) + 0.5);
+			nSum += g_aKernel[p][k];
+			if (g_aKernel[p][k] > g_aKernel[p][uPeak])
+				uPeak = k;
+		}
+		g_aKernel[p][uPeak] += (1 << kKernelBits) - nSum;
+	}
+
+	g_bKernelInit = true;
+}
+
+//===========================================================================
+
+// Discards any pending steps: the output restarts at uCycle, at nLevel
+void SpkrBLEP_Reset(const unsigned __int64 uCycle, const double fClksPerSample, const short nLevel)
+{
+	if (!g_bKernelInit)
+		InitKernel();
+
+	memset(g_aDelta, 0, sizeof(g_aDelta));
+	g_uDeltaEnd = 0;
+
+	g_nLevel = nLevel;
+	g_nAccum = ((int)nLevel + kAccumBias) << kKernelBits;
+
+	g_uBaseCycle = uCycle;
+	g_fBaseFrac = 0.0;
+	g_fClksPerSample = fClksPerSample;
+}
+
+// Position of uCycle, in samples from the next sample to be rendered
+static double GetSamplePos(const unsigned __int64 uCycle)
+{
+	const double fCycles = (uCycle > g_uBaseCycle) ? (double)(uCycle - g_uBaseCycle) : 0.0;
+	return g_fBaseFrac + fCycles / g_fClksPerSample;
+}
+
+// Returns false if uCycle is too far ahead of the last render (the caller should render, then retry)
+bool SpkrBLEP_AddStep(const unsigned __int64 uCycle, const short nLevel)
+{
+	const int nDelta = (int)nLevel - (int)g_nLevel;
+	if (nDelta == 0)
+		return true;
+
+	const double fPos = GetSamplePos(uCycle);
+	if (fPos >= (double)kMaxPendingSamples)
+		return false;
+
+	const UINT uIdx = (UINT) fPos;
+	const UINT uPhase = (UINT) ((fPos - (double)uIdx) * kPhases);
+
+	const int* pKernel = g_aKernel[uPhase];
+	int* pDelta = &g_aDelta[uIdx];
+	for (UINT k=0; k<kTaps; k++)
+		pDelta[k] += nDelta * pKernel[k];
+
+	if (g_uDeltaEnd < uIdx + kTaps)
+		g_uDeltaEnd = uIdx + kTaps;
+
+	g_nLevel = nLevel;
+	return true;
+}
+
+// The sample (see SpkrBLEP_GetSampleCount()) at which a step at uCycle is half-way
+unsigned __int64 SpkrBLEP_GetStepSample(const unsigned __int64 uCycle)
+{
+	return g_uSampleCount + (UINT) GetSamplePos(uCycle) + kTaps / 2;
+}
+
+// Index of the next sample to be rendered
+unsigned __int64 SpkrBLEP_GetSampleCount(void)
+{
+	return g_uSampleCount;
+}
+
+short SpkrBLEP_GetLevel(void)
+{
+	return g_nLevel;
+}
+
+static short AccumToSample(const int nAccum)
+{
+	int nSample = (nAccum >> kKernelBits) - kAccumBias;
+	if (nSample < -32768) nSample = -32768;
+	else if (nSample > 32767) nSample = 32767;
+	return (short) nSample;
+}
+
+// Render all whole samples up to uCycle, however far that is
+// . returns the number of samples written to pBuffer (any more than uMaxSamples are discarded, but still counted)
+// . only the first g_uDeltaEnd samples have pending steps: the rest of a long backlog just holds the last level
+UINT SpkrBLEP_Render(short* pBuffer, const UINT uMaxSamples, const unsigned __int64 uCycle)
+{
+	const double fEnd = GetSamplePos(uCycle);
+	const unsigned __int64 uNumSamples = (unsigned __int64) fEnd;
+
+	const UINT uNumToWrite = uNumSamples < uMaxSamples ? (UINT)uNumSamples : uMaxSamples;
+	const UINT uNumDeltas = uNumSamples < g_uDeltaEnd ? (UINT)uNumSamples : g_uDeltaEnd;
+
+	int nAccum = g_nAccum;
+	UINT i = 0;
+	for (; i<uNumToWrite && i<uNumDeltas; i++)
+	{
+		nAccum += g_aDelta[i];
+		pBuffer[i] = AccumToSample(nAccum);
+	}
+	if (i < uNumToWrite)
+	{
+		const short nSample = AccumToSample(nAccum);
+		for (; i<uNumToWrite; i++)
+			pBuffer[i] = nSample;
+	}
+	for (; i<uNumDeltas; i++)
+		nAccum += g_aDelta[i];
+	g_nAccum = nAccum;
+
+	// Shift the pending deltas down
+	if (g_uDeltaEnd > uNumSamples)
+	{
+		memmove(g_aDelta, &g_aDelta[uNumDeltas], (g_uDeltaEnd - uNumDeltas) * sizeof(g_aDelta[0]));
+		memset(&g_aDelta[g_uDeltaEnd - uNumDeltas], 0, uNumDeltas * sizeof(g_aDelta[0]));
+		g_uDeltaEnd -= uNumDeltas;
+	}
+	else
+	{
+		memset(g_aDelta, 0, g_uDeltaEnd * sizeof(g_aDelta[0]));
+		g_uDeltaEnd = 0;
+	}
+
+	g_uBaseCycle = uCycle;
+	g_fBaseFrac = fEnd - (double)uNumSamples;
+	g_uSampleCount += uNumSamples;
+
+	return uNumToWrite;
+}
@@ -0,0 +1,12 @@
+#pragma once
+
+// Band-limited step (BLEP) synthesis of the speaker's output
+// . each level change is added as a band-limited step at its (sub-sample) position
+// . samples are then produced in one pass, up to a given cycle
+
+void	SpkrBLEP_Reset(const unsigned __int64 uCycle, const double fClksPerSample, const short nLevel);
+bool	SpkrBLEP_AddStep(const unsigned __int64 uCycle, const short nLevel);
+unsigned __int64 SpkrBLEP_GetStepSample(const unsigned __int64 uCycle);
+unsigned __int64 SpkrBLEP_GetSampleCount(void);
+short	SpkrBLEP_GetLevel(void);
+UINT	SpkrBLEP_Render(short* pBuffer, const UINT uMaxSamples, const unsigned __int64 uCycle);
@@ -171,8 +171,11 @@ void VideoBenchmark () {
 
   // PREPARE TWO DIFFERENT FRAME BUFFERS, EACH OF WHICH HAVE HALF OF THE
   // BYTES SET TO 0x14 AND THE OTHER HALF SET TO 0xAA
+  // NB. Use main memory directly (not 'mem'), as that's what the video renderer reads
+  // . After ResetMachineState() all of main memory is paged in
+  LPBYTE  pMem  = MemGetMainPtr(0);
   int     loop;
-  LPDWORD mem32 = (LPDWORD)mem;
+  LPDWORD mem32 = (LPDWORD)pMem;
   for (loop = 4096; loop < 6144; loop++)
     *(mem32+loop) = ((loop & 1) ^ ((loop & 0x40) >> 6)) ? 0x14141414
                                                         : 0xAAAAAAAA;
@@ -186,7 +189,7 @@ void VideoBenchmark () {
   DWORD totaltextfps = 0;
 
   g_uVideoMode            = VF_TEXT;
-  FillMemory(mem+0x400,0x400,0x14);
+  FillMemory(pMem+0x400,0x400,0x14);
   VideoRedrawScreen();
   DWORD milliseconds = GetTickCount();
   while (GetTickCount() == milliseconds) ;
@@ -194,9 +197,9 @@ void VideoBenchmark () {
   DWORD cycle = 0;
   do {
     if (cycle & 1)
-      FillMemory(mem+0x400,0x400,0x14);
+      FillMemory(pMem+0x400,0x400,0x14);
     else
-      CopyMemory(mem+0x400,mem+((cycle & 2) ? 0x4000 : 0x6000),0x400);
+      CopyMemory(pMem+0x400,pMem+((cycle & 2) ? 0x4000 : 0x6000),0x400);
     VideoRefreshScreen();
     if (cycle++ >= 3)
       cycle = 0;
@@ -208,7 +211,7 @@ void VideoBenchmark () {
   // SIMULATE THE ACTIVITY OF AN AVERAGE GAME
   DWORD totalhiresfps = 0;
   g_uVideoMode             = VF_HIRES;
-  FillMemory(mem+0x2000,0x2000,0x14);
+  FillMemory(pMem+0x2000,0x2000,0x14);
   VideoRedrawScreen();
   milliseconds = GetTickCount();
   while (GetTickCount() == milliseconds) ;
@@ -216,9 +219,9 @@ void VideoBenchmark () {
   cycle = 0;
   do {
     if (cycle & 1)
-      FillMemory(mem+0x2000,0x2000,0x14);
+      FillMemory(pMem+0x2000,0x2000,0x14);
     else
-      CopyMemory(mem+0x2000,mem+((cycle & 2) ? 0x4000 : 0x6000),0x2000);
+      CopyMemory(pMem+0x2000,pMem+((cycle & 2) ? 0x4000 : 0x6000),0x2000);
     VideoRefreshScreen();
     if (cycle++ >= 3)
       cycle = 0;
@@ -292,7 +295,7 @@ void VideoBenchmark () {
   // WITH FULL EMULATION OF THE CPU, JOYSTICK, AND DISK HAPPENING AT
   // THE SAME TIME
   DWORD realisticfps = 0;
-  FillMemory(mem+0x2000,0x2000,0xAA);
+  FillMemory(pMem+0x2000,0x2000,0xAA);
   VideoRedrawScreen();
   milliseconds = GetTickCount();
   while (GetTickCount() == milliseconds) ;
@@ -309,28 +312,57 @@ void VideoBenchmark () {
 	  }
     }
     if (cycle & 1)
-      FillMemory(mem+0x2000,0x2000,0xAA);
+      FillMemory(pMem+0x2000,0x2000,0xAA);
     else
-      CopyMemory(mem+0x2000,mem+((cycle & 2) ? 0x4000 : 0x6000),0x2000);
+      CopyMemory(pMem+0x2000,pMem+((cycle & 2) ? 0x4000 : 0x6000),0x2000);
     VideoRedrawScreen();
     if (cycle++ >= 3)
       cycle = 0;
     realisticfps++;
   } while (GetTickCount() - milliseconds < 1000);
 
+  // SEE HOW MANY MEMORY PAGING SOFT-SWITCH FLIPS WE CAN DO PER SECOND
+  // . //e: PAGE2 with 80STORE & HIRES set, so that 36 pages get re-mapped on each flip
+  // . ][ : Language Card ROM/RAM read, so that 48 pages get re-mapped on each flip
+  // . PC=$C000 so that MemSetPaging() doesn't look for a following RAMRD/RAMWRT opcode
+  // . NB. Caller does ResetMachineState() afterwards, which will undo these paging & video mode changes
+  DWORD totalflips = 0;
+  {
+    const WORD addrOn  = IS_APPLE2 ? 0xC080 : 0xC055;
+    const WORD addrOff = IS_APPLE2 ? 0xC082 : 0xC054;
+    if (!IS_APPLE2)
+    {
+      MemSetPaging(0xC000, 0xC001, 1, 0, 0);	// 80STORE
+      MemSetPaging(0xC000, 0xC057, 0, 0, 0);	// HIRES
+    }
+    milliseconds = GetTickCount();
+    while (GetTickCount() == milliseconds) ;
+    milliseconds = GetTickCount();
+    do {
+      for (UINT i=0; i<100; i++)
+      {
+        MemSetPaging(0xC000, addrOn,  0, 0, 0);
+        MemSetPaging(0xC000, addrOff, 0, 0, 0);
+      }
+      totalflips += 200;
+    } while (GetTickCount() - milliseconds < 1000);
+  }
+
   // DISPLAY THE RESULTS
   VideoDisplayLogo();
   TCHAR outstr[256];
   wsprintf(outstr,
            TEXT("Pure Video FPS:\t%u hires, %u text\n")
            TEXT("Pure CPU MHz:\t%u.%u%s (video update)\n")
-           TEXT("Pure CPU MHz:\t%u.%u%s (full-speed)\n\n")
+           TEXT("Pure CPU MHz:\t%u.%u%s (full-speed)\n")
+           TEXT("Paging flips:\t%u per second\n\n")
            TEXT("EXPECTED AVERAGE VIDEO GAME\n")
            TEXT("PERFORMANCE: %u FPS"),
            (unsigned)totalhiresfps,
            (unsigned)totaltextfps,
            (unsigned)(totalmhz10[0] / 10), (unsigned)(totalmhz10[0] % 10), (LPCTSTR)(IS_APPLE2 ? TEXT(" (6502)") : TEXT("")),
            (unsigned)(totalmhz10[1] / 10), (unsigned)(totalmhz10[1] % 10), (LPCTSTR)(IS_APPLE2 ? TEXT(" (6502)") : TEXT("")),
+           (unsigned)totalflips,
            (unsigned)realisticfps);
   MessageBox(g_hFrameWindow,
              outstr,
@@ -477,12 +509,12 @@ void VideoDisplayLogo ()
 void VideoRedrawScreenDuringFullSpeed(DWORD dwCyclesThisFrame, bool bInit /*=false*/)
 {
 	static DWORD dwFullSpeedStartTime = 0;
-//	static bool bValid = false;
+	static bool bValid = false;
 
 	if (bInit)
 	{
 		// Just entered full-speed mode
-//		bValid = false;
+		bValid = false;
 		dwFullSpeedStartTime = GetTickCount();
 		return;
 	}
@@ -493,54 +525,16 @@ void VideoRedrawScreenDuringFullSpeed(DWORD dwCyclesThisFrame, bool bInit /*=fal
 
 	dwFullSpeedStartTime += dwFullSpeedDuration;
 
-	//
-
-#if 0
-	static BYTE text_main[1024*2] = {0};	// page1 & 2
-	static BYTE text_aux[1024*2] = {0};		// page1 & 2
-	static BYTE hgr_main[8192*2] = {0};		// page1 & 2
-	static BYTE hgr_aux[8192*2] = {0};		// page1 & 2
-
-	bool bRedraw = true;	// Always redraw for bValid==false (ie. just entered full-speed mode)
-
-	if (bValid)
-	{
-		if ((g_uVideoMode&(VF_DHIRES|VF_HIRES|VF_TEXT|VF_MIXED)) == VF_HIRES)
-		{
-			// HIRES (not MIXED) - eg. AZTEC.DSK
-			if ((g_uVideoMode&VF_PAGE2) == 0)
-				bRedraw = memcmp(&hgr_main[0x0000],  MemGetMainPtr(0x2000), 8192) != 0;
-			else
-				bRedraw = memcmp(&hgr_main[0x2000],  MemGetMainPtr(0x4000), 8192) != 0;
-		}
-		else
-		{
-			bRedraw =
-				(memcmp(text_main, MemGetMainPtr(0x400),  sizeof(text_main)) != 0) ||
-				(memcmp(text_aux,  MemGetAuxPtr(0x400),   sizeof(text_aux))  != 0) ||
-				(memcmp(hgr_main,  MemGetMainPtr(0x2000), sizeof(hgr_main))  != 0) ||
-				(memcmp(hgr_aux,   MemGetAuxPtr(0x2000),  sizeof(hgr_aux))   != 0);
-		}
-	}
-
-	if (bRedraw)
-		VideoRedrawScreenAfterFullSpeed(dwCyclesThisFrame);
-
-	// Copy all video memory (+ screen holes)
-	memcpy(text_main, MemGetMainPtr(0x400),  sizeof(text_main));
-	memcpy(text_aux,  MemGetAuxPtr(0x400),   sizeof(text_aux));
-	memcpy(hgr_main,  MemGetMainPtr(0x2000), sizeof(hgr_main));
-	memcpy(hgr_aux,   MemGetAuxPtr(0x2000),  sizeof(hgr_aux));
+	// Always redraw all scanlines for bValid==false (ie. just entered full-speed mode), as eg. the debugger may have changed memory
+	// - after that only redraw the scanlines whose video memory or mode has changed
+	VideoRedrawScreenAfterFullSpeed(dwCyclesThisFrame, bValid);
 
 	bValid = true;
-#else
-	VideoRedrawScreenAfterFullSpeed(dwCyclesThisFrame);
-#endif
 }
 
 //===========================================================================
 
-void VideoRedrawScreenAfterFullSpeed(DWORD dwCyclesThisFrame)
+void VideoRedrawScreenAfterFullSpeed(DWORD dwCyclesThisFrame, bool bDirtyScanlinesOnly /*=false*/)
 {
 	if (bVideoScannerNTSC)
 	{
@@ -553,6 +547,14 @@ void VideoRedrawScreenAfterFullSpeed(DWORD dwCyclesThisFrame)
 		g_nVideoClockHorz = (uint16_t) (dwCyclesThisFrame % kHClocks);
 	}
 
+	if (bDirtyScanlinesOnly)
+	{
+		NTSC_SetVideoMode( g_uVideoMode );
+		NTSC_VideoRedrawDirtyScanlines( true );
+		VideoRefreshScreen();
+		return;
+	}
+
 	VideoRedrawScreen();	// Better (no flicker) than using: NTSC_VideoReinitialize() or VideoReinitialize()
 }
 
@@ -897,6 +899,19 @@ bool VideoGetVblBar(const DWORD uExecutedCycles)
 	return nCycles < kVDisplayableScanLines * kHClocks;
 }
 
+// Cycles until VBL' next changes (ie. start or end of vertical blanking)
+DWORD VideoGetCyclesUntilVblChange(const DWORD uExecutedCycles)
+{
+	int nCycles = CpuGetCyclesThisVideoFrame(uExecutedCycles);
+
+	const int kScanLines  = bVideoScannerNTSC ? kNTSCScanLines : kPALScanLines;
+	const int kScanCycles = kScanLines * kHClocks;
+	nCycles %= kScanCycles;
+
+	const int kVblCycle = kVDisplayableScanLines * kHClocks;
+	return (nCycles < kVblCycle) ? kVblCycle - nCycles : kScanCycles - nCycles;
+}
+
 //===========================================================================
 
 #define SCREENSHOT_BMP 1
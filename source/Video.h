@@ -164,13 +164,14 @@ void    VideoDestroy ();
 void    VideoDisplayLogo ();
 void    VideoInitialize ();
 void    VideoRedrawScreenDuringFullSpeed(DWORD dwCyclesThisFrame, bool bInit = false);
-void    VideoRedrawScreenAfterFullSpeed(DWORD dwCyclesThisFrame);
+void    VideoRedrawScreenAfterFullSpeed(DWORD dwCyclesThisFrame, bool bDirtyScanlinesOnly = false);
 void    VideoRedrawScreen (void);
 void    VideoRefreshScreen (uint32_t uRedrawWholeScreenVideoMode = 0, bool bRedrawWholeScreen = false);
 void    VideoReinitialize ();
 void    VideoResetState ();
 WORD    VideoGetScannerAddress(bool* pbVblBar_OUT, const DWORD uExecutedCycles);
 bool    VideoGetVblBar(DWORD uExecutedCycles);
+DWORD   VideoGetCyclesUntilVblChange(DWORD uExecutedCycles);
 
 bool    VideoGetSW80COL(void);
 bool    VideoGetSWDHIRES(void);
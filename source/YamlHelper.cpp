@@ -26,21 +26,54 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 #include "Log.h"
 #include "YamlHelper.h"
 
+#include "zlib.h"
+
+#ifndef va_copy	// va_copy() supported from VS2013 (cl.exe v18.00)
+#define va_copy(dst, src) ((dst) = (src))	// OK, as x86 va_list is just a pointer
+#endif
+
 int YamlHelper::InitParser(const char* pPathname)
 {
-	m_hFile = fopen(pPathname, "r");
+	m_binaryFile.clear();
+	m_binaryYaml.clear();
+	m_binaryBlocks.clear();
+
+	m_hFile = fopen(pPathname, "rb");
 	if (m_hFile == NULL)
 	{
 		return 0;
 	}
 
+	SS_BINARY_FILE_HDR hdr;
+	const bool bBinary = (fread(&hdr, sizeof(hdr), 1, m_hFile) == 1) && (hdr.tag == SS_BINARY_FILE_TAG);
+
+	if (bBinary)
+	{
+		if (hdr.version != SS_BINARY_FILE_VER)
+			throw std::string("Binary save-state: Version mismatch");
+
+		InitBinary();	// NB. Closes m_hFile
+	}
+	else
+	{
+		fclose(m_hFile);
+		m_hFile = fopen(pPathname, "r");
+		if (m_hFile == NULL)
+		{
+			return 0;
+		}
+	}
+
 	if (!yaml_parser_initialize(&m_parser))
 	{
 		return 0;
 	}
 
 	// Note: C/C++ > Pre-Processor: YAML_DECLARE_STATIC;
-	yaml_parser_set_input_file(&m_parser, m_hFile);
+	if (bBinary)
+		yaml_parser_set_input_string(&m_parser, &m_binaryYaml[0], m_binaryYaml.size());
+	else
+		yaml_parser_set_input_file(&m_parser, m_hFile);
 
 	return 1;
 }
@@ -51,6 +84,87 @@ void YamlHelper::FinaliseParser(void)
 		fclose(m_hFile);
 
 	m_hFile = NULL;
+
+	m_binaryFile.clear();
+	m_binaryYaml.clear();
+	m_binaryBlocks.clear();
+}
+
+//
+
+static void UncompressBinaryChunk(const SS_BINARY_CHUNK_HDR* pChunk, BYTE* pDst)
+{
+	const BYTE* pSrc = (const BYTE*) (pChunk+1);
+
+	if (pChunk->packedSize == pChunk->size)
+	{
+		memcpy(pDst, pSrc, pChunk->size);	// Stored uncompressed
+		return;
+	}
+
+	uLongf dstSize = pChunk->size;
+	if (uncompress(pDst, &dstSize, pSrc, pChunk->packedSize) != Z_OK || dstSize != pChunk->size)
+		throw std::string("Binary save-state: Corrupt chunk");
+}
+
+// Pre: m_hFile is just after the SS_BINARY_FILE_HDR
+// . Read the rest of the file & index its chunks (memory blocks are only uncompressed by LoadMemory())
+void YamlHelper::InitBinary(void)
+{
+	const long pos = ftell(m_hFile);
+	fseek(m_hFile, 0, SEEK_END);
+	const long size = ftell(m_hFile) - pos;
+	fseek(m_hFile, pos, SEEK_SET);
+
+	if (size > 0)
+	{
+		m_binaryFile.resize(size);
+		if (fread(&m_binaryFile[0], 1, size, m_hFile) != (size_t)size)
+			m_binaryFile.clear();
+	}
+
+	fclose(m_hFile);
+	m_hFile = NULL;
+
+	const SS_BINARY_CHUNK_HDR* pYaml = NULL;
+
+	for (size_t offset = 0; offset < m_binaryFile.size(); )
+	{
+		if (m_binaryFile.size() - offset < sizeof(SS_BINARY_CHUNK_HDR))
+			throw std::string("Binary save-state: Truncated file");
+
+		const SS_BINARY_CHUNK_HDR* pChunk = (const SS_BINARY_CHUNK_HDR*) &m_binaryFile[offset];
+		offset += sizeof(SS_BINARY_CHUNK_HDR);
+
+		if (m_binaryFile.size() - offset < pChunk->packedSize || pChunk->packedSize > pChunk->size)
+			throw std::string("Binary save-state: Truncated file");
+
+		offset += pChunk->packedSize;
+
+		if (pChunk->id == SS_BINARY_CHUNK_MEMORY)
+			m_binaryBlocks.push_back(pChunk);
+		else if (pChunk->id == SS_BINARY_CHUNK_YAML)
+			pYaml = pChunk;
+		// else: unknown chunk - skip it
+	}
+
+	if (pYaml == NULL || pYaml->size == 0)
+		throw std::string("Binary save-state: Missing YAML chunk");
+
+	m_binaryYaml.resize(pYaml->size);
+	UncompressBinaryChunk(pYaml, &m_binaryYaml[0]);
+}
+
+void YamlHelper::LoadBinaryBlock(const UINT block, const LPBYTE pMemBase, const size_t kAddrSpaceSize)
+{
+	if (block >= m_binaryBlocks.size())
+		throw std::string("Memory: binary block not found");
+
+	const SS_BINARY_CHUNK_HDR* pChunk = m_binaryBlocks[block];
+	if (pChunk->size > kAddrSpaceSize)
+		throw std::string("Memory: binary block overflowed address space");
+
+	UncompressBinaryChunk(pChunk, pMemBase);
 }
 
 void YamlHelper::GetNextEvent(bool bInMap /*= false*/)
@@ -239,6 +353,15 @@ void YamlHelper::MakeAsciiToHexTable(void)
 
 void YamlHelper::LoadMemory(MapYaml& mapYaml, const LPBYTE pMemBase, const size_t kAddrSpaceSize)
 {
+	bool bFound;
+	const std::string block = GetMapValue(mapYaml, SS_YAML_KEY_BINARY_BLOCK, bFound);
+	if (bFound)
+	{
+		LoadBinaryBlock(strtoul(block.c_str(), NULL, 0), pMemBase, kAddrSpaceSize);
+		mapYaml.clear();
+		return;
+	}
+
 	for (MapYaml::iterator it = mapYaml.begin(); it != mapYaml.end(); ++it)
 	{
 		const char* pKey = it->first.c_str();
@@ -349,13 +472,86 @@ void YamlLoadHelper::LoadMemory(const LPBYTE pMemBase, const size_t size)
 
 //-------------------------------------
 
+YamlSaveHelper::~YamlSaveHelper()
+{
+	if (m_hFile)
+	{
+		Printf("...\n");
+
+		if (m_bBinary)
+			WriteBinaryChunk(SS_BINARY_CHUNK_YAML, (const BYTE*)m_yaml.data(), (UINT32)m_yaml.size());
+
+		fclose(m_hFile);
+	}
+}
+
+void YamlSaveHelper::Write(const char* pData, const size_t size)
+{
+	if (m_bBinary)
+		m_yaml.append(pData, size);
+	else
+		fwrite(pData, 1, size, m_hFile);
+}
+
+void YamlSaveHelper::Printf(const char* format, ...)
+{
+	va_list vl;
+	va_start(vl, format);
+	VPrintf(format, vl);
+	va_end(vl);
+}
+
+void YamlSaveHelper::VPrintf(const char* format, va_list vl)
+{
+	if (!m_bBinary)
+	{
+		vfprintf(m_hFile, format, vl);
+		return;
+	}
+
+	// Format straight into m_yaml, sized for the line (eg. long pathnames), as vfprintf() has no limit either
+	// . NB. Size it with a copy of vl, as a va_list can't be used again once consumed
+	va_list vlSize;
+	va_copy(vlSize, vl);
+	const int len = _vscprintf(format, vlSize);
+	va_end(vlSize);
+	if (len <= 0)
+		return;
+
+	const size_t pos = m_yaml.size();
+	m_yaml.resize(pos + len + 1);
+	vsprintf_s(&m_yaml[pos], len + 1, format, vl);
+	m_yaml.resize(pos + len);	// Drop vsprintf_s()'s terminating null
+}
+
+// Store uncompressed if zlib can't shrink it (eg. random memory init pattern)
+void YamlSaveHelper::WriteBinaryChunk(const UINT32 id, const BYTE* pData, const UINT32 size)
+{
+	std::vector<BYTE> packed(compressBound(size));
+	uLongf packedSize = (uLongf) packed.size();
+
+	// Z_BEST_SPEED: mostly zero or repetitive memory still compresses well, and save-state is fast
+	if (compress2(&packed[0], &packedSize, pData, size, Z_BEST_SPEED) != Z_OK || packedSize >= size)
+	{
+		packedSize = size;
+	}
+	else
+	{
+		pData = &packed[0];
+	}
+
+	SS_BINARY_CHUNK_HDR hdr = {id, size, (UINT32)packedSize};
+	fwrite(&hdr, sizeof(hdr), 1, m_hFile);
+	fwrite(pData, 1, packedSize, m_hFile);
+}
+
 void YamlSaveHelper::Save(const char* format, ...)
 {
-	fwrite(m_szIndent, 1, m_indent, m_hFile);
+	Write(m_szIndent, m_indent);
 
 	va_list vl;
 	va_start(vl, format);
-	vfprintf(m_hFile, format, vl);
+	VPrintf(format, vl);
 	va_end(vl);
 }
 
@@ -420,6 +616,13 @@ void YamlSaveHelper::SaveMemory(const LPBYTE pMemBase, const UINT uMemSize)
 	if (uMemSize & 7)
 		throw std::string("Memory: size must be multiple of 8");
 
+	if (m_bBinary)
+	{
+		Save("%s: %u\n", SS_YAML_KEY_BINARY_BLOCK, m_uNumBinaryBlocks++);
+		WriteBinaryChunk(SS_BINARY_CHUNK_MEMORY, pMemBase, uMemSize);
+		return;
+	}
+
 	const UINT kIndent = m_indent;
 
 	const UINT kStride = 64;
@@ -465,7 +668,7 @@ void YamlSaveHelper::SaveMemory(const LPBYTE pMemBase, const UINT uMemSize)
 		*pDst++ = '\n';
 		*pDst = 0;	// For debugger
 
-		fwrite(pLine, 1, lineSize-1, m_hFile);	// -1 so don't write null terminator
+		Write(pLine, lineSize-1);	// -1 so don't write null terminator
 	}
 
 	delete [] pLine;
@@ -473,7 +676,7 @@ void YamlSaveHelper::SaveMemory(const LPBYTE pMemBase, const UINT uMemSize)
 
 void YamlSaveHelper::FileHdr(UINT version)
 {
-	fprintf(m_hFile, "%s:\n", SS_YAML_KEY_FILEHDR);
+	Printf("%s:\n", SS_YAML_KEY_FILEHDR);
 	m_indent = 2;
 	SaveString(SS_YAML_KEY_TAG, SS_YAML_VALUE_AWSS);
 	SaveInt(SS_YAML_KEY_VERSION, version);
@@ -481,7 +684,7 @@ void YamlSaveHelper::FileHdr(UINT version)
 
 void YamlSaveHelper::UnitHdr(std::string type, UINT version)
 {
-	fprintf(m_hFile, "\n%s:\n", SS_YAML_KEY_UNIT);
+	Printf("\n%s:\n", SS_YAML_KEY_UNIT);
 	m_indent = 2;
 	SaveString(SS_YAML_KEY_TYPE, type.c_str());
 	SaveInt(SS_YAML_KEY_VERSION, version);
@@ -10,8 +10,32 @@
 #define SS_YAML_KEY_CARD "Card"
 #define SS_YAML_KEY_STATE "State"
 
+#define SS_YAML_KEY_BINARY_BLOCK "Binary Block"
+
 #define SS_YAML_VALUE_AWSS "AppleWin Save State"
 
+// Binary save-state (eg. SaveState.aws.bin):
+// . The same YAML as a .aws.yaml, except each SaveMemory() block is just "Binary Block: <n>"
+// . Block <n> is stored (zlib-compressed) in its own chunk, so no hex formatting or parsing
+// . File: header, then chunks (all the memory blocks, then the YAML text)
+#define SS_BINARY_FILE_TAG 0x42535741	// "AWSB"
+#define SS_BINARY_FILE_VER 1
+#define SS_BINARY_CHUNK_MEMORY 0x424D454D	// "MEMB"
+#define SS_BINARY_CHUNK_YAML 0x4C4D4159		// "YAML"
+
+struct SS_BINARY_FILE_HDR
+{
+	UINT32 tag;
+	UINT32 version;
+};
+
+struct SS_BINARY_CHUNK_HDR
+{
+	UINT32 id;
+	UINT32 size;		// Uncompressed size
+	UINT32 packedSize;	// Size of data following this header (== size if stored uncompressed)
+};
+
 struct MapValue;
 typedef std::map<std::string, MapValue> MapYaml;
 
@@ -54,6 +78,9 @@ private:
 
 	void MakeAsciiToHexTable(void);
 
+	void InitBinary(void);
+	void LoadBinaryBlock(const UINT block, const LPBYTE pMemBase, const size_t kAddrSpaceSize);
+
 	yaml_parser_t m_parser;
 	yaml_event_t m_newEvent;
 
@@ -63,6 +90,11 @@ private:
 	char m_AsciiToHex[256];
 
 	MapYaml m_mapYaml;
+
+	// Binary save-state only:
+	std::vector<BYTE> m_binaryFile;
+	std::vector<BYTE> m_binaryYaml;
+	std::vector<const SS_BINARY_CHUNK_HDR*> m_binaryBlocks;
 };
 
 // -----
@@ -166,11 +198,13 @@ private:
 class YamlSaveHelper
 {
 public:
-	YamlSaveHelper(std::string pathname) :
+	YamlSaveHelper(std::string pathname, bool bBinary = false) :
 		m_hFile(NULL),
-		m_indent(0)
+		m_indent(0),
+		m_bBinary(bBinary),
+		m_uNumBinaryBlocks(0)
 	{
-		m_hFile = fopen(pathname.c_str(), "wt");
+		m_hFile = fopen(pathname.c_str(), bBinary ? "wb" : "wt");
 
 		// todo: handle ERROR_ALREADY_EXISTS - ask if user wants to replace existing file
 		// - at this point any old file will have been truncated to zero
@@ -183,23 +217,23 @@ public:
 		time(&ltime);
 		char timebuf[26];
 		errno_t err = ctime_s(timebuf, sizeof(timebuf), &ltime);	// includes newline at end of string
-		fprintf(m_hFile, "# Date-stamp: %s\n", err == 0 ? timebuf : "Error: Datestamp\n\n");
 
-		fprintf(m_hFile, "---\n");
+		if (m_bBinary)
+		{
+			SS_BINARY_FILE_HDR hdr = {SS_BINARY_FILE_TAG, SS_BINARY_FILE_VER};
+			fwrite(&hdr, sizeof(hdr), 1, m_hFile);
+		}
+
+		Printf("# Date-stamp: %s\n", err == 0 ? timebuf : "Error: Datestamp\n\n");
+
+		Printf("---\n");
 
 		//
 
 		memset(m_szIndent, ' ', kMaxIndent);
 	}
 
-	~YamlSaveHelper()
-	{
-		if (m_hFile)
-		{
-			fprintf(m_hFile, "...\n");
-			fclose(m_hFile);
-		}
-	}
+	~YamlSaveHelper();
 
 	void Save(const char* format, ...);
 
@@ -222,11 +256,11 @@ public:
 		Label(YamlSaveHelper& rYamlSaveHelper, const char* format, ...) :
 			yamlSaveHelper(rYamlSaveHelper)
 		{
-			fwrite(yamlSaveHelper.m_szIndent, 1, yamlSaveHelper.m_indent, yamlSaveHelper.m_hFile);
+			yamlSaveHelper.Write(yamlSaveHelper.m_szIndent, yamlSaveHelper.m_indent);
 
 			va_list vl;
 			va_start(vl, format);
-			vfprintf(yamlSaveHelper.m_hFile, format, vl);
+			yamlSaveHelper.VPrintf(format, vl);
 			va_end(vl);
 
 			yamlSaveHelper.m_indent += 2;
@@ -259,9 +293,19 @@ public:
 	void UnitHdr(std::string type, UINT version);
 
 private:
+	void Write(const char* pData, const size_t size);
+	void Printf(const char* format, ...);
+	void VPrintf(const char* format, va_list vl);
+	void WriteBinaryChunk(const UINT32 id, const BYTE* pData, const UINT32 size);
+
 	FILE* m_hFile;
 
 	int m_indent;
 	static const UINT kMaxIndent = 50*2;
 	char m_szIndent[kMaxIndent];
+
+	// Binary save-state only:
+	bool m_bBinary;
+	UINT m_uNumBinaryBlocks;
+	std::string m_yaml;		// YAML text, written as the last chunk
 };
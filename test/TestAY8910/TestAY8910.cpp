@@ -0,0 +1,287 @@
+#include "stdafx.h"
+
+#include "../../source/AY8910.h"
+#include "../../source/YamlHelper.h"
+
+// From Applewin.cpp
+double g_fCurrentCLK6502 = 1020484.0;
+
+// From CPU.cpp
+unsigned __int64 g_nCumulativeCycles = 0;
+
+// From YamlHelper.cpp (snapshots aren't tested here)
+bool YamlHelper::GetSubMap(MapYaml** mapYaml, const std::string key)		{ return false; }
+UINT YamlLoadHelper::LoadUint(const std::string key)						{ return 0; }
+std::string YamlLoadHelper::LoadString(const std::string& key)				{ return std::string(); }
+std::string YamlLoadHelper::LoadString_NoThrow(const std::string& key, bool& bFound)	{ bFound = false; return std::string(); }
+void YamlSaveHelper::Save(const char* format, ...)							{}
+void YamlSaveHelper::SaveUint(const char* key, UINT value)					{}
+void YamlSaveHelper::SaveHexUint4(const char* key, UINT value)				{}
+void YamlSaveHelper::SaveHexUint8(const char* key, UINT value)				{}
+void YamlSaveHelper::SaveHexUint12(const char* key, UINT value)				{}
+void YamlSaveHelper::SaveHexUint16(const char* key, UINT value)				{}
+void YamlSaveHelper::Write(const char* pData, const size_t size)			{}
+void YamlSaveHelper::VPrintf(const char* format, va_list vl)				{}
+
+//-------------------------------------
+
+static const int kClock = 1020484;
+static const UINT kCyclesPerFrame = 17030;	// 60Hz
+static const UINT kNumVoices = 3;
+static const UINT kMaxSamples = 1024;
+
+// Chip 0 runs the original (reference) generator, chip 1 the span generator
+static const int kChipRef = 0;
+static const int kChipSpan = 1;
+
+static INT16 g_aVoice[2][kNumVoices][kMaxSamples];
+static INT16* g_ppVoice[2][kNumVoices];
+
+static UINT32 g_uSeed = 0x12345678;
+
+static UINT Random(void)
+{
+	g_uSeed = g_uSeed * 1103515245 + 12345;
+	return g_uSeed >> 8;
+}
+
+//-------------------------------------
+
+// A register stream: writes within a frame, as (cycle, reg, val)
+struct RegWrite
+{
+	UINT cycle;
+	BYTE reg, val;
+};
+
+static RegWrite g_aWrites[4096];
+static UINT g_uNumWrites = 0;
+
+static void AddWrite(UINT cycle, BYTE reg, BYTE val)
+{
+	if (g_uNumWrites < sizeof(g_aWrites)/sizeof(g_aWrites[0]))
+	{
+		RegWrite w = {cycle, reg, val};
+		g_aWrites[g_uNumWrites++] = w;
+	}
+}
+
+// Stream generators: each fills g_aWrites[] (in cycle order) for one frame
+enum {STREAM_MUSIC=0, STREAM_ENVELOPE, STREAM_NOISE, STREAM_SAMPLES, STREAM_RANDOM, NUM_STREAMS};
+static const char* g_szStream[NUM_STREAMS] = {"music", "envelope", "noise", "samples", "random"};
+
+static void MakeFrame(const UINT uStream, const UINT uFrame)
+{
+	g_uNumWrites = 0;
+
+	switch (uStream)
+	{
+	case STREAM_MUSIC:		// a tracker-style player: one burst of writes per frame, with vibrato & the odd envelope/noise note
+		{
+			UINT cycle = 100 + Random() % 1000;
+			for (UINT chan=0; chan<3; chan++)
+			{
+				const UINT period = (50 << chan) + (uFrame % 7) * 3 + Random() % 4;
+				AddWrite(cycle, chan*2+0, period & 0xff);	cycle += 20;
+				AddWrite(cycle, chan*2+1, period >> 8);		cycle += 20;
+				AddWrite(cycle, 8+chan, (uFrame % 16 == 0 && chan == 2) ? 0x10 : (15 - (uFrame % 12)));	cycle += 20;
+			}
+			AddWrite(cycle, 7, (uFrame % 8 == 0) ? 0x30 : 0x38);	cycle += 20;
+			AddWrite(cycle, 6, uFrame & 31);						cycle += 20;
+			if (uFrame % 16 == 0)
+			{
+				AddWrite(cycle, 11, 0x40);	cycle += 20;
+				AddWrite(cycle, 12, 0x00);	cycle += 20;
+				AddWrite(cycle, 13, 0x09);	cycle += 20;
+			}
+		}
+		break;
+
+	case STREAM_ENVELOPE:	// every envelope shape, for a range of envelope periods (including 0)
+		{
+			const UINT shape = uFrame % 16;
+			const UINT envPeriod = (uFrame / 16) % 4 == 0 ? 0 : (1 << ((uFrame / 16) % 12));
+			AddWrite(10, 7, (uFrame & 16) ? 0x38 : 0x3E);		// tones on, or only tone A
+			AddWrite(20, 0, 0x80);
+			AddWrite(30, 2, 0x7F);
+			AddWrite(40, 4, 0x01);	// very short period: flips many times per sample
+			AddWrite(50, 8, 0x10);
+			AddWrite(60, 9, 0x10);
+			AddWrite(70, 10, 0x1F);
+			AddWrite(80, 11, envPeriod & 0xff);
+			AddWrite(90, 12, envPeriod >> 8);
+			AddWrite(100, 13, shape);
+			if (uFrame & 1)
+				AddWrite(kCyclesPerFrame/2, 13, shape ^ 4);
+		}
+		break;
+
+	case STREAM_NOISE:		// every noise period, with all mixer combinations
+		{
+			AddWrite(10, 6, uFrame & 31);
+			AddWrite(20, 7, (uFrame / 32) & 0x3F);
+			AddWrite(30, 8, 15);
+			AddWrite(40, 9, 8);
+			AddWrite(50, 10, 0);	// silent tone
+			AddWrite(60, 0, 0x20);
+			AddWrite(70, 2, 0x00);	// period 0 == 1
+			AddWrite(80, 3, 0x00);
+			AddWrite(90, 4, 0xFF);
+			AddWrite(100, 5, 0x0F);
+		}
+		break;
+
+	case STREAM_SAMPLES:	// 4-bit sample playback: tones & noise off, volume written every ~100 cycles
+		{
+			AddWrite(0, 7, 0x3F);
+			for (UINT cycle=20; cycle<kCyclesPerFrame; cycle+=90+Random()%20)
+				AddWrite(cycle, 8+(cycle%3), Random() & 15);
+		}
+		break;
+
+	case STREAM_RANDOM:		// anything goes
+		{
+			UINT cycle = 0;
+			const UINT n = Random() % 64;
+			for (UINT i=0; i<n; i++)
+			{
+				cycle += Random() % (2*kCyclesPerFrame/(n+1));
+				if (cycle >= kCyclesPerFrame)
+					break;
+				AddWrite(cycle, Random() % 14, Random() & 0xff);
+			}
+		}
+		break;
+	}
+}
+
+//-------------------------------------
+
+static void Reset(void)
+{
+	g_nCumulativeCycles = 0;
+	AY8910UpdateSetCycles();
+
+	for (int chip=0; chip<2; chip++)
+	{
+		AY8910_reset(chip);
+		for (UINT v=0; v<kNumVoices; v++)
+			g_ppVoice[chip][v] = g_aVoice[chip][v];
+	}
+}
+
+// Play one frame of the stream on a chip; then generate its samples
+static void PlayFrame(const int chip, const UINT uNumSamples, const unsigned __int64 uFrameStart)
+{
+	for (UINT i=0; i<g_uNumWrites; i++)
+	{
+		g_nCumulativeCycles = uFrameStart + g_aWrites[i].cycle;
+		_AYWriteReg(chip, g_aWrites[i].reg, g_aWrites[i].val);
+	}
+
+	g_nCumulativeCycles = uFrameStart + kCyclesPerFrame;
+	AY8910Update(chip, g_ppVoice[chip], uNumSamples);
+}
+
+// The span generator must produce exactly the same waveform as the original generator:
+// . for a set of register streams, over many frames (so all the internal counters are compared indirectly)
+
+int Span_test(void)
+{
+	const UINT kNumFrames = 256;
+
+	for (UINT uStream=0; uStream<NUM_STREAMS; uStream++)
+	{
+		Reset();
+
+		for (UINT uFrame=0; uFrame<kNumFrames; uFrame++)
+		{
+			const UINT uNumSamples = 734 + (uFrame % 3);	// NB. MB_Update()'s sample count varies per frame
+			const unsigned __int64 uFrameStart = g_nCumulativeCycles;
+
+			MakeFrame(uStream, uFrame);
+
+			// Both chips get the same writes at the same cycles, so AY8910Update() for chip 0 resetting the cycle base doesn't matter
+			for (UINT i=0; i<g_uNumWrites; i++)
+			{
+				g_nCumulativeCycles = uFrameStart + g_aWrites[i].cycle;
+				_AYWriteReg(kChipRef, g_aWrites[i].reg, g_aWrites[i].val);
+				_AYWriteReg(kChipSpan, g_aWrites[i].reg, g_aWrites[i].val);
+			}
+
+			g_nCumulativeCycles = uFrameStart + kCyclesPerFrame;
+
+			AY8910_SetSpanGenerator(false);
+			AY8910Update(kChipRef, g_ppVoice[kChipRef], uNumSamples);
+			AY8910_SetSpanGenerator(true);
+			AY8910Update(kChipSpan, g_ppVoice[kChipSpan], uNumSamples);
+
+			for (UINT v=0; v<kNumVoices; v++)
+			{
+				for (UINT i=0; i<uNumSamples; i++)
+				{
+					if (g_aVoice[kChipRef][v][i] != g_aVoice[kChipSpan][v][i])
+					{
+						printf("Span_test: mismatch: stream=%s, frame=%d, voice=%d, sample=%d: %d != %d\n",
+							g_szStream[uStream], uFrame, v, i, g_aVoice[kChipSpan][v][i], g_aVoice[kChipRef][v][i]);
+						return 1;
+					}
+				}
+			}
+		}
+	}
+
+	return 0;
+}
+
+//-------------------------------------
+
+// Time 10 seconds of the music stream for each generator
+
+static double Benchmark(const bool bSpan)
+{
+	const UINT kNumFrames = 60*10;
+
+	Reset();
+	g_uSeed = 0x12345678;
+	AY8910_SetSpanGenerator(bSpan);
+
+	LARGE_INTEGER freq, start, end;
+	QueryPerformanceFrequency(&freq);
+	QueryPerformanceCounter(&start);
+
+	for (UINT uFrame=0; uFrame<kNumFrames; uFrame++)
+	{
+		MakeFrame(STREAM_MUSIC, uFrame);
+		PlayFrame(kChipRef, 735, g_nCumulativeCycles);
+	}
+
+	QueryPerformanceCounter(&end);
+	AY8910_SetSpanGenerator(true);
+
+	return (double)(end.QuadPart - start.QuadPart) * 1000.0 / (double)freq.QuadPart;
+}
+
+void Span_benchmark(void)
+{
+	const double fRef = Benchmark(false);
+	const double fSpan = Benchmark(true);
+	printf("Span_benchmark: sample-by-sample=%.1fms, span=%.1fms\n", fRef, fSpan);
+}
+
+//-------------------------------------
+
+int _tmain(int argc, _TCHAR* argv[])
+{
+	int res = 1;
+
+	AY8910_InitAll(kClock, 44100);
+	AY8910_InitClock(kClock);
+
+	res = Span_test();
+	if (res) return res;
+
+	Span_benchmark();
+
+	return 0;
+}
@@ -12,6 +12,11 @@ enum AppMode_e g_nAppMode = MODE_RUNNING;
 LPBYTE         memwrite[0x100];		// TODO: Init
 LPBYTE         mem          = NULL;	// TODO: Init
 LPBYTE         memdirty     = NULL;	// TODO: Init
+BYTE           memtrap[0x100];
+LPBYTE         memtrapwrite[0x100];
+#ifdef MEM_NOCOPY_PAGING
+LPBYTE         memread[0x100];
+#endif
 iofunction		IORead[256] = {0};	// TODO: Init
 iofunction		IOWrite[256] = {0};	// TODO: Init
 
@@ -39,17 +44,6 @@ eCpuType GetActiveCpu(void)
 
 bool g_bStopOnBRK = false;
 
-static __forceinline int Fetch(BYTE& iOpcode, ULONG uExecutedCycles)
-{
-	iOpcode = *(mem+regs.pc);
-	regs.pc++;
-
-	if (iOpcode == 0x00 && g_bStopOnBRK)
-		return 0;
-
-	return 1;
-}
-
 static __forceinline void DoIrqProfiling(DWORD uCycles)
 {
 }
@@ -62,8 +56,31 @@ static __forceinline void NMI(ULONG& uExecutedCycles, BOOL& flagc, BOOL& flagn,
 {
 }
 
+// From CPU.cpp
+#include "../../source/CPU/cpu_irq.inl"
+
+static volatile UINT g_uIrqSeenCount = 0;
+
 static __forceinline void IRQ(ULONG& uExecutedCycles, BOOL& flagc, BOOL& flagn, BOOL& flagv, BOOL& flagz)
 {
+	if(g_bmIRQ && !(regs.ps & AF_INTERRUPT))
+		g_uIrqSeenCount++;	// Just observe the IRQ line (don't take the interrupt)
+}
+
+// From cpu_breakpoints.inl (via CPU.cpp): just record the write, then write to the trapped page
+static UINT g_uWriteTrapCount = 0;
+static WORD g_nWriteTrapAddr = 0;
+static BYTE g_nWriteTrapValue = 0;
+
+static void CpuWriteTrap(WORD addr, BYTE a, ULONG uExecutedCycles)
+{
+	g_uWriteTrapCount++;
+	g_nWriteTrapAddr = addr;
+	g_nWriteTrapValue = a;
+
+	LPBYTE page = memtrapwrite[addr >> 8];
+	if (page)
+		*(page+(addr & 0xFF)) = a;
 }
 
 // From z80.cpp
@@ -80,6 +97,19 @@ void NTSC_VideoUpdateCycles( long cycles6502 )
 //-------------------------------------
 
 #include "../../source/CPU/cpu_general.inl"
+
+// From CPU.cpp: but without the I/O check (no I/O handlers here), so needs cpu_general.inl's MEMREAD()
+static __forceinline int Fetch(BYTE& iOpcode, ULONG uExecutedCycles)
+{
+	iOpcode = MEMREAD(regs.pc);
+	regs.pc++;
+
+	if (iOpcode == 0x00 && g_bStopOnBRK)
+		return 0;
+
+	return 1;
+}
+
 #include "../../source/CPU/cpu_instructions.inl"
 #include "../../source/CPU/cpu6502.h"  // MOS 6502
 #include "../../source/CPU/cpu65C02.h"  // WDC 65C02
@@ -91,6 +121,11 @@ void init(void)
 	for (UINT i=0; i<256; i++)
 		memwrite[i] = mem+i*256;
 
+#ifdef MEM_NOCOPY_PAGING
+	for (UINT i=0; i<256; i++)
+		memread[i] = mem+i*256;
+#endif
+
 	memdirty = new BYTE[256];
 }
 
@@ -1242,6 +1277,200 @@ int GH321_test()
 
 //-------------------------------------
 
+// Lock-free IRQ/NMI lines (cpu_irq.inl):
+// . Threads (like the SSC's CommThread & the SSI263Thread) each hammer their own IRQ & NMI bit,
+//   while this (emulation) thread runs the 65C02 and asserts/deasserts IS_6522
+// . A non-atomic read-modify-write would lose or resurrect another source's bit
+
+static const UINT kIrqStressLoops = 200000;
+static volatile LONG g_nIrqStressErrors = 0;
+
+static DWORD WINAPI IrqStressThread(LPVOID lpParameter)
+{
+	const eIRQSRC Device = (eIRQSRC) (UINT_PTR) lpParameter;
+	const LONG bit = 1<<Device;
+
+	for (UINT i=0; i<kIrqStressLoops; i++)
+	{
+		CpuIrqAssert(Device);
+		CpuNmiAssert(Device);
+		if ((g_bmIRQ & bit) == 0 || (g_bmNMI & bit) == 0)
+			InterlockedIncrement(&g_nIrqStressErrors);
+
+		CpuIrqDeassert(Device);
+		CpuNmiDeassert(Device);
+		if ((g_bmIRQ & bit) != 0 || (g_bmNMI & bit) != 0)
+			InterlockedIncrement(&g_nIrqStressErrors);
+	}
+
+	return 0;
+}
+
+int IrqStress_test(void)
+{
+	CpuIrqReset();
+	CpuNmiReset();
+
+	reset();
+	mem[regs.pc+0] = 0xE8;	// INX
+	mem[regs.pc+1] = 0x4C;	// JMP $0300
+	mem[regs.pc+2] = 0x00;
+	mem[regs.pc+3] = 0x03;
+
+	const eIRQSRC threadDevices[] = {IS_SPEECH, IS_SSC, IS_MOUSE};
+	const UINT kNumThreads = sizeof(threadDevices) / sizeof(threadDevices[0]);
+	HANDLE hThreads[kNumThreads];
+
+	for (UINT i=0; i<kNumThreads; i++)
+		hThreads[i] = CreateThread(NULL, 0, IrqStressThread, (LPVOID)(UINT_PTR)threadDevices[i], 0, NULL);
+
+	const LONG bit6522 = 1<<IS_6522;
+	UINT uLoops = 0;
+	while (WaitForMultipleObjects(kNumThreads, hThreads, TRUE, 0) == WAIT_TIMEOUT)
+	{
+		CpuIrqAssert(IS_6522);
+		const UINT uIrqSeenCount = g_uIrqSeenCount;
+		TestCpu65C02(1000);
+		if ((g_bmIRQ & bit6522) == 0 || g_uIrqSeenCount == uIrqSeenCount)
+			return 1;
+
+		CpuIrqDeassert(IS_6522);
+		TestCpu65C02(1000);
+		if ((g_bmIRQ & bit6522) != 0)
+			return 1;
+
+		uLoops++;
+	}
+
+	for (UINT i=0; i<kNumThreads; i++)
+		CloseHandle(hThreads[i]);
+
+	if (g_nIrqStressErrors)
+		return 1;
+
+	if (g_bmIRQ != 0 || g_bmNMI != 0)	// All sources deasserted
+		return 1;
+
+	if (uLoops == 0)	// CPU didn't run concurrently with the threads
+		return 1;
+
+	return 0;
+}
+
+//-------------------------------------
+
+// Page traps (see MemSetPageTraps()): a write to a trapped page has a NULL memwrite[] entry, so WRITE calls CpuWriteTrap()
+
+int PageTrap_Sub(DWORD (*TestCpu)(DWORD))
+{
+	const BYTE kPage = 0x20;
+	const BYTE d = 0x5A;
+
+	memtrap[kPage] = MEMTRAP_WRITE;
+	memtrapwrite[kPage] = memwrite[kPage];
+	memwrite[kPage] = NULL;
+
+	mem[0x2010] = mem[0x2011] = mem[0x2110] = 0;
+	g_uWriteTrapCount = 0;
+
+	reset();
+	regs.a = d;
+	regs.x = 1;
+	mem[regs.pc+0] = 0x8D;	// STA $2010
+	mem[regs.pc+1] = 0x10;
+	mem[regs.pc+2] = 0x20;
+	mem[regs.pc+3] = 0x9D;	// STA $2110,X (not trapped)
+	mem[regs.pc+4] = 0x0F;
+	mem[regs.pc+5] = 0x21;
+	mem[regs.pc+6] = 0xFE;	// INC $2010,X
+	mem[regs.pc+7] = 0x10;
+	mem[regs.pc+8] = 0x20;
+
+	TestCpu(0);		// STA abs
+	if (g_uWriteTrapCount != 1 || g_nWriteTrapAddr != 0x2010 || g_nWriteTrapValue != d) return 1;
+	if (mem[0x2010] != d) return 1;	// Written via memtrapwrite[]
+
+	TestCpu(0);		// STA abs,X
+	if (g_uWriteTrapCount != 1) return 1;
+	if (mem[0x2110] != d) return 1;
+
+	const UINT uWriteTrapCount = g_uWriteTrapCount;
+	TestCpu(0);		// INC abs,X: read-modify-write
+	if (g_uWriteTrapCount == uWriteTrapCount || g_nWriteTrapAddr != 0x2011 || g_nWriteTrapValue != 0x01) return 1;
+	if (mem[0x2011] != 0x01) return 1;
+
+	memwrite[kPage] = memtrapwrite[kPage];
+	memtrapwrite[kPage] = NULL;
+	memtrap[kPage] = 0;
+
+	return 0;
+}
+
+int PageTrap_test(void)
+{
+	int res = PageTrap_Sub(TestCpu6502);
+	if (res) return res;
+
+	res = PageTrap_Sub(TestCpu65C02);
+	if (res) return res;
+
+	return 0;
+}
+
+//-------------------------------------
+
+#ifdef MEM_NOCOPY_PAGING
+// Zero-copy paging: opcodes & operands are read via memread[], not mem[] (which is just a view, and may be stale)
+
+int MemRead_Sub(DWORD (*TestCpu)(DWORD))
+{
+	const BYTE kPageCode = 0x03;
+	const BYTE kPageData = 0x20;
+	BYTE aCode[256] = {0};
+	BYTE aData[256] = {0};
+
+	memread[kPageCode] = aCode;
+	memread[kPageData] = aData;
+
+	reset();
+	regs.a = 0;
+	aCode[0] = 0xAD;	// LDA $2040
+	aCode[1] = 0x40;
+	aCode[2] = 0x20;
+	aCode[3] = 0x8D;	// STA $2041
+	aCode[4] = 0x41;
+	aCode[5] = 0x20;
+	aData[0x40] = 0xA5;
+
+	mem[0x300] = mem[0x301] = mem[0x302] = 0xEA;	// Stale view: NOP
+	mem[0x2040] = mem[0x2041] = 0;
+
+	TestCpu(0);		// LDA abs
+	if (regs.pc != 0x303 || regs.a != 0xA5) return 1;
+
+	TestCpu(0);		// STA abs: writes still go via memwrite[]
+	if (mem[0x2041] != 0xA5 || aData[0x41] != 0) return 1;
+
+	memread[kPageCode] = mem + (kPageCode << 8);
+	memread[kPageData] = mem + (kPageData << 8);
+
+	return 0;
+}
+
+int MemRead_test(void)
+{
+	int res = MemRead_Sub(TestCpu6502);
+	if (res) return res;
+
+	res = MemRead_Sub(TestCpu65C02);
+	if (res) return res;
+
+	return 0;
+}
+#endif
+
+//-------------------------------------
+
 int _tmain(int argc, _TCHAR* argv[])
 {
 	int res = 1;
@@ -1266,5 +1495,16 @@ int _tmain(int argc, _TCHAR* argv[])
 	res = GH292_test();
 	if (res) return res;
 
+	res = IrqStress_test();
+	if (res) return res;
+
+	res = PageTrap_test();
+	if (res) return res;
+
+#ifdef MEM_NOCOPY_PAGING
+	res = MemRead_test();
+	if (res) return res;
+#endif
+
 	return 0;
 }
@@ -0,0 +1,49 @@
+#include "stdafx.h"
+
+#include "../../source/Liron.h"
+
+//-------------------------------------
+
+// Range checks for SmartPort/ProDOS block reads & writes
+// . Extended calls (0x41/0x42) carry a 32-bit block number, so blk*0x200 can overflow
+
+int BlockValid_test(void)
+{
+	const UINT kImageSize = 32*1024*1024;	// 32MB: largest ProDOS volume
+	const UINT kImageBlocks = kImageSize / 0x200;
+
+	// In range
+	if (!Liron_IsBlockValid(kImageSize, 0)) return 1;
+	if (!Liron_IsBlockValid(kImageSize, kImageBlocks-1)) return 1;
+
+	// Just past the end
+	if (Liron_IsBlockValid(kImageSize, kImageBlocks)) return 1;
+
+	// Extended block numbers: blk*0x200 wraps to within the image in 32 bits
+	if (Liron_IsBlockValid(kImageSize, 0x00800000)) return 1;
+	if (Liron_IsBlockValid(kImageSize, 0x007FFFFF)) return 1;
+	if (Liron_IsBlockValid(kImageSize, 0x00800001)) return 1;
+	if (Liron_IsBlockValid(kImageSize, 0xFFFFFFFF)) return 1;
+
+	// Empty or sub-block image
+	if (Liron_IsBlockValid(0, 0)) return 1;
+	if (Liron_IsBlockValid(0x1FF, 0)) return 1;
+
+	// Largest image: 4GB-512
+	if (!Liron_IsBlockValid(0xFFFFFE00, 0x007FFFFE)) return 1;
+	if (Liron_IsBlockValid(0xFFFFFE00, 0x007FFFFF)) return 1;
+
+	return 0;
+}
+
+//-------------------------------------
+
+int _tmain(int argc, _TCHAR* argv[])
+{
+	int res = 1;
+
+	res = BlockValid_test();
+	if (res) return res;
+
+	return 0;
+}
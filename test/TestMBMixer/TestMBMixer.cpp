@@ -0,0 +1,200 @@
+#include "stdafx.h"
+
+#include "../../source/MockingboardMixer.h"
+
+static const UINT NUM_VOICES_PER_AY8910 = 3;
+static const UINT MAX_AY8910 = 8;				// 4 cards (MB_Update() only mixes 2 cards, ie. 4 AY8910s)
+static const UINT NUM_SAMPLES = 735 + 5;		// 1 video frame @ 44.1KHz (+ a non-multiple of 8 tail)
+
+static short g_aVoiceData[MAX_AY8910*NUM_VOICES_PER_AY8910][NUM_SAMPLES];
+static short* g_ppVoiceBuffer[MAX_AY8910*NUM_VOICES_PER_AY8910];
+
+static short g_aGolden[NUM_SAMPLES*2];
+static short g_aMix[NUM_SAMPLES*2];
+
+//-------------------------------------
+
+// The original MB_Update() mix loop (generalised to N AY8910s)
+static void MixVoicesDouble(short* pMixBuffer, short* const* ppAYVoiceBuffer, const UINT uNumAY8910, const UINT uNumSamples, const double fAttenuation)
+{
+	static const SHORT nWaveDataMin = (SHORT)0x8000;
+	static const SHORT nWaveDataMax = (SHORT)0x7FFF;
+
+	for(UINT i=0; i<uNumSamples; i++)
+	{
+		int nDataL = 0, nDataR = 0;
+
+		for(UINT j=0; j<NUM_VOICES_PER_AY8910; j++)
+		{
+			for(UINT uChip=0; uChip<uNumAY8910; uChip+=2)
+			{
+				nDataL += (int) ((double)ppAYVoiceBuffer[(uChip+0)*NUM_VOICES_PER_AY8910+j][i] * fAttenuation);
+				nDataR += (int) ((double)ppAYVoiceBuffer[(uChip+1)*NUM_VOICES_PER_AY8910+j][i] * fAttenuation);
+			}
+		}
+
+		if(nDataL < nWaveDataMin)
+			nDataL = nWaveDataMin;
+		else if(nDataL > nWaveDataMax)
+			nDataL = nWaveDataMax;
+
+		if(nDataR < nWaveDataMin)
+			nDataR = nWaveDataMin;
+		else if(nDataR > nWaveDataMax)
+			nDataR = nWaveDataMax;
+
+		pMixBuffer[i*2+0] = (short)nDataL;
+		pMixBuffer[i*2+1] = (short)nDataR;
+	}
+}
+
+//-------------------------------------
+
+static UINT32 g_uSeed = 0x12345678;
+
+static UINT32 Random(void)
+{
+	g_uSeed = g_uSeed * 1103515245 + 12345;
+	return g_uSeed >> 8;
+}
+
+enum {DATA_RANDOM=0, DATA_EXTREMES, DATA_MULTIPLES_OF_3, DATA_SMALL, NUM_DATA_TYPES};
+
+static void init(const UINT uDataType)
+{
+	for (UINT v=0; v<MAX_AY8910*NUM_VOICES_PER_AY8910; v++)
+	{
+		g_ppVoiceBuffer[v] = g_aVoiceData[v];
+
+		for (UINT i=0; i<NUM_SAMPLES; i++)
+		{
+			short nData = 0;
+			switch (uDataType)
+			{
+			case DATA_RANDOM:			nData = (short) Random(); break;
+			case DATA_EXTREMES:			nData = (Random() & 1) ? (short)0x8000 : (short)0x7FFF; break;	// saturates both ways
+			case DATA_MULTIPLES_OF_3:	nData = (short) (((int)(Random() % 21845) - 10922) * 3); break;	// 2/3 scaling is exact
+			case DATA_SMALL:			nData = (short) ((int)(Random() % 7) - 3); break;				// rounds towards zero
+			}
+			g_aVoiceData[v][i] = nData;
+		}
+	}
+}
+
+//-------------------------------------
+
+// Fixed-point (scalar & SIMD) mix must be within 1 LSB of the original double-precision mix:
+// . for both attenuations (1.0 & Phasor's 2/3), 1 to 4 cards, and various buffer lengths (to exercise the SIMD tail)
+
+static int compare(const UINT uNumAY8910, const UINT uNumSamples, const double fAttenuation, const char* pszPath)
+{
+	for (UINT i=0; i<uNumSamples*2; i++)
+	{
+		const int nDiff = (int)g_aMix[i] - (int)g_aGolden[i];
+		if (nDiff < -1 || nDiff > 1)
+		{
+			printf("Mix_test: mismatch (%s): AY8910s=%d, samples=%d, attenuation=%f, sample[%d]: %d != %d\n",
+				pszPath, uNumAY8910, uNumSamples, fAttenuation, i, g_aMix[i], g_aGolden[i]);
+			return 1;
+		}
+	}
+
+	return 0;
+}
+
+int Mix_test(void)
+{
+	const double fAttenuation[] = {1.0, 2.0/3.0};
+	const UINT uNumSamples[] = {NUM_SAMPLES, 735, 8, 7, 1, 0};
+	const bool bHasSIMD = MB_MixerSetSIMD(true);
+
+	for (UINT uDataType=0; uDataType<NUM_DATA_TYPES; uDataType++)
+	{
+		init(uDataType);
+
+		for (UINT uNumAY8910=2; uNumAY8910<=MAX_AY8910; uNumAY8910+=2)
+		{
+			for (UINT a=0; a<sizeof(fAttenuation)/sizeof(fAttenuation[0]); a++)
+			{
+				for (UINT n=0; n<sizeof(uNumSamples)/sizeof(uNumSamples[0]); n++)
+				{
+					MixVoicesDouble(g_aGolden, g_ppVoiceBuffer, uNumAY8910, uNumSamples[n], fAttenuation[a]);
+
+					MB_MixerSetSIMD(false);
+					MB_MixVoices(g_aMix, g_ppVoiceBuffer, uNumAY8910, NUM_VOICES_PER_AY8910, uNumSamples[n], fAttenuation[a]);
+					if (compare(uNumAY8910, uNumSamples[n], fAttenuation[a], "scalar"))
+						return 1;
+
+					if (!bHasSIMD)
+						continue;
+
+					MB_MixerSetSIMD(true);
+					MB_MixVoices(g_aMix, g_ppVoiceBuffer, uNumAY8910, NUM_VOICES_PER_AY8910, uNumSamples[n], fAttenuation[a]);
+					if (compare(uNumAY8910, uNumSamples[n], fAttenuation[a], "SIMD"))
+						return 1;
+				}
+			}
+		}
+	}
+
+	if (!bHasSIMD)
+		printf("Mix_test: SIMD skipped (no SSE2)\n");
+
+	return 0;
+}
+
+//-------------------------------------
+
+// Time 1 second of audio (60 video frames) x 100, for 2 cards with Phasor attenuation
+
+static double Benchmark(const int nPath)
+{
+	const UINT kNumFrames = 60*100;
+	const double fAttenuation = 2.0/3.0;
+
+	if (nPath > 0)
+		MB_MixerSetSIMD(nPath == 2);
+
+	LARGE_INTEGER freq, start, end;
+	QueryPerformanceFrequency(&freq);
+	QueryPerformanceCounter(&start);
+
+	for (UINT f=0; f<kNumFrames; f++)
+	{
+		if (nPath == 0)
+			MixVoicesDouble(g_aMix, g_ppVoiceBuffer, 4, 735, fAttenuation);
+		else
+			MB_MixVoices(g_aMix, g_ppVoiceBuffer, 4, NUM_VOICES_PER_AY8910, 735, fAttenuation);
+	}
+
+	QueryPerformanceCounter(&end);
+	return (double)(end.QuadPart - start.QuadPart) * 1000.0 / (double)freq.QuadPart;
+}
+
+void Mix_benchmark(void)
+{
+	init(DATA_RANDOM);
+
+	const double fDouble = Benchmark(0);
+	const double fScalar = Benchmark(1);
+	printf("Mix_benchmark: double=%.1fms, fixed-point=%.1fms", fDouble, fScalar);
+
+	if (MB_MixerSetSIMD(true))
+		printf(", SSE2=%.1fms", Benchmark(2));
+
+	printf("\n");
+}
+
+//-------------------------------------
+
+int _tmain(int argc, _TCHAR* argv[])
+{
+	int res = 1;
+
+	res = Mix_test();
+	if (res) return res;
+
+	Mix_benchmark();
+
+	return 0;
+}
@@ -0,0 +1,188 @@
+#include "stdafx.h"
+
+#include "../../source/Applewin.h"
+#include "../../source/CPU.h"
+#include "../../source/Frame.h"
+#include "../../source/Memory.h"
+#include "../../source/Video.h"
+#include "../../source/NTSC.h"
+#include "../../source/NTSC_CharSet.h"
+
+#include "TestNTSC_Golden.h"
+
+// From Applewin.cpp
+bool g_bFullSpeed = false;
+
+eApple2Type GetApple2Type(void)
+{
+	return A2TYPE_APPLE2EENHANCED;
+}
+
+// From CPU.cpp
+ULONG CpuGetCyclesThisVideoFrame(ULONG nExecutedCycles)
+{
+	return 0;
+}
+
+// From Frame.cpp
+UINT GetFrameBufferBorderlessWidth(void)	{ return 560; }
+UINT GetFrameBufferBorderlessHeight(void)	{ return 384; }
+UINT GetFrameBufferBorderWidth(void)		{ return 20; }
+UINT GetFrameBufferBorderHeight(void)		{ return 18; }
+UINT GetFrameBufferWidth(void)				{ return GetFrameBufferBorderlessWidth() + 2*GetFrameBufferBorderWidth(); }
+UINT GetFrameBufferHeight(void)				{ return GetFrameBufferBorderlessHeight() + 2*GetFrameBufferBorderHeight(); }
+
+// From Memory.cpp
+static BYTE g_aMain[64*1024];
+static BYTE g_aAux[64*1024];
+static BYTE g_aMemDirty[0x100];
+
+LPBYTE memdirty = g_aMemDirty;
+
+LPBYTE MemGetMainPtr(const WORD offset)	{ return g_aMain + offset; }
+LPBYTE MemGetAuxPtr(const WORD offset)	{ return g_aAux + offset; }
+
+// From NTSC_CharSet.cpp (no resources: fill with a fixed pseudo-random pattern)
+unsigned char csbits_enhanced2e[2][256][8];
+unsigned char csbits_2e[2][256][8];
+unsigned char csbits_a2[1][256][8];
+unsigned char csbits_pravets82[1][256][8];
+unsigned char csbits_pravets8M[1][256][8];
+unsigned char csbits_pravets8C[2][256][8];
+
+// From Video.cpp
+COLORREF g_nMonochromeRGB = RGB(0xC0,0xC0,0xC0);
+uint32_t g_uVideoMode = VF_TEXT;
+DWORD g_eVideoType = VT_COLOR_TV;
+DWORD g_uHalfScanLines = 1;
+uint8_t *g_pFramebufferbits = NULL;
+
+bool VideoGetSWAltCharSet(void)
+{
+	return false;
+}
+
+void VideoReinitialize()
+{
+	NTSC_SetVideoStyle();
+}
+
+//-------------------------------------
+
+static UINT32 g_uSeed = 0x12345678;
+
+static BYTE Random(void)
+{
+	g_uSeed = g_uSeed * 1103515245 + 12345;
+	return (BYTE) (g_uSeed >> 16);
+}
+
+void make_csbits(void)
+{
+	for (UINT i=0; i<sizeof(csbits_enhanced2e); i++)
+	{
+		((BYTE*)csbits_enhanced2e)[i] = Random();
+		((BYTE*)csbits_2e)[i] = Random();
+	}
+}
+
+static const UINT kFramebufferSize = (560+2*20) * (384+2*18) * sizeof(bgra_t);
+
+static BYTE g_aFramebuffer[kFramebufferSize];
+
+void init(void)
+{
+	for (UINT i=0; i<sizeof(g_aMain); i++)
+	{
+		g_aMain[i] = Random();
+		g_aAux[i] = Random();
+	}
+
+	g_pFramebufferbits = g_aFramebuffer;
+	NTSC_VideoInit(g_pFramebufferbits);
+	NTSC_VideoInitAppleType();
+}
+
+// Returns a checksum (FNV-1a) of the framebuffer
+UINT32 render(uint32_t uVideoModeFlags)
+{
+	memset(g_aFramebuffer, 0, sizeof(g_aFramebuffer));
+
+	g_uVideoMode = uVideoModeFlags;
+	NTSC_SetVideoMode(uVideoModeFlags);
+
+	// 2nd redraw: interpolated scanlines blend with scanlines already drawn
+	NTSC_VideoRedrawWholeScreen();
+	NTSC_VideoRedrawWholeScreen();
+
+	UINT32 hash = 2166136261;
+	for (UINT i=0; i<sizeof(g_aFramebuffer); i++)
+		hash = (hash ^ g_aFramebuffer[i]) * 16777619;
+
+	return hash;
+}
+
+//-------------------------------------
+
+// The scalar & SIMD kernels must both render the same framebuffer as the original renderer (see TestNTSC_Golden.h):
+// . for every video type, full & half scanlines, and every combination of VF_* video mode flags
+// NB. Each pass over all 128 video modes is 256 frames, so the 8-bit text flash counter is the same at the start of every pass
+
+static int RenderAllModes(const char* pszKernel, UINT videoType, UINT halfScanLines)
+{
+	const uint32_t kVideoModeMask = VF_80COL|VF_DHIRES|VF_HIRES|VF_80STORE|VF_MIXED|VF_PAGE2|VF_TEXT;
+
+	for (uint32_t uVideoModeFlags=0; uVideoModeFlags<=kVideoModeMask; uVideoModeFlags++)
+	{
+		const UINT32 hash = render(uVideoModeFlags);
+		if (hash != g_aGoldenHash[videoType][halfScanLines][uVideoModeFlags])
+		{
+			printf("Render_test: %s mismatch: videoType=%d, halfScanLines=%d, videoMode=0x%02X, hash=0x%08X\n", pszKernel, videoType, halfScanLines, uVideoModeFlags, hash);
+			return 1;
+		}
+	}
+
+	return 0;
+}
+
+int Render_test(void)
+{
+	const bool bSIMD = NTSC_VideoSetSIMD(true);
+	if (!bSIMD)
+		printf("Render_test: SIMD skipped (no SSE2)\n");
+
+	for (UINT videoType=0; videoType<NUM_VIDEO_MODES; videoType++)
+	{
+		for (UINT halfScanLines=0; halfScanLines<2; halfScanLines++)
+		{
+			g_eVideoType = videoType;
+			g_uHalfScanLines = halfScanLines;
+
+			NTSC_VideoSetSIMD(false);	// NB. Also applies the video type (via NTSC_SetVideoStyle())
+			if (RenderAllModes("scalar", videoType, halfScanLines))
+				return 1;
+
+			if (bSIMD)
+			{
+				NTSC_VideoSetSIMD(true);
+				if (RenderAllModes("SIMD", videoType, halfScanLines))
+					return 1;
+			}
+		}
+	}
+
+	return 0;
+}
+
+//-------------------------------------
+
+int _tmain(int argc, _TCHAR* argv[])
+{
+	int res = 1;
+	init();
+
+	res = Render_test();
+	if (res) return res;
+
+	return 0;
+}
@@ -0,0 +1,275 @@
+#pragma once
+
+// FNV-1a hashes of the framebuffer, as rendered by the original (per-pixel function pointer) NTSC.cpp
+// . captured with TestNTSC's init() & render(), in the same order as Render_test()
+// . indexed by [g_eVideoType][g_uHalfScanLines][VF_* video mode flags]
+
+static const UINT32 g_aGoldenHash[NUM_VIDEO_MODES][2][128] =
+{
+	{	// VT_MONO_CUSTOM
+		{
+			0xE117EC85, 0xE117EC85, 0x751952C5, 0x78D72F45, 0x19095D05, 0x19095D05, 0x8413C5B5, 0x63D6DC45,
+			0xE117EC85, 0xE117EC85, 0x751952C5, 0x78D72F45, 0x19095D05, 0x19095D05, 0x8413C5B5, 0x63D6DC45,
+			0x8BCBB5B5, 0x8BCBB5B5, 0x9139E435, 0xD34A9CB5, 0x5DA1B105, 0x5DA1B105, 0xFB765A65, 0x07D21455,
+			0x4CE50C35, 0x4CE50C35, 0xBBB730B5, 0x5F62D935, 0x8301C185, 0x8301C185, 0x804920E5, 0x96FA84D5,
+			0x4BF43D45, 0x4BF43D45, 0x9BE56885, 0x0272BE05, 0xDA451FA5, 0xDA451FA5, 0x2125B025, 0x2070A725,
+			0xE117EC85, 0xE117EC85, 0x751952C5, 0x78D72F45, 0x19095D05, 0x19095D05, 0x8413C5B5, 0x63D6DC45,
+			0x36A65835, 0x36A65835, 0x15F54375, 0xECACC5F5, 0x15765515, 0x15765515, 0xE92FA5D5, 0x0C730B75,
+			0x4CE50C35, 0x4CE50C35, 0xBBB730B5, 0x5F62D935, 0x8301C185, 0x8301C185, 0x804920E5, 0x96FA84D5,
+			0x683B6BC5, 0xD6A6DB65, 0x683B6BC5, 0xD6A6DB65, 0x683B6BC5, 0xD6A6DB65, 0x683B6BC5, 0xD6A6DB65,
+			0xCE82B475, 0xA4EE6BE5, 0xCE82B475, 0xA4EE6BE5, 0xCE82B475, 0xA4EE6BE5, 0xCE82B475, 0xA4EE6BE5,
+			0x683B6BC5, 0xD6A6DB65, 0x683B6BC5, 0xD6A6DB65, 0x683B6BC5, 0xD6A6DB65, 0x683B6BC5, 0xD6A6DB65,
+			0xCE82B475, 0xA4EE6BE5, 0xCE82B475, 0xA4EE6BE5, 0xCE82B475, 0xA4EE6BE5, 0xCE82B475, 0xA4EE6BE5,
+			0x491032E5, 0x6FBB4FD5, 0x491032E5, 0x6FBB4FD5, 0x491032E5, 0x6FBB4FD5, 0x491032E5, 0x6FBB4FD5,
+			0xCE82B475, 0xA4EE6BE5, 0xCE82B475, 0xA4EE6BE5, 0xCE82B475, 0xA4EE6BE5, 0xCE82B475, 0xA4EE6BE5,
+			0x491032E5, 0x6FBB4FD5, 0x491032E5, 0x6FBB4FD5, 0x491032E5, 0x6FBB4FD5, 0x491032E5, 0x6FBB4FD5,
+			0xCE82B475, 0xA4EE6BE5, 0xCE82B475, 0xA4EE6BE5, 0xCE82B475, 0xA4EE6BE5, 0xCE82B475, 0xA4EE6BE5
+		},
+		{
+			0x8DB7BE85, 0x8DB7BE85, 0x495C71C5, 0x3D533C45, 0xDDE942D5, 0xDDE942D5, 0x5EAD3A35, 0xA98E2065,
+			0x8DB7BE85, 0x8DB7BE85, 0x495C71C5, 0x3D533C45, 0xDDE942D5, 0xDDE942D5, 0x5EAD3A35, 0xA98E2065,
+			0x010577B5, 0x010577B5, 0xECB07035, 0xDCE86AB5, 0xA5627B35, 0xA5627B35, 0xE4B63715, 0xE63297A5,
+			0x687F3FB5, 0x687F3FB5, 0x542A3835, 0x446232B5, 0x0CDC4335, 0x0CDC4335, 0x4C2FFF15, 0x4DAC5FA5,
+			0xC4A83045, 0xC4A83045, 0x455C4205, 0xD706F005, 0x0A69CDC5, 0x0A69CDC5, 0x7442AC95, 0xB60CC5E5,
+			0x8DB7BE85, 0x8DB7BE85, 0x495C71C5, 0x3D533C45, 0xDDE942D5, 0xDDE942D5, 0x5EAD3A35, 0xA98E2065,
+			0x8CCFE385, 0x8CCFE385, 0x1D3AC1C5, 0xD675B445, 0x240D0835, 0x240D0835, 0x69F03525, 0x541C46C5,
+			0x687F3FB5, 0x687F3FB5, 0x542A3835, 0x446232B5, 0x0CDC4335, 0x0CDC4335, 0x4C2FFF15, 0x4DAC5FA5,
+			0x51D4FE65, 0xFECFFEA5, 0x51D4FE65, 0xFECFFEA5, 0x51D4FE65, 0xFECFFEA5, 0x51D4FE65, 0xFECFFEA5,
+			0xA50C2BD5, 0x78CF9A05, 0xA50C2BD5, 0x78CF9A05, 0xA50C2BD5, 0x78CF9A05, 0xA50C2BD5, 0x78CF9A05,
+			0x51D4FE65, 0xFECFFEA5, 0x51D4FE65, 0xFECFFEA5, 0x51D4FE65, 0xFECFFEA5, 0x51D4FE65, 0xFECFFEA5,
+			0xA50C2BD5, 0x78CF9A05, 0xA50C2BD5, 0x78CF9A05, 0xA50C2BD5, 0x78CF9A05, 0xA50C2BD5, 0x78CF9A05,
+			0xA9CCD7B5, 0xADA3C2F5, 0xA9CCD7B5, 0xADA3C2F5, 0xA9CCD7B5, 0xADA3C2F5, 0xA9CCD7B5, 0xADA3C2F5,
+			0xA50C2BD5, 0x78CF9A05, 0xA50C2BD5, 0x78CF9A05, 0xA50C2BD5, 0x78CF9A05, 0xA50C2BD5, 0x78CF9A05,
+			0xA9CCD7B5, 0xADA3C2F5, 0xA9CCD7B5, 0xADA3C2F5, 0xA9CCD7B5, 0xADA3C2F5, 0xA9CCD7B5, 0xADA3C2F5,
+			0xA50C2BD5, 0x78CF9A05, 0xA50C2BD5, 0x78CF9A05, 0xA50C2BD5, 0x78CF9A05, 0xA50C2BD5, 0x78CF9A05
+		}
+	},
+	{	// VT_COLOR_MONITOR
+		{
+			0x6B8AE765, 0x6B8AE765, 0x6D67DB95, 0xE78A3165, 0xAA5FDDCD, 0xAA5FDDCD, 0xBED7EAC5, 0x1BB7B88D,
+			0x6B8AE765, 0x6B8AE765, 0x6D67DB95, 0xE78A3165, 0xAA5FDDCD, 0xAA5FDDCD, 0xBED7EAC5, 0x1BB7B88D,
+			0x7AC0C59D, 0x7AC0C59D, 0x947B7C7D, 0x6C7BE1AD, 0x872EE4D9, 0x872EE4D9, 0xA8F16495, 0x60197665,
+			0xF855E2C1, 0xF855E2C1, 0xEE203CA1, 0x167544D1, 0x279A543D, 0x279A543D, 0x710052A9, 0xA7E48EA9,
+			0x3A3179E5, 0x3A3179E5, 0xE6DFE515, 0xA5A73DD5, 0x0B017615, 0x0B017615, 0xA39D0B8D, 0x47FBC6E1,
+			0x6B8AE765, 0x6B8AE765, 0x6D67DB95, 0xE78A3165, 0xAA5FDDCD, 0xAA5FDDCD, 0xBED7EAC5, 0x1BB7B88D,
+			0xA6865189, 0xA6865189, 0x9373AC09, 0xB49720B9, 0x53CEE0C9, 0x53CEE0C9, 0xB0D32629, 0xC5687E71,
+			0xF855E2C1, 0xF855E2C1, 0xEE203CA1, 0x167544D1, 0x279A543D, 0x279A543D, 0x710052A9, 0xA7E48EA9,
+			0xB89243C5, 0xAD221365, 0xB89243C5, 0xAD221365, 0xB89243C5, 0xAD221365, 0xB89243C5, 0xAD221365,
+			0xE103DB55, 0x7DC68BE5, 0xE103DB55, 0x7DC68BE5, 0xE103DB55, 0x7DC68BE5, 0xE103DB55, 0x7DC68BE5,
+			0xB89243C5, 0xAD221365, 0xB89243C5, 0xAD221365, 0xB89243C5, 0xAD221365, 0xB89243C5, 0xAD221365,
+			0xE103DB55, 0x7DC68BE5, 0xE103DB55, 0x7DC68BE5, 0xE103DB55, 0x7DC68BE5, 0xE103DB55, 0x7DC68BE5,
+			0x470A5E25, 0x18D76B75, 0x470A5E25, 0x18D76B75, 0x470A5E25, 0x18D76B75, 0x470A5E25, 0x18D76B75,
+			0xE103DB55, 0x7DC68BE5, 0xE103DB55, 0x7DC68BE5, 0xE103DB55, 0x7DC68BE5, 0xE103DB55, 0x7DC68BE5,
+			0x470A5E25, 0x18D76B75, 0x470A5E25, 0x18D76B75, 0x470A5E25, 0x18D76B75, 0x470A5E25, 0x18D76B75,
+			0xE103DB55, 0x7DC68BE5, 0xE103DB55, 0x7DC68BE5, 0xE103DB55, 0x7DC68BE5, 0xE103DB55, 0x7DC68BE5
+		},
+		{
+			0xB8CF5FC5, 0xB8CF5FC5, 0xE829CAF5, 0x7B5AF045, 0x81E01BD4, 0x81E01BD4, 0xB7B85221, 0x07681E3E,
+			0xB8CF5FC5, 0xB8CF5FC5, 0xE829CAF5, 0x7B5AF045, 0x81E01BD4, 0x81E01BD4, 0xB7B85221, 0x07681E3E,
+			0x4EDC2B10, 0x4EDC2B10, 0xF3104F18, 0x28D0A418, 0xEE595C98, 0xEE595C98, 0xEB7CA3F4, 0x0FA61A10,
+			0x829D7D9F, 0x829D7D9F, 0x991434F7, 0x2DAB2757, 0xD71CCF6B, 0xD71CCF6B, 0x3CB0BEA7, 0x27FDE16B,
+			0x343662E5, 0x343662E5, 0xBDD02FAD, 0xB31CC7FD, 0x0083CD29, 0x0083CD29, 0x2EE01670, 0x17BD72EC,
+			0xB8CF5FC5, 0xB8CF5FC5, 0xE829CAF5, 0x7B5AF045, 0x81E01BD4, 0x81E01BD4, 0xB7B85221, 0x07681E3E,
+			0x30E55994, 0x30E55994, 0xCB98B45C, 0x3933F43C, 0xFC3CB4CF, 0xFC3CB4CF, 0xDF3053C9, 0xC813A679,
+			0x829D7D9F, 0x829D7D9F, 0x991434F7, 0x2DAB2757, 0xD71CCF6B, 0xD71CCF6B, 0x3CB0BEA7, 0x27FDE16B,
+			0xB481C7B5, 0xF9275295, 0xB481C7B5, 0xF9275295, 0xB481C7B5, 0xF9275295, 0xB481C7B5, 0xF9275295,
+			0xB2978D45, 0x258C9635, 0xB2978D45, 0x258C9635, 0xB2978D45, 0x258C9635, 0xB2978D45, 0x258C9635,
+			0xB481C7B5, 0xF9275295, 0xB481C7B5, 0xF9275295, 0xB481C7B5, 0xF9275295, 0xB481C7B5, 0xF9275295,
+			0xB2978D45, 0x258C9635, 0xB2978D45, 0x258C9635, 0xB2978D45, 0x258C9635, 0xB2978D45, 0x258C9635,
+			0x5041A3F6, 0xCDD59EF5, 0x5041A3F6, 0xCDD59EF5, 0x5041A3F6, 0xCDD59EF5, 0x5041A3F6, 0xCDD59EF5,
+			0xB2978D45, 0x258C9635, 0xB2978D45, 0x258C9635, 0xB2978D45, 0x258C9635, 0xB2978D45, 0x258C9635,
+			0x5041A3F6, 0xCDD59EF5, 0x5041A3F6, 0xCDD59EF5, 0x5041A3F6, 0xCDD59EF5, 0x5041A3F6, 0xCDD59EF5,
+			0xB2978D45, 0x258C9635, 0xB2978D45, 0x258C9635, 0xB2978D45, 0x258C9635, 0xB2978D45, 0x258C9635
+		}
+	},
+	{	// VT_MONO_TV
+		{
+			0x5BDB41A7, 0x5BDB41A7, 0xB73C6359, 0x5206129D, 0xC37A961B, 0xC37A961B, 0x648072C0, 0xD15A497A,
+			0x5BDB41A7, 0x5BDB41A7, 0xB73C6359, 0x5206129D, 0xC37A961B, 0xC37A961B, 0x648072C0, 0xD15A497A,
+			0x8717AB88, 0x8717AB88, 0x005DC722, 0x061F517E, 0x8547C68B, 0x8547C68B, 0x0E0A5CA9, 0x4B96DA02,
+			0xFE07DDF8, 0xFE07DDF8, 0x29C20F68, 0x4B7E8368, 0x1E9F456D, 0x1E9F456D, 0xCFCD38DD, 0x84F55380,
+			0x6637E8F6, 0x6637E8F6, 0xAD73D7D2, 0x26587F18, 0xC4AB2FF2, 0xC4AB2FF2, 0xE48D7822, 0xDDE1C5CF,
+			0x5BDB41A7, 0x5BDB41A7, 0xB73C6359, 0x5206129D, 0xC37A961B, 0xC37A961B, 0x648072C0, 0xD15A497A,
+			0x3B72A3B1, 0x3B72A3B1, 0x8FA24FFB, 0x0F1BB371, 0xEDBC4CFB, 0xEDBC4CFB, 0x7313B4DB, 0xD535F734,
+			0xFE07DDF8, 0xFE07DDF8, 0x29C20F68, 0x4B7E8368, 0x1E9F456D, 0x1E9F456D, 0xCFCD38DD, 0x84F55380,
+			0xAB5AE695, 0x5F1ED6D9, 0xAB5AE695, 0x5F1ED6D9, 0xAB5AE695, 0x5F1ED6D9, 0xAB5AE695, 0x5F1ED6D9,
+			0x70D00FC0, 0x45B2C70E, 0x70D00FC0, 0x45B2C70E, 0x70D00FC0, 0x45B2C70E, 0x70D00FC0, 0x45B2C70E,
+			0xAB5AE695, 0x5F1ED6D9, 0xAB5AE695, 0x5F1ED6D9, 0xAB5AE695, 0x5F1ED6D9, 0xAB5AE695, 0x5F1ED6D9,
+			0x70D00FC0, 0x45B2C70E, 0x70D00FC0, 0x45B2C70E, 0x70D00FC0, 0x45B2C70E, 0x70D00FC0, 0x45B2C70E,
+			0x2EB84DF6, 0xE73067E7, 0x2EB84DF6, 0xE73067E7, 0x2EB84DF6, 0xE73067E7, 0x2EB84DF6, 0xE73067E7,
+			0x70D00FC0, 0x45B2C70E, 0x70D00FC0, 0x45B2C70E, 0x70D00FC0, 0x45B2C70E, 0x70D00FC0, 0x45B2C70E,
+			0x2EB84DF6, 0xE73067E7, 0x2EB84DF6, 0xE73067E7, 0x2EB84DF6, 0xE73067E7, 0x2EB84DF6, 0xE73067E7,
+			0x70D00FC0, 0x45B2C70E, 0x70D00FC0, 0x45B2C70E, 0x70D00FC0, 0x45B2C70E, 0x70D00FC0, 0x45B2C70E
+		},
+		{
+			0x7C379066, 0x7C379066, 0x45E15FDE, 0x52B02E3A, 0xC86B231F, 0xC86B231F, 0x3F32E1DB, 0xD4BE5167,
+			0x7C379066, 0x7C379066, 0x45E15FDE, 0x52B02E3A, 0xC86B231F, 0xC86B231F, 0x3F32E1DB, 0xD4BE5167,
+			0xCC8272AC, 0xCC8272AC, 0x6CBEC6BF, 0xC56CCDEF, 0x080FE939, 0x080FE939, 0x61E3B85B, 0x76A4FB57,
+			0xFBBAC713, 0xFBBAC713, 0xE43A11E3, 0xC5711932, 0xEEDB75FE, 0xEEDB75FE, 0x54B385FB, 0x1EDFBE0E,
+			0xD75EDDA9, 0xD75EDDA9, 0x4C998248, 0xBF025D2B, 0x8546362A, 0x8546362A, 0xEA42417F, 0x7E4BE9DA,
+			0x7C379066, 0x7C379066, 0x45E15FDE, 0x52B02E3A, 0xC86B231F, 0xC86B231F, 0x3F32E1DB, 0xD4BE5167,
+			0x1FA916CB, 0x1FA916CB, 0x3CE40DF7, 0x26E5AEB7, 0x12E99F0F, 0x12E99F0F, 0x0004E45F, 0xAC27FD40,
+			0xFBBAC713, 0xFBBAC713, 0xE43A11E3, 0xC5711932, 0xEEDB75FE, 0xEEDB75FE, 0x54B385FB, 0x1EDFBE0E,
+			0x0B7B26D8, 0x9D044380, 0x0B7B26D8, 0x9D044380, 0x0B7B26D8, 0x9D044380, 0x0B7B26D8, 0x9D044380,
+			0x1E8D33CD, 0xF3E25DA0, 0x1E8D33CD, 0xF3E25DA0, 0x1E8D33CD, 0xF3E25DA0, 0x1E8D33CD, 0xF3E25DA0,
+			0x0B7B26D8, 0x9D044380, 0x0B7B26D8, 0x9D044380, 0x0B7B26D8, 0x9D044380, 0x0B7B26D8, 0x9D044380,
+			0x1E8D33CD, 0xF3E25DA0, 0x1E8D33CD, 0xF3E25DA0, 0x1E8D33CD, 0xF3E25DA0, 0x1E8D33CD, 0xF3E25DA0,
+			0x6F4708C5, 0x70CCC9A3, 0x6F4708C5, 0x70CCC9A3, 0x6F4708C5, 0x70CCC9A3, 0x6F4708C5, 0x70CCC9A3,
+			0x1E8D33CD, 0xF3E25DA0, 0x1E8D33CD, 0xF3E25DA0, 0x1E8D33CD, 0xF3E25DA0, 0x1E8D33CD, 0xF3E25DA0,
+			0x6F4708C5, 0x70CCC9A3, 0x6F4708C5, 0x70CCC9A3, 0x6F4708C5, 0x70CCC9A3, 0x6F4708C5, 0x70CCC9A3,
+			0x1E8D33CD, 0xF3E25DA0, 0x1E8D33CD, 0xF3E25DA0, 0x1E8D33CD, 0xF3E25DA0, 0x1E8D33CD, 0xF3E25DA0
+		}
+	},
+	{	// VT_COLOR_TV
+		{
+			0xE02E4E5F, 0xE02E4E5F, 0x66301170, 0x0253CAC6, 0xA181B026, 0xA181B026, 0x82E2DA71, 0x69239B0F,
+			0xE02E4E5F, 0xE02E4E5F, 0x66301170, 0x0253CAC6, 0xA181B026, 0xA181B026, 0x82E2DA71, 0x69239B0F,
+			0x44CC255F, 0x44CC255F, 0xD2AE0C1B, 0x1EFF5FDB, 0xE463852A, 0xE463852A, 0xB313227B, 0x120511B1,
+			0x2716D082, 0x2716D082, 0xEAA0B232, 0x9C9EF7EE, 0xE4AF3AD3, 0xE4AF3AD3, 0x52478650, 0xF544F800,
+			0xDED69355, 0xDED69355, 0x088D6BCE, 0xB760BBE9, 0x569D240B, 0x569D240B, 0x949B2AB0, 0x35F55F3F,
+			0xE02E4E5F, 0xE02E4E5F, 0x66301170, 0x0253CAC6, 0xA181B026, 0xA181B026, 0x82E2DA71, 0x69239B0F,
+			0x5393B844, 0x5393B844, 0x03139166, 0x5862A174, 0x6730164E, 0x6730164E, 0x28D4DAAC, 0x510205CC,
+			0x2716D082, 0x2716D082, 0xEAA0B232, 0x9C9EF7EE, 0xE4AF3AD3, 0xE4AF3AD3, 0x52478650, 0xF544F800,
+			0xAB5AE695, 0x5F1ED6D9, 0xAB5AE695, 0x5F1ED6D9, 0xAB5AE695, 0x5F1ED6D9, 0xAB5AE695, 0x5F1ED6D9,
+			0x70D00FC0, 0x45B2C70E, 0x70D00FC0, 0x45B2C70E, 0x70D00FC0, 0x45B2C70E, 0x70D00FC0, 0x45B2C70E,
+			0xAB5AE695, 0x5F1ED6D9, 0xAB5AE695, 0x5F1ED6D9, 0xAB5AE695, 0x5F1ED6D9, 0xAB5AE695, 0x5F1ED6D9,
+			0x70D00FC0, 0x45B2C70E, 0x70D00FC0, 0x45B2C70E, 0x70D00FC0, 0x45B2C70E, 0x70D00FC0, 0x45B2C70E,
+			0x2EB84DF6, 0xE73067E7, 0x2EB84DF6, 0xE73067E7, 0x2EB84DF6, 0xE73067E7, 0x2EB84DF6, 0xE73067E7,
+			0x70D00FC0, 0x45B2C70E, 0x70D00FC0, 0x45B2C70E, 0x70D00FC0, 0x45B2C70E, 0x70D00FC0, 0x45B2C70E,
+			0x2EB84DF6, 0xE73067E7, 0x2EB84DF6, 0xE73067E7, 0x2EB84DF6, 0xE73067E7, 0x2EB84DF6, 0xE73067E7,
+			0x70D00FC0, 0x45B2C70E, 0x70D00FC0, 0x45B2C70E, 0x70D00FC0, 0x45B2C70E, 0x70D00FC0, 0x45B2C70E
+		},
+		{
+			0x5E5E5A20, 0x5E5E5A20, 0xFB66BB82, 0x5DFF4F6E, 0xC502A792, 0xC502A792, 0xEBD315A9, 0x55128642,
+			0x5E5E5A20, 0x5E5E5A20, 0xFB66BB82, 0x5DFF4F6E, 0xC502A792, 0xC502A792, 0xEBD315A9, 0x55128642,
+			0xEF035445, 0xEF035445, 0x709912CC, 0x77591743, 0x450CA2E2, 0x450CA2E2, 0x4462729F, 0xBB930F72,
+			0x1B4EE9BE, 0x1B4EE9BE, 0x0DEB64C9, 0x7CBD7327, 0x2F65D676, 0x2F65D676, 0x49A789F9, 0x2DDD5A20,
+			0xD22A6D2B, 0xD22A6D2B, 0x0F1D6896, 0x32F47148, 0x258DFC87, 0x258DFC87, 0x1F7AF0C9, 0x524F80EB,
+			0x5E5E5A20, 0x5E5E5A20, 0xFB66BB82, 0x5DFF4F6E, 0xC502A792, 0xC502A792, 0xEBD315A9, 0x55128642,
+			0xED565873, 0xED565873, 0x182B1363, 0x2C2E89A6, 0xAC2B04DA, 0xAC2B04DA, 0x14CFA990, 0x926FC25C,
+			0x1B4EE9BE, 0x1B4EE9BE, 0x0DEB64C9, 0x7CBD7327, 0x2F65D676, 0x2F65D676, 0x49A789F9, 0x2DDD5A20,
+			0x0B7B26D8, 0x9D044380, 0x0B7B26D8, 0x9D044380, 0x0B7B26D8, 0x9D044380, 0x0B7B26D8, 0x9D044380,
+			0x1E8D33CD, 0xF3E25DA0, 0x1E8D33CD, 0xF3E25DA0, 0x1E8D33CD, 0xF3E25DA0, 0x1E8D33CD, 0xF3E25DA0,
+			0x0B7B26D8, 0x9D044380, 0x0B7B26D8, 0x9D044380, 0x0B7B26D8, 0x9D044380, 0x0B7B26D8, 0x9D044380,
+			0x1E8D33CD, 0xF3E25DA0, 0x1E8D33CD, 0xF3E25DA0, 0x1E8D33CD, 0xF3E25DA0, 0x1E8D33CD, 0xF3E25DA0,
+			0x6F4708C5, 0x70CCC9A3, 0x6F4708C5, 0x70CCC9A3, 0x6F4708C5, 0x70CCC9A3, 0x6F4708C5, 0x70CCC9A3,
+			0x1E8D33CD, 0xF3E25DA0, 0x1E8D33CD, 0xF3E25DA0, 0x1E8D33CD, 0xF3E25DA0, 0x1E8D33CD, 0xF3E25DA0,
+			0x6F4708C5, 0x70CCC9A3, 0x6F4708C5, 0x70CCC9A3, 0x6F4708C5, 0x70CCC9A3, 0x6F4708C5, 0x70CCC9A3,
+			0x1E8D33CD, 0xF3E25DA0, 0x1E8D33CD, 0xF3E25DA0, 0x1E8D33CD, 0xF3E25DA0, 0x1E8D33CD, 0xF3E25DA0
+		}
+	},
+	{	// VT_MONO_AMBER
+		{
+			0x6DC0C145, 0x6DC0C145, 0xC22A1CE5, 0xD7019605, 0x05A36B71, 0x05A36B71, 0x5D516DD5, 0xE548983D,
+			0x6DC0C145, 0x6DC0C145, 0xC22A1CE5, 0xD7019605, 0x05A36B71, 0x05A36B71, 0x5D516DD5, 0xE548983D,
+			0xC537F345, 0xC537F345, 0x423DF7D5, 0x379085E5, 0x81DCB681, 0x81DCB681, 0xF41DAA21, 0x7B1504A9,
+			0xE29737C5, 0xE29737C5, 0xA51BEC55, 0x828BCA65, 0x2BA5C901, 0x2BA5C901, 0x7EA388A1, 0x37409329,
+			0x4D031D15, 0x4D031D15, 0x2035BB55, 0x14B9FAD5, 0x35103655, 0x35103655, 0x3EBD6989, 0x67135D9D,
+			0x6DC0C145, 0x6DC0C145, 0xC22A1CE5, 0xD7019605, 0x05A36B71, 0x05A36B71, 0x5D516DD5, 0xE548983D,
+			0xA8160F81, 0xA8160F81, 0x79833701, 0xB0941821, 0xBBA5F97D, 0xBBA5F97D, 0x46F23141, 0xC19550A9,
+			0xE29737C5, 0xE29737C5, 0xA51BEC55, 0x828BCA65, 0x2BA5C901, 0x2BA5C901, 0x7EA388A1, 0x37409329,
+			0x73702DC5, 0x45068575, 0x73702DC5, 0x45068575, 0x73702DC5, 0x45068575, 0x73702DC5, 0x45068575,
+			0x866474A5, 0xD4608595, 0x866474A5, 0xD4608595, 0x866474A5, 0xD4608595, 0x866474A5, 0xD4608595,
+			0x73702DC5, 0x45068575, 0x73702DC5, 0x45068575, 0x73702DC5, 0x45068575, 0x73702DC5, 0x45068575,
+			0x866474A5, 0xD4608595, 0x866474A5, 0xD4608595, 0x866474A5, 0xD4608595, 0x866474A5, 0xD4608595,
+			0xA8EFA1D9, 0x7EA9EB05, 0xA8EFA1D9, 0x7EA9EB05, 0xA8EFA1D9, 0x7EA9EB05, 0xA8EFA1D9, 0x7EA9EB05,
+			0x866474A5, 0xD4608595, 0x866474A5, 0xD4608595, 0x866474A5, 0xD4608595, 0x866474A5, 0xD4608595,
+			0xA8EFA1D9, 0x7EA9EB05, 0xA8EFA1D9, 0x7EA9EB05, 0xA8EFA1D9, 0x7EA9EB05, 0xA8EFA1D9, 0x7EA9EB05,
+			0x866474A5, 0xD4608595, 0x866474A5, 0xD4608595, 0x866474A5, 0xD4608595, 0x866474A5, 0xD4608595
+		},
+		{
+			0x730B2145, 0x730B2145, 0x004D0C65, 0x12949E85, 0x5E0554B8, 0x5E0554B8, 0xE27AADD5, 0x56940F4D,
+			0x730B2145, 0x730B2145, 0x004D0C65, 0x12949E85, 0x5E0554B8, 0x5E0554B8, 0xE27AADD5, 0x56940F4D,
+			0x31635135, 0x31635135, 0xC2A091C5, 0xD9061715, 0xCB655678, 0xCB655678, 0x2B4E6D38, 0x9A88CB60,
+			0x745DDDD5, 0x745DDDD5, 0x4D16F765, 0x2AED5835, 0x95C02058, 0x95C02058, 0x57316E98, 0x2F207B40,
+			0x24AFBAD5, 0x24AFBAD5, 0xE2E06155, 0xCE319FD5, 0x17E52195, 0x17E52195, 0x5325D4B0, 0xCC1B220D,
+			0x730B2145, 0x730B2145, 0x004D0C65, 0x12949E85, 0x5E0554B8, 0x5E0554B8, 0xE27AADD5, 0x56940F4D,
+			0x9056C668, 0x9056C668, 0xD94CF628, 0x2046B3C8, 0x1BFDE39D, 0x1BFDE39D, 0x057D4088, 0x508C3830,
+			0x745DDDD5, 0x745DDDD5, 0x4D16F765, 0x2AED5835, 0x95C02058, 0x95C02058, 0x57316E98, 0x2F207B40,
+			0xCD875495, 0xC13C20C5, 0xCD875495, 0xC13C20C5, 0xCD875495, 0xC13C20C5, 0xCD875495, 0xC13C20C5,
+			0x76CA5035, 0xCF61E985, 0x76CA5035, 0xCF61E985, 0x76CA5035, 0xCF61E985, 0x76CA5035, 0xCF61E985,
+			0xCD875495, 0xC13C20C5, 0xCD875495, 0xC13C20C5, 0xCD875495, 0xC13C20C5, 0xCD875495, 0xC13C20C5,
+			0x76CA5035, 0xCF61E985, 0x76CA5035, 0xCF61E985, 0x76CA5035, 0xCF61E985, 0x76CA5035, 0xCF61E985,
+			0xF7CF1310, 0x1EA51DC5, 0xF7CF1310, 0x1EA51DC5, 0xF7CF1310, 0x1EA51DC5, 0xF7CF1310, 0x1EA51DC5,
+			0x76CA5035, 0xCF61E985, 0x76CA5035, 0xCF61E985, 0x76CA5035, 0xCF61E985, 0x76CA5035, 0xCF61E985,
+			0xF7CF1310, 0x1EA51DC5, 0xF7CF1310, 0x1EA51DC5, 0xF7CF1310, 0x1EA51DC5, 0xF7CF1310, 0x1EA51DC5,
+			0x76CA5035, 0xCF61E985, 0x76CA5035, 0xCF61E985, 0x76CA5035, 0xCF61E985, 0x76CA5035, 0xCF61E985
+		}
+	},
+	{	// VT_MONO_GREEN
+		{
+			0x422B73C5, 0x422B73C5, 0x735F4DC5, 0xB718B5C5, 0xFA6BA005, 0xFA6BA005, 0x62102545, 0x5E5101C5,
+			0x422B73C5, 0x422B73C5, 0x735F4DC5, 0xB718B5C5, 0xFA6BA005, 0xFA6BA005, 0x62102545, 0x5E5101C5,
+			0x95E1BDC5, 0x95E1BDC5, 0x3893B0C5, 0x9642CDC5, 0xA9549285, 0xA9549285, 0xA5044605, 0xE5324B85,
+			0xF83872C5, 0xF83872C5, 0x9AEA65C5, 0xF89982C5, 0x0BAB4785, 0x0BAB4785, 0x075AFB05, 0x47890085,
+			0xE74B48C5, 0xE74B48C5, 0x7A01D0C5, 0x155C9AC5, 0x84A39A45, 0x84A39A45, 0xA3AB5A05, 0xACE1F645,
+			0x422B73C5, 0x422B73C5, 0x735F4DC5, 0xB718B5C5, 0xFA6BA005, 0xFA6BA005, 0x62102545, 0x5E5101C5,
+			0x956C7E05, 0x956C7E05, 0x9003E005, 0x03587205, 0x4D9385C5, 0x4D9385C5, 0x53E84B05, 0xDFF23085,
+			0xF83872C5, 0xF83872C5, 0x9AEA65C5, 0xF89982C5, 0x0BAB4785, 0x0BAB4785, 0x075AFB05, 0x47890085,
+			0x57F82F45, 0x7143A045, 0x57F82F45, 0x7143A045, 0x57F82F45, 0x7143A045, 0x57F82F45, 0x7143A045,
+			0xA72128C5, 0x5947E245, 0xA72128C5, 0x5947E245, 0xA72128C5, 0x5947E245, 0xA72128C5, 0x5947E245,
+			0x57F82F45, 0x7143A045, 0x57F82F45, 0x7143A045, 0x57F82F45, 0x7143A045, 0x57F82F45, 0x7143A045,
+			0xA72128C5, 0x5947E245, 0xA72128C5, 0x5947E245, 0xA72128C5, 0x5947E245, 0xA72128C5, 0x5947E245,
+			0xAC534485, 0x0F28FF45, 0xAC534485, 0x0F28FF45, 0xAC534485, 0x0F28FF45, 0xAC534485, 0x0F28FF45,
+			0xA72128C5, 0x5947E245, 0xA72128C5, 0x5947E245, 0xA72128C5, 0x5947E245, 0xA72128C5, 0x5947E245,
+			0xAC534485, 0x0F28FF45, 0xAC534485, 0x0F28FF45, 0xAC534485, 0x0F28FF45, 0xAC534485, 0x0F28FF45,
+			0xA72128C5, 0x5947E245, 0xA72128C5, 0x5947E245, 0xA72128C5, 0x5947E245, 0xA72128C5, 0x5947E245
+		},
+		{
+			0x71443345, 0x71443345, 0x2FB361C5, 0xC17C42C5, 0x40571475, 0x40571475, 0x6D712B45, 0x6EE122A5,
+			0x71443345, 0x71443345, 0x2FB361C5, 0xC17C42C5, 0x40571475, 0x40571475, 0x6D712B45, 0x6EE122A5,
+			0x7C7711C5, 0x7C7711C5, 0x85B6A0C5, 0xAC823F45, 0xFB669B55, 0xFB669B55, 0xA71266D5, 0xDAE0E935,
+			0x79AE1C45, 0x79AE1C45, 0x5415C945, 0x2F75EBC5, 0x14CFBCD5, 0x14CFBCD5, 0x80D49A55, 0xC37450B5,
+			0x2AF521C5, 0x2AF521C5, 0xA231B0C5, 0xC43A0E45, 0x1040F1A5, 0x1040F1A5, 0x001C16D5, 0xA4315E65,
+			0x71443345, 0x71443345, 0x2FB361C5, 0xC17C42C5, 0x40571475, 0x40571475, 0x6D712B45, 0x6EE122A5,
+			0x446AAF55, 0x446AAF55, 0x28F4DB55, 0xB3ABCAD5, 0xB1CCBA65, 0xB1CCBA65, 0x9BD93BD5, 0x413DF2F5,
+			0x79AE1C45, 0x79AE1C45, 0x5415C945, 0x2F75EBC5, 0x14CFBCD5, 0x14CFBCD5, 0x80D49A55, 0xC37450B5,
+			0xE44C0FC5, 0x1279D3E5, 0xE44C0FC5, 0x1279D3E5, 0xE44C0FC5, 0x1279D3E5, 0xE44C0FC5, 0x1279D3E5,
+			0xB1CE54C5, 0x2C374325, 0xB1CE54C5, 0x2C374325, 0xB1CE54C5, 0x2C374325, 0xB1CE54C5, 0x2C374325,
+			0xE44C0FC5, 0x1279D3E5, 0xE44C0FC5, 0x1279D3E5, 0xE44C0FC5, 0x1279D3E5, 0xE44C0FC5, 0x1279D3E5,
+			0xB1CE54C5, 0x2C374325, 0xB1CE54C5, 0x2C374325, 0xB1CE54C5, 0x2C374325, 0xB1CE54C5, 0x2C374325,
+			0xF9F78F55, 0xCD4CB4E5, 0xF9F78F55, 0xCD4CB4E5, 0xF9F78F55, 0xCD4CB4E5, 0xF9F78F55, 0xCD4CB4E5,
+			0xB1CE54C5, 0x2C374325, 0xB1CE54C5, 0x2C374325, 0xB1CE54C5, 0x2C374325, 0xB1CE54C5, 0x2C374325,
+			0xF9F78F55, 0xCD4CB4E5, 0xF9F78F55, 0xCD4CB4E5, 0xF9F78F55, 0xCD4CB4E5, 0xF9F78F55, 0xCD4CB4E5,
+			0xB1CE54C5, 0x2C374325, 0xB1CE54C5, 0x2C374325, 0xB1CE54C5, 0x2C374325, 0xB1CE54C5, 0x2C374325
+		}
+	},
+	{	// VT_MONO_WHITE
+		{
+			0xD084D985, 0xD084D985, 0x342AA1C5, 0x95C59E45, 0x97375405, 0x97375405, 0xABF3D015, 0xBE3B1585,
+			0xD084D985, 0xD084D985, 0x342AA1C5, 0x95C59E45, 0x97375405, 0x97375405, 0xABF3D015, 0xBE3B1585,
+			0x6BFF9515, 0x6BFF9515, 0x7E70C395, 0x5EBE1115, 0x27B41C05, 0x27B41C05, 0xCA8BBA25, 0x6BABF3B5,
+			0x256B3C15, 0x256B3C15, 0x37DC6A95, 0x1829B815, 0xE11FC305, 0xE11FC305, 0x83F76125, 0x25179AB5,
+			0x8C9A5345, 0x8C9A5345, 0xA8F07D85, 0xCD7BB105, 0x4EB04BA5, 0x4EB04BA5, 0x74B19AE5, 0x51C5E7A5,
+			0xD084D985, 0xD084D985, 0x342AA1C5, 0x95C59E45, 0x97375405, 0x97375405, 0xABF3D015, 0xBE3B1585,
+			0x2348D015, 0x2348D015, 0x6F4E3F55, 0x6F0700D5, 0x9BF44435, 0x9BF44435, 0x2DFCFBF5, 0x3F5B4655,
+			0x256B3C15, 0x256B3C15, 0x37DC6A95, 0x1829B815, 0xE11FC305, 0xE11FC305, 0x83F76125, 0x25179AB5,
+			0xB89243C5, 0xAD221365, 0xB89243C5, 0xAD221365, 0xB89243C5, 0xAD221365, 0xB89243C5, 0xAD221365,
+			0xE103DB55, 0x7DC68BE5, 0xE103DB55, 0x7DC68BE5, 0xE103DB55, 0x7DC68BE5, 0xE103DB55, 0x7DC68BE5,
+			0xB89243C5, 0xAD221365, 0xB89243C5, 0xAD221365, 0xB89243C5, 0xAD221365, 0xB89243C5, 0xAD221365,
+			0xE103DB55, 0x7DC68BE5, 0xE103DB55, 0x7DC68BE5, 0xE103DB55, 0x7DC68BE5, 0xE103DB55, 0x7DC68BE5,
+			0x470A5E25, 0x18D76B75, 0x470A5E25, 0x18D76B75, 0x470A5E25, 0x18D76B75, 0x470A5E25, 0x18D76B75,
+			0xE103DB55, 0x7DC68BE5, 0xE103DB55, 0x7DC68BE5, 0xE103DB55, 0x7DC68BE5, 0xE103DB55, 0x7DC68BE5,
+			0x470A5E25, 0x18D76B75, 0x470A5E25, 0x18D76B75, 0x470A5E25, 0x18D76B75, 0x470A5E25, 0x18D76B75,
+			0xE103DB55, 0x7DC68BE5, 0xE103DB55, 0x7DC68BE5, 0xE103DB55, 0x7DC68BE5, 0xE103DB55, 0x7DC68BE5
+		},
+		{
+			0xC4A772C5, 0xC4A772C5, 0x95BCC4C5, 0x8791A5C5, 0x308C0946, 0x308C0946, 0x515D1355, 0x6417CAF5,
+			0xC4A772C5, 0xC4A772C5, 0x95BCC4C5, 0x8791A5C5, 0x308C0946, 0x308C0946, 0x515D1355, 0x6417CAF5,
+			0xAB4A7CA5, 0xAB4A7CA5, 0x63494EA5, 0x7501D625, 0xB1014A16, 0xB1014A16, 0x0A867956, 0x4ED118C6,
+			0x1D0D2D45, 0x1D0D2D45, 0x2AA08545, 0xD74135C5, 0xBBDE9DB6, 0xBBDE9DB6, 0x64F67EF6, 0xFCD5BCE6,
+			0x4FCE2BC5, 0x4FCE2BC5, 0xF0FAC045, 0xDA8EBBC5, 0xBC3D7FA5, 0xBC3D7FA5, 0x20E662C6, 0x13C7FBB5,
+			0xC4A772C5, 0xC4A772C5, 0x95BCC4C5, 0x8791A5C5, 0x308C0946, 0x308C0946, 0x515D1355, 0x6417CAF5,
+			0x64EECFF6, 0x64EECFF6, 0xFC78BFF6, 0x66078E76, 0x9C627A55, 0x9C627A55, 0xB28287F6, 0x53717FD6,
+			0x1D0D2D45, 0x1D0D2D45, 0x2AA08545, 0xD74135C5, 0xBBDE9DB6, 0xBBDE9DB6, 0x64F67EF6, 0xFCD5BCE6,
+			0xB481C7B5, 0xF9275295, 0xB481C7B5, 0xF9275295, 0xB481C7B5, 0xF9275295, 0xB481C7B5, 0xF9275295,
+			0xB2978D45, 0x258C9635, 0xB2978D45, 0x258C9635, 0xB2978D45, 0x258C9635, 0xB2978D45, 0x258C9635,
+			0xB481C7B5, 0xF9275295, 0xB481C7B5, 0xF9275295, 0xB481C7B5, 0xF9275295, 0xB481C7B5, 0xF9275295,
+			0xB2978D45, 0x258C9635, 0xB2978D45, 0x258C9635, 0xB2978D45, 0x258C9635, 0xB2978D45, 0x258C9635,
+			0x5041A3F6, 0xCDD59EF5, 0x5041A3F6, 0xCDD59EF5, 0x5041A3F6, 0xCDD59EF5, 0x5041A3F6, 0xCDD59EF5,
+			0xB2978D45, 0x258C9635, 0xB2978D45, 0x258C9635, 0xB2978D45, 0x258C9635, 0xB2978D45, 0x258C9635,
+			0x5041A3F6, 0xCDD59EF5, 0x5041A3F6, 0xCDD59EF5, 0x5041A3F6, 0xCDD59EF5, 0x5041A3F6, 0xCDD59EF5,
+			0xB2978D45, 0x258C9635, 0xB2978D45, 0x258C9635, 0xB2978D45, 0x258C9635, 0xB2978D45, 0x258C9635
+		}
+	}
+};
@@ -9,6 +9,22 @@
 .\%1\TestDebugger.exe
 @if errorlevel 1 GOTO failed
 
+@ECHO Performing unit-test: TestNTSC
+.\%1\TestNTSC.exe
+@if errorlevel 1 GOTO failed
+
+@ECHO Performing unit-test: TestMBMixer
+.\%1\TestMBMixer.exe
+@if errorlevel 1 GOTO failed
+
+@ECHO Performing unit-test: TestAY8910
+.\%1\TestAY8910.exe
+@if errorlevel 1 GOTO failed
+
+@ECHO Performing unit-test: TestLiron
+.\%1\TestLiron.exe
+@if errorlevel 1 GOTO failed
+
 @GOTO end
 
 :failed